@@ -0,0 +1,124 @@
+/*
+	Benchmark of the schedule store against a linear scan of the events,
+	and the memory it uses per event. "wakeup" is the work the scheduler()
+	timer of main.c does on the store each time it runs, which /debug/bench
+	also times on the device (and in water_sim) as schedule_wakeup.
+
+	./build-host/schedule_bench [events]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "schedule.h"
+
+#define ROUNDS 20000
+
+static schedule_store store;
+static water_event events[SCHEDULE_MAX_EVENTS];
+
+static double elapsed_ns(const struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+static void random_event(water_event *event)
+{
+	event->enabled = true;
+	event->hour = rand() % 24;
+	event->minute = rand() % 60;
+	event->skip = 0;
+	event->days = rand() % 0x80;
+	event->duration = 1 + rand() % 600;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int count = argc > 1 ? atoi(argv[1]) : SCHEDULE_MAX_EVENTS;
+	struct timespec start;
+	time_t now = 1700000000;
+	time_t linear_time = now, heap_time, wakeup_time;
+	unsigned int wakeups = 0, fired = 0;
+	unsigned long seconds = 0;
+	double ns;
+
+	if (count == 0 || count > SCHEDULE_MAX_EVENTS)
+	{
+		fprintf(stderr, "events must be 1..%u\n", SCHEDULE_MAX_EVENTS);
+		return 1;
+	}
+
+	setenv("TZ", "PST8PDT", 1);
+	tzset();
+	srand(1);
+	for (unsigned int i = 0; i < count; i++)
+		random_event(&events[i]);
+
+	printf("schedule store: %u events max, %zu bytes\n", SCHEDULE_MAX_EVENTS, sizeof(store));
+	printf("per event: %zu bytes (water_event %zu, time_t %zu, 3 indexes %zu)\n",
+		sizeof(store) / SCHEDULE_MAX_EVENTS, sizeof(water_event), sizeof(time_t), 3 * sizeof(uint16_t));
+	printf("blob: %u bytes for %u events\n\n", SCHEDULE_BLOB_SIZE(count), count);
+
+	schedule_init(&store);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (unsigned int i = 0; i < count; i++)
+		schedule_add(&store, &events[i], now);
+	printf("add:             %8.0f ns/event\n", elapsed_ns(&start) / count);
+
+	// the next ROUNDS events to fire, found both ways
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (unsigned int i = 0; i < ROUNDS; i++)
+		linear_time = schedule_next(events, count, linear_time);
+	ns = elapsed_ns(&start) / ROUNDS;
+	printf("next (linear):   %8.0f ns/event\n", ns);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (unsigned int i = 0; i < ROUNDS; i++)
+	{
+		heap_time = schedule_peek(&store, NULL);
+		schedule_fired(&store);
+	}
+	ns = elapsed_ns(&start) / ROUNDS;
+	printf("next (heap):     %8.0f ns/event\n", ns);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	schedule_rebuild(&store, now);
+	printf("rebuild:         %8.0f ns/event\n", elapsed_ns(&start) / count);
+
+	// a week of scheduler() runs, each starting the events that are due
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (wakeup_time = now; wakeup_time < now + 7 * 24 * 3600; wakeups++)
+	{
+		time_t due = schedule_peek(&store, NULL);
+		unsigned int slot;
+
+		if (due == SCHEDULE_NEVER)
+			break;
+		wakeup_time = due;
+		while ((due = schedule_peek(&store, &slot)) != SCHEDULE_NEVER && due <= wakeup_time)
+		{
+			seconds += schedule_get(&store, slot)->duration;
+			schedule_fired(&store);
+			fired++;
+		}
+	}
+	printf("wakeup:          %8.0f ns (%u runs start %u events, %lu s of watering)\n",
+		elapsed_ns(&start) / (wakeups ? wakeups : 1), wakeups, fired, seconds);
+	schedule_rebuild(&store, now);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (unsigned int i = 0; i < count; i++)
+		schedule_del(&store, i);
+	printf("delete:          %8.0f ns/event\n", elapsed_ns(&start) / count);
+
+	// events that fire at the same time are found once by the linear scan
+	// but once per event by the heap, so only the order of magnitude matches
+	if (heap_time > linear_time)
+	{
+		fprintf(stderr, "heap reached %ld, linear scan %ld\n", (long)heap_time, (long)linear_time);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,168 @@
+/*
+	Benchmark of url_decode() against the byte at a time decoder it
+	replaced, which it is also checked against on random strings full of
+	broken escapes, at every alignment, in place and into short buffers.
+
+	./build-host/url_decode_bench [strings]
+*/
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "query.h"
+
+#define ROUNDS 200000
+#define MAX_LEN 200
+
+static const char *const inputs[] =
+{
+	"Back+Garden",
+	"14%3A30",
+	"http%3A%2F%2F192.168.20.30%2Fwater.bin",
+	"My%20Home%20Network%20%F0%9F%8C%B1",
+	"http://firmware.example.com/controllers/garden/water-1.13.bin",
+	"%25%2B%26%3D%3F%2F%3A%40%23%5B%5D%21%24%27%28%29%2A%2C%3B",
+};
+
+static double elapsed_ns(const struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+// what query.c used before, for comparison
+static void urldecode2(char *dst, const char *src)
+{
+	char a, b;
+	while (*src)
+	{
+		if ((*src == '%') &&
+			((a = src[1]) && (b = src[2])) &&
+			(isxdigit(a) && isxdigit(b)))
+		{
+			if (a >= 'a')
+				a -= 'a'-'A';
+			if (a >= 'A')
+				a -= ('A' - 10);
+			else
+				a -= '0';
+			if (b >= 'a')
+				b -= 'a'-'A';
+			if (b >= 'A')
+				b -= ('A' - 10);
+			else
+				b -= '0';
+			*dst++ = 16*a+b;
+			src+=3;
+		}
+		else if (*src == '+')
+		{
+			*dst++ = ' ';
+			src++;
+		}
+		else
+		{
+			*dst++ = *src++;
+		}
+	}
+	*dst++ = '\0';
+}
+
+static void random_string(char *s, size_t len)
+{
+	static const char chars[] = "%%%++09afAFgG=&x ";
+
+	for (size_t i = 0; i < len; i++)
+		s[i] = chars[rand() % (sizeof(chars) - 1)];
+	s[len] = '\0';
+}
+
+static int check(const char *src, size_t len, unsigned int align)
+{
+	char expect[MAX_LEN + 1];
+	char buf[MAX_LEN + 8];
+	char out[MAX_LEN + 1];
+	int n;
+
+	urldecode2(expect, src);
+
+	// into another buffer
+	n = url_decode(out, sizeof(out), src, len);
+	if (n < 0 || memcmp(out, expect, n + 1) != 0)
+		goto fail;
+
+	// in place, at every alignment
+	memcpy(buf + align, src, len);
+	if (url_decode(buf + align, len + 1, buf + align, len) != n || memcmp(buf + align, expect, n + 1) != 0)
+		goto fail;
+
+	// too short by one, which keeps what fits
+	if (n > 0 && (url_decode(out, n, src, len) != -1 || memcmp(out, expect, n - 1) != 0 || out[n - 1]))
+		goto fail;
+	return 0;
+
+fail:
+	fprintf(stderr, "\"%s\" decoded differently at alignment %u\n", src, align);
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int count = argc > 1 ? atoi(argv[1]) : 100000;
+	struct timespec start;
+	char buf[MAX_LEN + 1];
+	size_t total = 0;
+	double ns;
+
+	srand(1);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		size_t len = rand() % MAX_LEN;
+
+		random_string(buf, len);
+		if (check(buf, len, i % 4))
+			return 1;
+	}
+	printf("%u random strings decoded the same both ways\n\n", count);
+
+	for (unsigned int i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++)
+		total += strlen(inputs[i]);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (unsigned int round = 0; round < ROUNDS; round++)
+	{
+		for (unsigned int i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++)
+			urldecode2(buf, inputs[i]);
+	}
+	ns = elapsed_ns(&start);
+	printf("urldecode2: %6.2f ns/byte\n", ns / ROUNDS / total);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (unsigned int round = 0; round < ROUNDS; round++)
+	{
+		for (unsigned int i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++)
+			url_decode(buf, sizeof(buf), inputs[i], strlen(inputs[i]));
+	}
+	ns = elapsed_ns(&start);
+	printf("url_decode: %6.2f ns/byte\n", ns / ROUNDS / total);
+
+	printf("\n%-40s %10s %10s\n", "", "urldecode2", "url_decode");
+	for (unsigned int i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++)
+	{
+		size_t len = strlen(inputs[i]);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (unsigned int round = 0; round < ROUNDS; round++)
+			urldecode2(buf, inputs[i]);
+		printf("%-40.40s %7.1f ns", inputs[i], elapsed_ns(&start) / ROUNDS);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (unsigned int round = 0; round < ROUNDS; round++)
+			url_decode(buf, sizeof(buf), inputs[i], len);
+		printf(" %7.1f ns\n", elapsed_ns(&start) / ROUNDS);
+	}
+	return 0;
+}
@@ -0,0 +1,44 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_DRIVER_GPIO_H
+#define _SIM_DRIVER_GPIO_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum
+{
+	GPIO_NUM_0 = 0,
+	GPIO_NUM_1,
+	GPIO_NUM_2,
+	GPIO_NUM_3,
+	GPIO_NUM_4,
+	GPIO_NUM_5,
+	GPIO_NUM_6,
+	GPIO_NUM_7,
+	GPIO_NUM_8,
+	GPIO_NUM_9,
+	GPIO_NUM_10,
+	GPIO_NUM_11,
+	GPIO_NUM_12,
+	GPIO_NUM_13,
+	GPIO_NUM_14,
+	GPIO_NUM_15,
+	GPIO_NUM_16,
+	GPIO_NUM_MAX
+} gpio_num_t;
+
+typedef enum
+{
+	GPIO_MODE_DISABLE = 0,
+	GPIO_MODE_INPUT,
+	GPIO_MODE_OUTPUT,
+	GPIO_MODE_OUTPUT_OD,
+} gpio_mode_t;
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode);
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
+int gpio_get_level(gpio_num_t gpio_num);
+
+#endif
@@ -0,0 +1,24 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+
+	CCOUNT counts CPU cycles. On the host it is the monotonic clock in
+	cycles of a CONFIG_ESP8266_DEFAULT_CPU_FREQ_MHZ CPU, so the counts
+	are comparable in size but measure host time.
+*/
+#ifndef _SIM_DRIVER_SOC_H
+#define _SIM_DRIVER_SOC_H
+
+#include <stdint.h>
+#include <time.h>
+#include "sdkconfig.h"
+
+static inline uint32_t soc_get_ccount(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * CONFIG_ESP8266_DEFAULT_CPU_FREQ_MHZ * 1000000
+		+ (uint64_t)ts.tv_nsec * CONFIG_ESP8266_DEFAULT_CPU_FREQ_MHZ / 1000;
+}
+
+#endif
@@ -0,0 +1,28 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+
+	Writes to the output registers are applied by the simulator after each
+	timer callback, URI handler and event handler returns.
+*/
+#ifndef _SIM_ESP8266_GPIO_STRUCT_H
+#define _SIM_ESP8266_GPIO_STRUCT_H
+
+#include <stdint.h>
+
+typedef volatile struct gpio_dev_s
+{
+	uint32_t out;
+	uint32_t out_w1ts;
+	uint32_t out_w1tc;
+	uint32_t enable;
+	uint32_t enable_w1ts;
+	uint32_t enable_w1tc;
+	uint32_t in;
+	uint32_t status;
+	uint32_t status_w1ts;
+	uint32_t status_w1tc;
+} gpio_dev_t;
+
+extern volatile gpio_dev_t GPIO;
+
+#endif
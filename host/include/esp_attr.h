@@ -0,0 +1,10 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_ESP_ATTR_H
+#define _SIM_ESP_ATTR_H
+
+// there is no IRAM on the host
+#define IRAM_ATTR
+
+#endif
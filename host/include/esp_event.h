@@ -0,0 +1,22 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_ESP_EVENT_H
+#define _SIM_ESP_EVENT_H
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_event_base.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_netif.h"
+#include "esp_wifi_types.h"
+
+esp_err_t esp_event_loop_create_default(void);
+esp_err_t esp_event_handler_register(esp_event_base_t event_base, int32_t event_id,
+	esp_event_handler_t event_handler, void *event_handler_arg);
+esp_err_t esp_event_handler_unregister(esp_event_base_t event_base, int32_t event_id,
+	esp_event_handler_t event_handler);
+esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id,
+	void *event_data, size_t event_data_size, TickType_t ticks_to_wait);
+
+#endif
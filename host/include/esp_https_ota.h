@@ -0,0 +1,11 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_ESP_HTTPS_OTA_H
+#define _SIM_ESP_HTTPS_OTA_H
+
+#include "esp_http_client.h"
+
+esp_err_t esp_https_ota(const esp_http_client_config_t *config);
+
+#endif
@@ -0,0 +1,19 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_ESP_LOG_H
+#define _SIM_ESP_LOG_H
+
+#include <stdint.h>
+
+uint32_t esp_log_timestamp(void);
+void esp_log_write(char level, const char *tag, const char *format, ...)
+	__attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, format, ...) esp_log_write('E', tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) esp_log_write('W', tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) esp_log_write('I', tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) do { } while (0)
+#define ESP_LOGV(tag, format, ...) do { } while (0)
+
+#endif
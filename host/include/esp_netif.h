@@ -0,0 +1,42 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_ESP_NETIF_H
+#define _SIM_ESP_NETIF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_event_base.h"
+
+typedef struct
+{
+	uint32_t addr;
+} ip4_addr_t;
+
+typedef struct
+{
+	ip4_addr_t ip;
+	ip4_addr_t netmask;
+	ip4_addr_t gw;
+} tcpip_adapter_ip_info_t;
+
+typedef enum
+{
+	IP_EVENT_STA_GOT_IP,
+	IP_EVENT_STA_LOST_IP,
+	IP_EVENT_AP_STAIPASSIGNED,
+} ip_event_t;
+
+typedef struct
+{
+	int if_index;
+	tcpip_adapter_ip_info_t ip_info;
+	bool ip_changed;
+} ip_event_got_ip_t;
+
+ESP_EVENT_DECLARE_BASE(IP_EVENT);
+
+void tcpip_adapter_init(void);
+char *ip4addr_ntoa(const ip4_addr_t *addr);
+
+#endif
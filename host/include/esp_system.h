@@ -0,0 +1,26 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_ESP_SYSTEM_H
+#define _SIM_ESP_SYSTEM_H
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "esp_err.h"
+
+void esp_restart(void) __attribute__((noreturn));
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
+uint32_t esp_random(void);
+
+esp_err_t esp_base_mac_addr_get(uint8_t *mac);
+esp_err_t esp_base_mac_addr_set(uint8_t *mac);
+esp_err_t esp_efuse_mac_get_default(uint8_t *mac);
+
+#endif
@@ -0,0 +1,29 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_ESP_WIFI_H
+#define _SIM_ESP_WIFI_H
+
+#include "esp_err.h"
+#include "esp_wifi_types.h"
+#include "esp_event.h"
+
+typedef struct
+{
+	int unused;
+} wifi_init_config_t;
+
+#define WIFI_INIT_CONFIG_DEFAULT() { 0 }
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config);
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode);
+esp_err_t esp_wifi_start(void);
+esp_err_t esp_wifi_stop(void);
+esp_err_t esp_wifi_connect(void);
+esp_err_t esp_wifi_disconnect(void);
+esp_err_t esp_wifi_get_config(esp_interface_t interface, wifi_config_t *conf);
+esp_err_t esp_wifi_set_config(esp_interface_t interface, wifi_config_t *conf);
+esp_err_t esp_wifi_set_protocol(esp_interface_t ifx, uint8_t protocol_bitmap);
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info);
+
+#endif
@@ -0,0 +1,93 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_ESP_WIFI_TYPES_H
+#define _SIM_ESP_WIFI_TYPES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_event_base.h"
+
+typedef enum
+{
+	WIFI_MODE_NULL = 0,
+	WIFI_MODE_STA,
+	WIFI_MODE_AP,
+	WIFI_MODE_APSTA,
+} wifi_mode_t;
+
+typedef enum
+{
+	ESP_IF_WIFI_STA = 0,
+	ESP_IF_WIFI_AP,
+} esp_interface_t;
+
+#define WIFI_PROTOCOL_11B 1
+#define WIFI_PROTOCOL_11G 2
+#define WIFI_PROTOCOL_11N 4
+
+typedef enum
+{
+	WIFI_REASON_UNSPECIFIED = 1,
+	WIFI_REASON_AUTH_EXPIRE = 2,
+	WIFI_REASON_BEACON_TIMEOUT = 200,
+	WIFI_REASON_NO_AP_FOUND = 201,
+	WIFI_REASON_AUTH_FAIL = 202,
+	WIFI_REASON_ASSOC_FAIL = 203,
+	WIFI_REASON_HANDSHAKE_TIMEOUT = 204,
+	WIFI_REASON_BASIC_RATE_NOT_SUPPORT = 205,
+} wifi_err_reason_t;
+
+typedef struct
+{
+	uint8_t ssid[32];
+	uint8_t password[64];
+	bool bssid_set;
+	uint8_t bssid[6];
+	uint8_t channel;
+} wifi_sta_config_t;
+
+typedef union
+{
+	wifi_sta_config_t sta;
+} wifi_config_t;
+
+typedef struct
+{
+	uint8_t bssid[6];
+	uint8_t ssid[33];
+	uint8_t primary;
+	int8_t rssi;
+} wifi_ap_record_t;
+
+typedef enum
+{
+	WIFI_EVENT_WIFI_READY = 0,
+	WIFI_EVENT_SCAN_DONE,
+	WIFI_EVENT_STA_START,
+	WIFI_EVENT_STA_STOP,
+	WIFI_EVENT_STA_CONNECTED,
+	WIFI_EVENT_STA_DISCONNECTED,
+	WIFI_EVENT_STA_AUTHMODE_CHANGE,
+	WIFI_EVENT_STA_WPS_ER_SUCCESS,
+	WIFI_EVENT_STA_WPS_ER_FAILED,
+	WIFI_EVENT_STA_WPS_ER_TIMEOUT,
+	WIFI_EVENT_STA_WPS_ER_PIN,
+} wifi_event_t;
+
+typedef struct
+{
+	uint8_t pin_code[8];
+} wifi_event_sta_wps_er_pin_t;
+
+typedef struct
+{
+	uint8_t ssid[32];
+	uint8_t ssid_len;
+	uint8_t bssid[6];
+	uint8_t reason;
+} system_event_sta_disconnected_t;
+
+ESP_EVENT_DECLARE_BASE(WIFI_EVENT);
+
+#endif
@@ -0,0 +1,12 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_FREERTOS_EVENT_GROUPS_H
+#define _SIM_FREERTOS_EVENT_GROUPS_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_event_group *EventGroupHandle_t;
+typedef TickType_t EventBits_t;
+
+#endif
@@ -0,0 +1,19 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_FREERTOS_SEMPHR_H
+#define _SIM_FREERTOS_SEMPHR_H
+
+#include "freertos/queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+#define xSemaphoreCreateBinary() xQueueCreate(1, 0)
+#define xSemaphoreCreateMutex() sim_semaphore_create_mutex()
+#define xSemaphoreTake(sem, ticks) xQueueReceive(sem, NULL, ticks)
+#define xSemaphoreGive(sem) xQueueSend(sem, NULL, 0)
+#define vSemaphoreDelete(sem) vQueueDelete(sem)
+
+QueueHandle_t sim_semaphore_create_mutex(void);
+
+#endif
@@ -0,0 +1,19 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+*/
+#ifndef _SIM_LWIP_APPS_SNTP_H
+#define _SIM_LWIP_APPS_SNTP_H
+
+#include <stdint.h>
+#include <sys/time.h>
+
+#define SNTP_OPMODE_POLL 0
+#define SNTP_OPMODE_LISTENONLY 1
+
+void sntp_setoperatingmode(uint8_t operating_mode);
+void sntp_setservername(uint8_t idx, const char *server);
+void sntp_init(void);
+void sntp_stop(void);
+uint8_t sntp_getreachability(uint8_t idx);
+
+#endif
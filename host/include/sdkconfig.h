@@ -0,0 +1,17 @@
+/*
+	Host stand-in for the ESP8266 RTOS SDK - see host/CMakeLists.txt
+
+	The values the firmware uses from the project's sdkconfig
+*/
+#ifndef _SIM_SDKCONFIG_H
+#define _SIM_SDKCONFIG_H
+
+#define CONFIG_IDF_TARGET_ESP8266 1
+#define CONFIG_ESP8266_DEFAULT_CPU_FREQ_MHZ 160
+#define CONFIG_FREERTOS_HZ 100
+#define CONFIG_WATER_OTA_BUF_SIZE 2048
+#define CONFIG_WATER_MAX_EVENTS 200
+#define CONFIG_WATER_COMMIT_DELAY 2000
+#define CONFIG_WATER_UPDATE_CHECK 12
+
+#endif
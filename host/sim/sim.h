@@ -0,0 +1,18 @@
+/*
+	Internal interfaces shared by the parts of the simulator
+*/
+#ifndef _SIM_H
+#define _SIM_H
+
+#include <stdint.h>
+
+// directory that holds the simulated flash (NVS, partitions)
+const char *sim_data_path(const char *name, char *buf, int len);
+
+// port the simulated web server listens on instead of 80
+int sim_http_port(void);
+
+// apply writes to the GPIO output registers
+void sim_gpio_sync(void);
+
+#endif
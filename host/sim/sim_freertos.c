@@ -0,0 +1,192 @@
+/*
+	FreeRTOS tasks run as detached threads; queues and semaphores are
+	built on a mutex and condition variable
+*/
+#include <errno.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+struct sim_queue
+{
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	UBaseType_t length;
+	UBaseType_t item_size;
+	UBaseType_t count;
+	UBaseType_t head;
+	uint8_t *items;
+};
+
+struct sim_task
+{
+	TaskFunction_t task;
+	void *arg;
+	pthread_t thread;
+};
+
+static void *task_entry(void *p)
+{
+	struct sim_task *t = p;
+
+	t->task(t->arg);
+	free(t);
+	return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char *name, uint32_t stack_depth,
+	void *arg, UBaseType_t priority, TaskHandle_t *created_task)
+{
+	struct sim_task *t = calloc(1, sizeof(*t));
+
+	if (!t)
+		return pdFAIL;
+	t->task = task;
+	t->arg = arg;
+	if (pthread_create(&t->thread, NULL, task_entry, t) != 0)
+	{
+		free(t);
+		return pdFAIL;
+	}
+	pthread_detach(t->thread);
+	if (created_task)
+		*created_task = t;
+	return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+	// only deleting the calling task is supported
+	if (task == NULL)
+		pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+	usleep((useconds_t)ticks * portTICK_PERIOD_MS * 1000);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (TickType_t)(ts.tv_sec * configTICK_RATE_HZ + ts.tv_nsec / (1000000000 / configTICK_RATE_HZ));
+}
+
+static bool queue_wait(struct sim_queue *q, TickType_t ticks_to_wait, const struct timespec *deadline)
+{
+	if (ticks_to_wait == 0)
+		return false;
+	if (ticks_to_wait == portMAX_DELAY)
+		return pthread_cond_wait(&q->cond, &q->lock) == 0;
+	return pthread_cond_timedwait(&q->cond, &q->lock, deadline) != ETIMEDOUT;
+}
+
+static void queue_deadline(TickType_t ticks_to_wait, struct timespec *deadline)
+{
+	uint64_t ns;
+
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	if (ticks_to_wait == portMAX_DELAY)
+		return;
+	ns = deadline->tv_nsec + (uint64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000000;
+	deadline->tv_sec += ns / 1000000000;
+	deadline->tv_nsec = ns % 1000000000;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+	struct sim_queue *q = calloc(1, sizeof(*q));
+	pthread_condattr_t attr;
+
+	if (!q)
+		return NULL;
+	q->length = length;
+	q->item_size = item_size;
+	q->items = calloc(length, item_size ? item_size : 1);
+	pthread_mutex_init(&q->lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&q->cond, &attr);
+	return q;
+}
+
+QueueHandle_t sim_semaphore_create_mutex(void)
+{
+	QueueHandle_t q = xQueueCreate(1, 0);
+
+	// a mutex starts out available
+	if (q)
+		q->count = 1;
+	return q;
+}
+
+void vQueueDelete(QueueHandle_t q)
+{
+	pthread_mutex_destroy(&q->lock);
+	pthread_cond_destroy(&q->cond);
+	free(q->items);
+	free(q);
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks_to_wait)
+{
+	struct timespec deadline;
+
+	queue_deadline(ticks_to_wait, &deadline);
+	pthread_mutex_lock(&q->lock);
+	while (q->count == q->length)
+	{
+		if (!queue_wait(q, ticks_to_wait, &deadline))
+		{
+			pthread_mutex_unlock(&q->lock);
+			return pdFAIL;
+		}
+	}
+	if (q->item_size)
+		memcpy(q->items + ((q->head + q->count) % q->length) * q->item_size, item, q->item_size);
+	q->count++;
+	pthread_cond_broadcast(&q->cond);
+	pthread_mutex_unlock(&q->lock);
+	return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *buffer, TickType_t ticks_to_wait)
+{
+	struct timespec deadline;
+
+	queue_deadline(ticks_to_wait, &deadline);
+	pthread_mutex_lock(&q->lock);
+	while (q->count == 0)
+	{
+		if (!queue_wait(q, ticks_to_wait, &deadline))
+		{
+			pthread_mutex_unlock(&q->lock);
+			return pdFAIL;
+		}
+	}
+	if (q->item_size)
+		memcpy(buffer, q->items + q->head * q->item_size, q->item_size);
+	q->head = (q->head + 1) % q->length;
+	q->count--;
+	pthread_cond_broadcast(&q->cond);
+	pthread_mutex_unlock(&q->lock);
+	return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+	UBaseType_t count;
+
+	pthread_mutex_lock(&q->lock);
+	count = q->count;
+	pthread_mutex_unlock(&q->lock);
+	return count;
+}
@@ -0,0 +1,77 @@
+/*
+	GPIO: outputs are only logged
+*/
+#include <pthread.h>
+#include "driver/gpio.h"
+#include "esp8266/gpio_struct.h"
+#include "esp_log.h"
+#include "sim.h"
+
+static const char *TAG = "gpio";
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t levels;
+static uint32_t outputs;
+
+volatile gpio_dev_t GPIO;
+
+static void log_changes(uint32_t old)
+{
+	// GPIO2 is the blinking LED - don't flood the log with it
+	uint32_t changed = (old ^ levels) & ~(1 << GPIO_NUM_2);
+
+	for (int gpio_num = 0; gpio_num < GPIO_NUM_MAX; gpio_num++)
+	{
+		if (changed & (1 << gpio_num))
+			ESP_LOGI(TAG, "GPIO%u -> %u", gpio_num, (levels >> gpio_num) & 1);
+	}
+}
+
+void sim_gpio_sync(void)
+{
+	uint32_t old;
+
+	pthread_mutex_lock(&lock);
+	old = levels;
+	levels = (levels | GPIO.out_w1ts) & ~GPIO.out_w1tc;
+	GPIO.out_w1ts = 0;
+	GPIO.out_w1tc = 0;
+	GPIO.out = levels;
+	log_changes(old);
+	pthread_mutex_unlock(&lock);
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+	if (gpio_num >= GPIO_NUM_MAX)
+		return ESP_ERR_INVALID_ARG;
+
+	if (mode == GPIO_MODE_OUTPUT || mode == GPIO_MODE_OUTPUT_OD)
+		outputs |= 1 << gpio_num;
+	else
+		outputs &= ~(1 << gpio_num);
+	return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+	uint32_t old;
+
+	if (gpio_num >= GPIO_NUM_MAX)
+		return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&lock);
+	old = levels;
+	if (level)
+		levels |= 1 << gpio_num;
+	else
+		levels &= ~(1 << gpio_num);
+	GPIO.out = levels;
+	log_changes(old);
+	pthread_mutex_unlock(&lock);
+	return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+	return (levels >> gpio_num) & 1;
+}
@@ -0,0 +1,755 @@
+/*
+	esp_http_server: a small HTTP/1.1 server with keep-alive. Like the
+	real one, a single task accepts connections, parses requests and calls
+	the URI handlers; other tasks reach it through httpd_queue_work().
+*/
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/param.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "sim.h"
+
+#define MAX_SESSIONS 16
+#define SESSION_BUF 4096
+
+struct resp_header
+{
+	const char *field;
+	const char *value;
+};
+
+struct session
+{
+	int fd;
+	bool closing;
+	void *ctx;			// httpd_req_t.sess_ctx, kept between requests
+	httpd_free_ctx_fn_t free_ctx;
+	size_t len;			// bytes in 'buf'
+	char buf[SESSION_BUF];
+};
+
+struct work
+{
+	httpd_work_fn_t fn;
+	void *arg;
+	struct work *next;
+};
+
+struct sim_httpd
+{
+	httpd_config_t config;
+	int listen_fd;
+	int wake[2];
+	bool stop;
+	pthread_t thread;
+	httpd_uri_t *uris;
+	int num_uris;
+	struct session sessions[MAX_SESSIONS];
+	pthread_mutex_t work_lock;
+	struct work *work;
+};
+
+// per-request state behind httpd_req_t.aux
+struct req_aux
+{
+	struct sim_httpd *hd;
+	struct session *sess;
+	const char *headers;	// raw header lines of the request
+	const char *body;		// body bytes that were read along with the headers
+	size_t body_len;
+	size_t content_left;	// body bytes not yet passed to the handler
+	const char *status;
+	const char *type;
+	struct resp_header resp_hdrs[16];
+	int num_resp_hdrs;
+	bool chunked;			// headers for a chunked response have gone out
+	bool responded;
+};
+
+static const char *TAG = "httpd";
+
+static int send_all(int fd, const char *buf, size_t len)
+{
+	size_t sent = 0;
+
+	while (sent < len)
+	{
+		ssize_t n = send(fd, buf + sent, len - sent, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return HTTPD_SOCK_ERR_FAIL;
+		sent += n;
+	}
+	return len;
+}
+
+static void session_close(struct session *sess)
+{
+	if (sess->fd >= 0)
+		close(sess->fd);
+	if (sess->ctx)
+	{
+		if (sess->free_ctx)
+			sess->free_ctx(sess->ctx);
+		else
+			free(sess->ctx);
+	}
+	sess->ctx = NULL;
+	sess->free_ctx = NULL;
+	sess->fd = -1;
+	sess->len = 0;
+	sess->closing = false;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+	struct sim_httpd *hd = handle;
+
+	for (int i = 0; i < hd->num_uris; i++)
+	{
+		if (strcmp(hd->uris[i].uri, uri_handler->uri) == 0 && hd->uris[i].method == uri_handler->method)
+			return ESP_ERR_HTTPD_HANDLER_EXISTS;
+	}
+
+	if (hd->num_uris >= hd->config.max_uri_handlers)
+	{
+		ESP_LOGE(TAG, "no slots left for registering handler %s", uri_handler->uri);
+		return ESP_ERR_HTTPD_HANDLERS_FULL;
+	}
+
+	hd->uris[hd->num_uris++] = *uri_handler;
+	return ESP_OK;
+}
+
+esp_err_t httpd_unregister_uri(httpd_handle_t handle, const char *uri)
+{
+	struct sim_httpd *hd = handle;
+	esp_err_t err = ESP_ERR_NOT_FOUND;
+
+	for (int i = 0; i < hd->num_uris; )
+	{
+		if (strcmp(hd->uris[i].uri, uri) == 0)
+		{
+			memmove(&hd->uris[i], &hd->uris[i + 1], (hd->num_uris - i - 1) * sizeof(httpd_uri_t));
+			hd->num_uris--;
+			err = ESP_OK;
+		}
+		else
+			i++;
+	}
+	return err;
+}
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t fn, void *arg)
+{
+	struct sim_httpd *hd = handle;
+	struct work *w = calloc(1, sizeof(*w)), **p;
+
+	if (!w)
+		return ESP_ERR_NO_MEM;
+	w->fn = fn;
+	w->arg = arg;
+
+	pthread_mutex_lock(&hd->work_lock);
+	for (p = &hd->work; *p; p = &(*p)->next)
+		;
+	*p = w;
+	pthread_mutex_unlock(&hd->work_lock);
+
+	if (write(hd->wake[1], "w", 1) != 1)
+		return ESP_FAIL;
+	return ESP_OK;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *r)
+{
+	struct req_aux *aux = r->aux;
+	return aux->sess->fd;
+}
+
+int httpd_socket_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags)
+{
+	if (sockfd < 0)
+		return HTTPD_SOCK_ERR_INVALID;
+	return send_all(sockfd, buf, buf_len);
+}
+
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd)
+{
+	struct sim_httpd *hd = handle;
+
+	for (int i = 0; i < MAX_SESSIONS; i++)
+	{
+		if (hd->sessions[i].fd == sockfd)
+		{
+			hd->sessions[i].closing = true;
+			return write(hd->wake[1], "c", 1) == 1 ? ESP_OK : ESP_FAIL;
+		}
+	}
+	return ESP_ERR_NOT_FOUND;
+}
+
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len)
+{
+	struct req_aux *aux = r->aux;
+	ssize_t n;
+
+	if (aux->content_left == 0)
+		return 0;
+	if (buf_len > aux->content_left)
+		buf_len = aux->content_left;
+
+	// hand out what was read along with the headers first
+	if (aux->body_len)
+	{
+		n = MIN(buf_len, aux->body_len);
+		memcpy(buf, aux->body, n);
+		aux->body += n;
+		aux->body_len -= n;
+	}
+	else
+	{
+		n = recv(aux->sess->fd, buf, buf_len, 0);
+		if (n < 0)
+			return errno == EAGAIN ? HTTPD_SOCK_ERR_TIMEOUT : HTTPD_SOCK_ERR_FAIL;
+		if (n == 0)
+			return HTTPD_SOCK_ERR_FAIL;
+	}
+	aux->content_left -= n;
+	return n;
+}
+
+static const char *find_header(const char *headers, const char *field, size_t *len)
+{
+	size_t field_len = strlen(field);
+	const char *line = headers;
+
+	while (line && *line)
+	{
+		const char *end = strstr(line, "\r\n");
+		if (!end)
+			break;
+		if (strncasecmp(line, field, field_len) == 0 && line[field_len] == ':')
+		{
+			const char *value = line + field_len + 1;
+			while (*value == ' ' || *value == '\t')
+				value++;
+			*len = end - value;
+			return value;
+		}
+		line = end + 2;
+	}
+	return NULL;
+}
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field)
+{
+	struct req_aux *aux = r->aux;
+	size_t len = 0;
+
+	return find_header(aux->headers, field, &len) ? len : 0;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size)
+{
+	struct req_aux *aux = r->aux;
+	size_t len;
+	const char *value = find_header(aux->headers, field, &len);
+
+	if (!value)
+		return ESP_ERR_NOT_FOUND;
+	if (val_size == 0)
+		return ESP_ERR_HTTPD_RESULT_TRUNC;
+
+	if (len >= val_size)
+	{
+		memcpy(val, value, val_size - 1);
+		val[val_size - 1] = 0;
+		return ESP_ERR_HTTPD_RESULT_TRUNC;
+	}
+	memcpy(val, value, len);
+	val[len] = 0;
+	return ESP_OK;
+}
+
+size_t httpd_req_get_url_query_len(httpd_req_t *r)
+{
+	const char *query = strchr(r->uri, '?');
+	return query ? strlen(query + 1) : 0;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len)
+{
+	const char *query = strchr(r->uri, '?');
+
+	if (!query)
+		return ESP_ERR_NOT_FOUND;
+	query++;
+
+	if (strlen(query) >= buf_len)
+	{
+		memcpy(buf, query, buf_len - 1);
+		buf[buf_len - 1] = 0;
+		return ESP_ERR_HTTPD_RESULT_TRUNC;
+	}
+	strcpy(buf, query);
+	return ESP_OK;
+}
+
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size)
+{
+	size_t key_len = strlen(key);
+	const char *p = qry;
+
+	while (p && *p)
+	{
+		const char *end = strchr(p, '&');
+		size_t len = end ? (size_t)(end - p) : strlen(p);
+
+		if (len > key_len && strncmp(p, key, key_len) == 0 && p[key_len] == '=')
+		{
+			const char *value = p + key_len + 1;
+			size_t value_len = len - key_len - 1;
+
+			if (value_len >= val_size)
+			{
+				memcpy(val, value, val_size - 1);
+				val[val_size - 1] = 0;
+				return ESP_ERR_HTTPD_RESULT_TRUNC;
+			}
+			memcpy(val, value, value_len);
+			val[value_len] = 0;
+			return ESP_OK;
+		}
+		p = end ? end + 1 : NULL;
+	}
+	return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status)
+{
+	struct req_aux *aux = r->aux;
+	aux->status = status;
+	return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
+{
+	struct req_aux *aux = r->aux;
+	aux->type = type;
+	return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value)
+{
+	struct req_aux *aux = r->aux;
+
+	if (aux->num_resp_hdrs >= aux->hd->config.max_resp_headers)
+		return ESP_ERR_HTTPD_RESP_HDR;
+	aux->resp_hdrs[aux->num_resp_hdrs].field = field;
+	aux->resp_hdrs[aux->num_resp_hdrs].value = value;
+	aux->num_resp_hdrs++;
+	return ESP_OK;
+}
+
+static esp_err_t send_headers(httpd_req_t *r, const char *length_hdr)
+{
+	struct req_aux *aux = r->aux;
+	char hdr[1024];
+	int len;
+
+	len = snprintf(hdr, sizeof(hdr), "HTTP/1.1 %s\r\nContent-Type: %s\r\n%s\r\n",
+		aux->status, aux->type, length_hdr);
+	for (int i = 0; i < aux->num_resp_hdrs && len < (int)sizeof(hdr); i++)
+		len += snprintf(hdr + len, sizeof(hdr) - len, "%s: %s\r\n",
+			aux->resp_hdrs[i].field, aux->resp_hdrs[i].value);
+	if (len + 2 >= (int)sizeof(hdr))
+		return ESP_ERR_HTTPD_RESP_HDR;
+	strcpy(hdr + len, "\r\n");
+	len += 2;
+
+	aux->responded = true;
+	return send_all(aux->sess->fd, hdr, len) < 0 ? ESP_ERR_HTTPD_RESP_SEND : ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+	struct req_aux *aux = r->aux;
+	char length_hdr[sizeof("Content-Length: -9223372036854775808")];
+	esp_err_t err;
+
+	if (buf == NULL)
+		buf_len = 0;
+	snprintf(length_hdr, sizeof(length_hdr), "Content-Length: %zd", buf_len);
+	err = send_headers(r, length_hdr);
+	if (err == ESP_OK && buf_len && send_all(aux->sess->fd, buf, buf_len) < 0)
+		err = ESP_ERR_HTTPD_RESP_SEND;
+	return err;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+	struct req_aux *aux = r->aux;
+	char size[16];
+
+	if (buf == NULL)
+		buf_len = 0;
+
+	if (!aux->chunked)
+	{
+		esp_err_t err = send_headers(r, "Transfer-Encoding: chunked");
+		if (err != ESP_OK)
+			return err;
+		aux->chunked = true;
+	}
+
+	snprintf(size, sizeof(size), "%zx\r\n", buf_len);
+	if (send_all(aux->sess->fd, size, strlen(size)) < 0 ||
+		(buf_len && send_all(aux->sess->fd, buf, buf_len) < 0) ||
+		send_all(aux->sess->fd, "\r\n", 2) < 0)
+		return ESP_ERR_HTTPD_RESP_SEND;
+	return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg)
+{
+	const char *status;
+
+	switch (error)
+	{
+	case HTTPD_400_BAD_REQUEST: status = "400 Bad Request"; break;
+	case HTTPD_404_NOT_FOUND: status = "404 Not Found"; break;
+	case HTTPD_405_METHOD_NOT_ALLOWED: status = "405 Method Not Allowed"; break;
+	case HTTPD_408_REQ_TIMEOUT: status = "408 Request Timeout"; break;
+	case HTTPD_411_LENGTH_REQUIRED: status = "411 Length Required"; break;
+	case HTTPD_414_URI_TOO_LONG: status = "414 URI Too Long"; break;
+	case HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE: status = "431 Request Header Fields Too Large"; break;
+	case HTTPD_501_METHOD_NOT_IMPLEMENTED: status = "501 Method Not Implemented"; break;
+	case HTTPD_505_VERSION_NOT_SUPPORTED: status = "505 Version Not Supported"; break;
+	default: status = "500 Internal Server Error"; break;
+	}
+
+	httpd_resp_set_status(req, status);
+	httpd_resp_set_type(req, "text/html");
+	return httpd_resp_send(req, msg ? msg : status, strlen(msg ? msg : status));
+}
+
+esp_err_t httpd_resp_send_404(httpd_req_t *r)
+{
+	return httpd_resp_send_err(r, HTTPD_404_NOT_FOUND, "This URI does not exist");
+}
+
+esp_err_t httpd_resp_send_500(httpd_req_t *r)
+{
+	return httpd_resp_send_err(r, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+}
+
+static int parse_method(const char *method)
+{
+	if (strcmp(method, "GET") == 0) return HTTP_GET;
+	if (strcmp(method, "POST") == 0) return HTTP_POST;
+	if (strcmp(method, "PUT") == 0) return HTTP_PUT;
+	if (strcmp(method, "DELETE") == 0) return HTTP_DELETE;
+	if (strcmp(method, "HEAD") == 0) return HTTP_HEAD;
+	return -1;
+}
+
+/*
+	Handle the request at the start of the session buffer once all of its
+	headers have arrived. Returns false when the session must be closed.
+*/
+static bool handle_request(struct sim_httpd *hd, struct session *sess)
+{
+	char *end, *line_end, *path_end;
+	char method[8];
+	httpd_req_t req = { 0 };
+	struct req_aux aux = { 0 };
+	httpd_uri_t *uri = NULL;
+	bool path_found = false;
+	size_t header_len, uri_len, path_len, len;
+	size_t content_len = 0;
+	const char *value;
+	esp_err_t err;
+
+	end = memmem(sess->buf, sess->len, "\r\n\r\n", 4);
+	if (!end)
+		return sess->len < SESSION_BUF - 1;
+	header_len = end + 4 - sess->buf;
+
+	// request line
+	sess->buf[sess->len] = 0;
+	line_end = strstr(sess->buf, "\r\n");
+	if (sscanf(sess->buf, "%7s", method) != 1)
+		return false;
+	value = sess->buf + strlen(method) + 1;
+	path_end = strchr(value, ' ');
+	if (!path_end || path_end > line_end)
+		return false;
+	uri_len = path_end - value;
+	if (uri_len > HTTPD_MAX_URI_LEN)
+		return false;
+	memcpy((char*)req.uri, value, uri_len);
+	path_len = strcspn(req.uri, "?");
+
+	aux.hd = hd;
+	aux.sess = sess;
+	aux.headers = line_end + 2;
+	end[2] = 0;		// terminate the headers after the last "\r\n"
+	aux.status = HTTPD_200;
+	aux.type = HTTPD_TYPE_TEXT;
+
+	if ((value = find_header(aux.headers, "Content-Length", &len)) != NULL)
+		content_len = strtoul(value, NULL, 10);
+	aux.body = sess->buf + header_len;
+	aux.body_len = MIN(sess->len - header_len, content_len);
+	aux.content_left = content_len;
+
+	req.handle = hd;
+	req.method = parse_method(method);
+	req.content_len = content_len;
+	req.aux = &aux;
+
+	for (int i = 0; i < hd->num_uris; i++)
+	{
+		if (strlen(hd->uris[i].uri) == path_len && strncmp(hd->uris[i].uri, req.uri, path_len) == 0)
+		{
+			path_found = true;
+			if ((int)hd->uris[i].method == req.method)
+			{
+				uri = &hd->uris[i];
+				break;
+			}
+		}
+	}
+
+	if (uri)
+	{
+		req.user_ctx = uri->user_ctx;
+		req.sess_ctx = sess->ctx;
+		req.free_ctx = sess->free_ctx;
+		err = uri->handler(&req);
+		sess->ctx = req.sess_ctx;
+		sess->free_ctx = req.free_ctx;
+		sim_gpio_sync();
+	}
+	else if (path_found)
+		err = httpd_resp_send_err(&req, HTTPD_405_METHOD_NOT_ALLOWED, "Request method for this URI is not handled by server");
+	else
+		err = httpd_resp_send_404(&req);
+
+	// throw away whatever the handler didn't read of the body
+	while (aux.content_left)
+	{
+		char discard[256];
+		if (httpd_req_recv(&req, discard, sizeof(discard)) <= 0)
+			return false;
+	}
+
+	// keep any pipelined bytes that followed this request
+	len = MIN(sess->len, header_len + content_len);
+	memmove(sess->buf, sess->buf + len, sess->len - len);
+	sess->len -= len;
+
+	if (err != ESP_OK)
+	{
+		ESP_LOGW(TAG, "%s %s: handler returned 0x%x - closing session", method, req.uri, (int)err);
+		return false;
+	}
+	return true;
+}
+
+static void run_work(struct sim_httpd *hd)
+{
+	while (1)
+	{
+		struct work *w;
+
+		pthread_mutex_lock(&hd->work_lock);
+		w = hd->work;
+		if (w)
+			hd->work = w->next;
+		pthread_mutex_unlock(&hd->work_lock);
+
+		if (!w)
+			break;
+		w->fn(w->arg);
+		free(w);
+	}
+}
+
+static void *httpd_task(void *p)
+{
+	struct sim_httpd *hd = p;
+
+	while (!hd->stop)
+	{
+		fd_set fds;
+		int max_fd = MAX(hd->listen_fd, hd->wake[0]);
+
+		FD_ZERO(&fds);
+		FD_SET(hd->listen_fd, &fds);
+		FD_SET(hd->wake[0], &fds);
+		for (int i = 0; i < MAX_SESSIONS; i++)
+		{
+			if (hd->sessions[i].fd >= 0)
+			{
+				FD_SET(hd->sessions[i].fd, &fds);
+				max_fd = MAX(max_fd, hd->sessions[i].fd);
+			}
+		}
+
+		if (select(max_fd + 1, &fds, NULL, NULL, NULL) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		if (FD_ISSET(hd->wake[0], &fds))
+		{
+			char c[16];
+			if (read(hd->wake[0], c, sizeof(c)) < 0)
+				break;
+			run_work(hd);
+		}
+
+		if (FD_ISSET(hd->listen_fd, &fds))
+		{
+			int fd = accept(hd->listen_fd, NULL, NULL);
+			int open_sessions = 0;
+			struct session *free_sess = NULL;
+
+			for (int i = 0; i < MAX_SESSIONS; i++)
+			{
+				if (hd->sessions[i].fd >= 0)
+					open_sessions++;
+				else if (!free_sess)
+					free_sess = &hd->sessions[i];
+			}
+
+			if (fd >= 0 && (open_sessions >= hd->config.max_open_sockets || !free_sess))
+			{
+				ESP_LOGW(TAG, "no free sessions");
+				close(fd);
+			}
+			else if (fd >= 0)
+			{
+				struct timeval tv = { .tv_sec = hd->config.recv_wait_timeout };
+				int one = 1;
+
+				setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+				tv.tv_sec = hd->config.send_wait_timeout;
+				setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+				setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+				free_sess->fd = fd;
+				free_sess->len = 0;
+			}
+		}
+
+		for (int i = 0; i < MAX_SESSIONS; i++)
+		{
+			struct session *sess = &hd->sessions[i];
+			ssize_t n;
+
+			if (sess->fd < 0)
+				continue;
+
+			if (sess->closing)
+			{
+				session_close(sess);
+				continue;
+			}
+
+			if (!FD_ISSET(sess->fd, &fds))
+				continue;
+
+			n = recv(sess->fd, sess->buf + sess->len, SESSION_BUF - 1 - sess->len, 0);
+			if (n <= 0)
+			{
+				session_close(sess);
+				continue;
+			}
+			sess->len += n;
+
+			// there may be several pipelined requests
+			while (sess->fd >= 0 && sess->len && memmem(sess->buf, sess->len, "\r\n\r\n", 4))
+			{
+				if (!handle_request(hd, sess))
+					session_close(sess);
+			}
+			if (sess->fd >= 0 && sess->len >= SESSION_BUF - 1)
+				session_close(sess);
+		}
+	}
+
+	for (int i = 0; i < MAX_SESSIONS; i++)
+		session_close(&hd->sessions[i]);
+	close(hd->listen_fd);
+	return NULL;
+}
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+	struct sim_httpd *hd = calloc(1, sizeof(*hd));
+	struct sockaddr_in addr = { 0 };
+	int one = 1;
+	uint16_t port = config->server_port == 80 ? sim_http_port() : config->server_port;
+
+	if (!hd)
+		return ESP_ERR_HTTPD_ALLOC_MEM;
+
+	hd->config = *config;
+	hd->uris = calloc(config->max_uri_handlers, sizeof(httpd_uri_t));
+	pthread_mutex_init(&hd->work_lock, NULL);
+	for (int i = 0; i < MAX_SESSIONS; i++)
+		hd->sessions[i].fd = -1;
+
+	hd->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	setsockopt(hd->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (bind(hd->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+		listen(hd->listen_fd, config->backlog_conn) < 0 ||
+		pipe(hd->wake) < 0)
+	{
+		ESP_LOGE(TAG, "Can't listen on port %u: %s", port, strerror(errno));
+		close(hd->listen_fd);
+		free(hd->uris);
+		free(hd);
+		return ESP_ERR_HTTPD_TASK;
+	}
+
+	ESP_LOGI(TAG, "Listening on port %u", port);
+	pthread_create(&hd->thread, NULL, httpd_task, hd);
+	*handle = hd;
+	return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle)
+{
+	struct sim_httpd *hd = handle;
+
+	if (!hd)
+		return ESP_ERR_INVALID_ARG;
+
+	hd->stop = true;
+	if (write(hd->wake[1], "s", 1) == 1)
+		pthread_join(hd->thread, NULL);
+	close(hd->wake[0]);
+	close(hd->wake[1]);
+	free(hd->uris);
+	free(hd);
+	return ESP_OK;
+}
@@ -0,0 +1,299 @@
+/*
+	Networking: the default event loop, a Wi-Fi station that connects
+	straight away, SNTP, mDNS and WPS. The host clock is already correct so
+	SNTP only has to pretend that the server answered.
+*/
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "esp_wps.h"
+#include "mdns.h"
+#include "lwip/apps/sntp.h"
+#include "sim.h"
+
+#define MAX_EVENT_HANDLERS 16
+#define SNTP_RESPONSE_DELAY 1500000		// microseconds until the SNTP server 'answers'
+
+ESP_EVENT_DEFINE_BASE(WIFI_EVENT);
+ESP_EVENT_DEFINE_BASE(IP_EVENT);
+
+struct event_handler
+{
+	esp_event_base_t base;
+	int32_t id;
+	esp_event_handler_t handler;
+	void *arg;
+};
+
+struct posted_event
+{
+	esp_event_base_t base;
+	int32_t id;
+	void *data;
+	struct posted_event *next;
+};
+
+static const char *TAG = "net";
+static pthread_mutex_t event_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t event_cond = PTHREAD_COND_INITIALIZER;
+static struct event_handler handlers[MAX_EVENT_HANDLERS];
+static struct posted_event *queue_head, *queue_tail;
+static bool loop_created;
+static wifi_config_t sta_config;
+static bool sta_configured;
+static int64_t sntp_start;
+
+static void *event_task(void *p)
+{
+	while (1)
+	{
+		struct posted_event *e;
+
+		pthread_mutex_lock(&event_lock);
+		while (!queue_head)
+			pthread_cond_wait(&event_cond, &event_lock);
+		e = queue_head;
+		queue_head = e->next;
+		if (!queue_head)
+			queue_tail = NULL;
+		pthread_mutex_unlock(&event_lock);
+
+		for (int i = 0; i < MAX_EVENT_HANDLERS; i++)
+		{
+			struct event_handler *h = &handlers[i];
+			if (h->handler && (h->base == e->base) && (h->id == ESP_EVENT_ANY_ID || h->id == e->id))
+			{
+				h->handler(h->arg, e->base, e->id, e->data);
+				sim_gpio_sync();
+			}
+		}
+		free(e->data);
+		free(e);
+	}
+	return NULL;
+}
+
+esp_err_t esp_event_loop_create_default(void)
+{
+	pthread_t thread;
+
+	if (loop_created)
+		return ESP_ERR_INVALID_STATE;
+	pthread_create(&thread, NULL, event_task, NULL);
+	pthread_detach(thread);
+	loop_created = true;
+	return ESP_OK;
+}
+
+esp_err_t esp_event_handler_register(esp_event_base_t event_base, int32_t event_id,
+	esp_event_handler_t event_handler, void *event_handler_arg)
+{
+	for (int i = 0; i < MAX_EVENT_HANDLERS; i++)
+	{
+		if (!handlers[i].handler)
+		{
+			handlers[i].base = event_base;
+			handlers[i].id = event_id;
+			handlers[i].handler = event_handler;
+			handlers[i].arg = event_handler_arg;
+			return ESP_OK;
+		}
+	}
+	return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_event_handler_unregister(esp_event_base_t event_base, int32_t event_id,
+	esp_event_handler_t event_handler)
+{
+	for (int i = 0; i < MAX_EVENT_HANDLERS; i++)
+	{
+		if (handlers[i].handler == event_handler && handlers[i].base == event_base && handlers[i].id == event_id)
+		{
+			handlers[i].handler = NULL;
+			return ESP_OK;
+		}
+	}
+	return ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id,
+	void *event_data, size_t event_data_size, TickType_t ticks_to_wait)
+{
+	struct posted_event *e = calloc(1, sizeof(*e));
+
+	if (!loop_created)
+		return ESP_ERR_INVALID_STATE;
+
+	e->base = event_base;
+	e->id = event_id;
+	if (event_data_size)
+	{
+		e->data = malloc(event_data_size);
+		memcpy(e->data, event_data, event_data_size);
+	}
+
+	pthread_mutex_lock(&event_lock);
+	if (queue_tail)
+		queue_tail->next = e;
+	else
+		queue_head = e;
+	queue_tail = e;
+	pthread_cond_signal(&event_cond);
+	pthread_mutex_unlock(&event_lock);
+	return ESP_OK;
+}
+
+void tcpip_adapter_init(void)
+{
+}
+
+char *ip4addr_ntoa(const ip4_addr_t *addr)
+{
+	struct in_addr in = { .s_addr = addr->addr };
+	return inet_ntoa(in);
+}
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config)
+{
+	const char *ssid = getenv("WATER_SIM_SSID");
+
+	// the device keeps its AP in the Wi-Fi NVS area - start with a known one
+	if (!sta_configured)
+	{
+		strncpy((char*)sta_config.sta.ssid, ssid ? ssid : "simulated-ap", sizeof(sta_config.sta.ssid));
+		strncpy((char*)sta_config.sta.password, "password", sizeof(sta_config.sta.password));
+		sta_configured = true;
+	}
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_start(void)
+{
+	return esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_START, NULL, 0, 0);
+}
+
+esp_err_t esp_wifi_stop(void)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_connect(void)
+{
+	ip_event_got_ip_t got_ip = { 0 };
+
+	if (sta_config.sta.ssid[0] == 0)
+		return ESP_FAIL;
+
+	ESP_LOGI(TAG, "Associated with %s", sta_config.sta.ssid);
+	esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_CONNECTED, NULL, 0, 0);
+
+	got_ip.ip_info.ip.addr = htonl(INADDR_LOOPBACK);
+	got_ip.ip_info.netmask.addr = htonl(0xff000000);
+	got_ip.ip_info.gw.addr = htonl(INADDR_LOOPBACK);
+	return esp_event_post(IP_EVENT, IP_EVENT_STA_GOT_IP, &got_ip, sizeof(got_ip), 0);
+}
+
+esp_err_t esp_wifi_disconnect(void)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_config(esp_interface_t interface, wifi_config_t *conf)
+{
+	memcpy(conf, &sta_config, sizeof(*conf));
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(esp_interface_t interface, wifi_config_t *conf)
+{
+	memcpy(&sta_config, conf, sizeof(*conf));
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_protocol(esp_interface_t ifx, uint8_t protocol_bitmap)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+	memset(ap_info, 0, sizeof(*ap_info));
+	memcpy(ap_info->ssid, sta_config.sta.ssid, sizeof(sta_config.sta.ssid));
+	ap_info->rssi = -55 - (int8_t)(esp_timer_get_time() / 1000000 % 7);
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_wps_enable(const esp_wps_config_t *config)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_wps_disable(void)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_wps_start(int timeout_ms)
+{
+	ESP_LOGI(TAG, "WPS is not simulated - set WATER_SIM_SSID");
+	return ESP_OK;
+}
+
+void sntp_setoperatingmode(uint8_t operating_mode)
+{
+}
+
+void sntp_setservername(uint8_t idx, const char *server)
+{
+	ESP_LOGI(TAG, "SNTP server %u: %s", idx, server);
+}
+
+void sntp_init(void)
+{
+	sntp_start = esp_timer_get_time();
+}
+
+void sntp_stop(void)
+{
+	sntp_start = 0;
+}
+
+uint8_t sntp_getreachability(uint8_t idx)
+{
+	if (getenv("WATER_SIM_OFFLINE") || !sntp_start)
+		return 0;
+	return esp_timer_get_time() - sntp_start >= SNTP_RESPONSE_DELAY ? 1 : 0;
+}
+
+esp_err_t mdns_init(void)
+{
+	return ESP_OK;
+}
+
+esp_err_t mdns_hostname_set(const char *hostname)
+{
+	ESP_LOGI(TAG, "mDNS hostname %s", hostname);
+	return ESP_OK;
+}
+
+esp_err_t mdns_instance_name_set(const char *instance_name)
+{
+	return ESP_OK;
+}
+
+esp_err_t mdns_service_add(const char *instance_name, const char *service_type, const char *proto,
+	uint16_t port, mdns_txt_item_t txt[], size_t num_items)
+{
+	ESP_LOGI(TAG, "mDNS service %s.%s port %u", service_type, proto, port);
+	return ESP_OK;
+}
@@ -0,0 +1,344 @@
+/*
+	NVS: key/value pairs held in memory and written through to a file so
+	that they survive a simulated reboot
+*/
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nvs_flash.h"
+#include "esp_log.h"
+#include "sim.h"
+
+#define MAX_HANDLES 16
+
+enum nvs_type
+{
+	NVS_TYPE_U8 = 1,
+	NVS_TYPE_U32,
+	NVS_TYPE_STR,
+	NVS_TYPE_BLOB,
+};
+
+struct nvs_entry
+{
+	char ns[NVS_KEY_NAME_MAX_SIZE];
+	char key[NVS_KEY_NAME_MAX_SIZE];
+	uint8_t type;
+	uint32_t length;
+	uint8_t *data;
+	struct nvs_entry *next;
+};
+
+struct nvs_open_handle
+{
+	bool used;
+	bool writable;
+	char ns[NVS_KEY_NAME_MAX_SIZE];
+};
+
+static const char *TAG = "nvs";
+static pthread_mutex_t nvs_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct nvs_entry *entries;
+static struct nvs_open_handle handles[MAX_HANDLES];
+static bool initialized;
+static unsigned int writes;
+
+static void nvs_save(void)
+{
+	char path[256];
+	FILE *f = fopen(sim_data_path("nvs.bin", path, sizeof(path)), "wb");
+
+	if (!f)
+	{
+		ESP_LOGE(TAG, "Can't write %s", path);
+		return;
+	}
+
+	for (struct nvs_entry *e = entries; e; e = e->next)
+	{
+		fwrite(e->ns, sizeof(e->ns), 1, f);
+		fwrite(e->key, sizeof(e->key), 1, f);
+		fwrite(&e->type, sizeof(e->type), 1, f);
+		fwrite(&e->length, sizeof(e->length), 1, f);
+		fwrite(e->data, e->length, 1, f);
+	}
+	fclose(f);
+
+	// every set/erase is a flash write on the device - count them
+	ESP_LOGI(TAG, "flash write #%u", ++writes);
+}
+
+static void nvs_load(void)
+{
+	char path[256];
+	FILE *f = fopen(sim_data_path("nvs.bin", path, sizeof(path)), "rb");
+
+	if (!f)
+		return;
+
+	while (1)
+	{
+		struct nvs_entry *e = calloc(1, sizeof(*e));
+
+		if (fread(e->ns, sizeof(e->ns), 1, f) != 1 ||
+			fread(e->key, sizeof(e->key), 1, f) != 1 ||
+			fread(&e->type, sizeof(e->type), 1, f) != 1 ||
+			fread(&e->length, sizeof(e->length), 1, f) != 1)
+		{
+			free(e);
+			break;
+		}
+		e->data = malloc(e->length ? e->length : 1);
+		if (fread(e->data, e->length, 1, f) != 1 && e->length)
+		{
+			free(e->data);
+			free(e);
+			break;
+		}
+		e->next = entries;
+		entries = e;
+	}
+	fclose(f);
+}
+
+esp_err_t nvs_flash_init(void)
+{
+	pthread_mutex_lock(&nvs_lock);
+	if (!initialized)
+		nvs_load();
+	initialized = true;
+	pthread_mutex_unlock(&nvs_lock);
+	return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+	pthread_mutex_lock(&nvs_lock);
+	while (entries)
+	{
+		struct nvs_entry *e = entries;
+		entries = e->next;
+		free(e->data);
+		free(e);
+	}
+	nvs_save();
+	pthread_mutex_unlock(&nvs_lock);
+	return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode open_mode, nvs_handle *out_handle)
+{
+	esp_err_t err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+
+	if (!initialized)
+		return ESP_ERR_NVS_NOT_INITIALIZED;
+	if (strlen(name) >= NVS_KEY_NAME_MAX_SIZE)
+		return ESP_ERR_NVS_KEY_TOO_LONG;
+
+	pthread_mutex_lock(&nvs_lock);
+	for (int i = 0; i < MAX_HANDLES; i++)
+	{
+		if (!handles[i].used)
+		{
+			handles[i].used = true;
+			handles[i].writable = (open_mode == NVS_READWRITE);
+			strcpy(handles[i].ns, name);
+			*out_handle = i + 1;
+			err = ESP_OK;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&nvs_lock);
+	return err;
+}
+
+void nvs_close(nvs_handle handle)
+{
+	if (handle >= 1 && handle <= MAX_HANDLES)
+		handles[handle - 1].used = false;
+}
+
+esp_err_t nvs_commit(nvs_handle handle)
+{
+	if (handle < 1 || handle > MAX_HANDLES || !handles[handle - 1].used)
+		return ESP_ERR_NVS_INVALID_HANDLE;
+	return ESP_OK;
+}
+
+static struct nvs_entry **nvs_find(const char *ns, const char *key)
+{
+	struct nvs_entry **p;
+
+	for (p = &entries; *p; p = &(*p)->next)
+		if (strcmp((*p)->ns, ns) == 0 && strcmp((*p)->key, key) == 0)
+			return p;
+	return NULL;
+}
+
+static esp_err_t nvs_check(nvs_handle handle, const char *key, bool write)
+{
+	if (handle < 1 || handle > MAX_HANDLES || !handles[handle - 1].used)
+		return ESP_ERR_NVS_INVALID_HANDLE;
+	if (write && !handles[handle - 1].writable)
+		return ESP_ERR_NVS_READ_ONLY;
+	if (key && strlen(key) >= NVS_KEY_NAME_MAX_SIZE)
+		return ESP_ERR_NVS_KEY_TOO_LONG;
+	return ESP_OK;
+}
+
+static esp_err_t nvs_set(nvs_handle handle, const char *key, uint8_t type, const void *value, size_t length)
+{
+	struct nvs_entry **p, *e;
+	esp_err_t err = nvs_check(handle, key, true);
+
+	if (err != ESP_OK)
+		return err;
+
+	pthread_mutex_lock(&nvs_lock);
+	p = nvs_find(handles[handle - 1].ns, key);
+	if (p)
+	{
+		e = *p;
+		free(e->data);
+	}
+	else
+	{
+		e = calloc(1, sizeof(*e));
+		strcpy(e->ns, handles[handle - 1].ns);
+		strcpy(e->key, key);
+		e->next = entries;
+		entries = e;
+	}
+	e->type = type;
+	e->length = length;
+	e->data = malloc(length ? length : 1);
+	memcpy(e->data, value, length);
+	nvs_save();
+	pthread_mutex_unlock(&nvs_lock);
+	return ESP_OK;
+}
+
+static esp_err_t nvs_get(nvs_handle handle, const char *key, uint8_t type, void *out_value, size_t *length)
+{
+	struct nvs_entry **p;
+	esp_err_t err = nvs_check(handle, key, false);
+
+	if (err != ESP_OK)
+		return err;
+
+	pthread_mutex_lock(&nvs_lock);
+	p = nvs_find(handles[handle - 1].ns, key);
+	if (!p)
+		err = ESP_ERR_NVS_NOT_FOUND;
+	else if ((*p)->type != type)
+		err = ESP_ERR_NVS_TYPE_MISMATCH;
+	else if (out_value == NULL)
+		*length = (*p)->length;
+	else if (*length < (*p)->length)
+	{
+		*length = (*p)->length;
+		err = ESP_ERR_NVS_INVALID_LENGTH;
+	}
+	else
+	{
+		memcpy(out_value, (*p)->data, (*p)->length);
+		*length = (*p)->length;
+	}
+	pthread_mutex_unlock(&nvs_lock);
+	return err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle handle, const char *key)
+{
+	struct nvs_entry **p, *e;
+	esp_err_t err = nvs_check(handle, key, true);
+
+	if (err != ESP_OK)
+		return err;
+
+	pthread_mutex_lock(&nvs_lock);
+	p = nvs_find(handles[handle - 1].ns, key);
+	if (p)
+	{
+		e = *p;
+		*p = e->next;
+		free(e->data);
+		free(e);
+		nvs_save();
+	}
+	else
+		err = ESP_ERR_NVS_NOT_FOUND;
+	pthread_mutex_unlock(&nvs_lock);
+	return err;
+}
+
+esp_err_t nvs_erase_all(nvs_handle handle)
+{
+	struct nvs_entry **p;
+	esp_err_t err = nvs_check(handle, NULL, true);
+
+	if (err != ESP_OK)
+		return err;
+
+	pthread_mutex_lock(&nvs_lock);
+	p = &entries;
+	while (*p)
+	{
+		struct nvs_entry *e = *p;
+		if (strcmp(e->ns, handles[handle - 1].ns) == 0)
+		{
+			*p = e->next;
+			free(e->data);
+			free(e);
+		}
+		else
+			p = &e->next;
+	}
+	nvs_save();
+	pthread_mutex_unlock(&nvs_lock);
+	return ESP_OK;
+}
+
+esp_err_t nvs_set_u8(nvs_handle handle, const char *key, uint8_t value)
+{
+	return nvs_set(handle, key, NVS_TYPE_U8, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_u32(nvs_handle handle, const char *key, uint32_t value)
+{
+	return nvs_set(handle, key, NVS_TYPE_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_str(nvs_handle handle, const char *key, const char *value)
+{
+	return nvs_set(handle, key, NVS_TYPE_STR, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_set_blob(nvs_handle handle, const char *key, const void *value, size_t length)
+{
+	return nvs_set(handle, key, NVS_TYPE_BLOB, value, length);
+}
+
+esp_err_t nvs_get_u8(nvs_handle handle, const char *key, uint8_t *out_value)
+{
+	size_t length = sizeof(*out_value);
+	return nvs_get(handle, key, NVS_TYPE_U8, out_value, &length);
+}
+
+esp_err_t nvs_get_u32(nvs_handle handle, const char *key, uint32_t *out_value)
+{
+	size_t length = sizeof(*out_value);
+	return nvs_get(handle, key, NVS_TYPE_U32, out_value, &length);
+}
+
+esp_err_t nvs_get_str(nvs_handle handle, const char *key, char *out_value, size_t *length)
+{
+	return nvs_get(handle, key, NVS_TYPE_STR, out_value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle handle, const char *key, void *out_value, size_t *length)
+{
+	return nvs_get(handle, key, NVS_TYPE_BLOB, out_value, length);
+}
@@ -0,0 +1,521 @@
+/*
+	Flash partitions, OTA and the HTTP client. Each partition of
+	partitions.csv is a file in the simulator's data directory, and the
+	boot selection is kept in 'otadata'.
+*/
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "sim.h"
+
+#define ESP_IMAGE_HEADER_MAGIC 0xE9
+#define MAX_CLIENT_HEADERS 8
+#define CLIENT_BUF 2048
+
+static const char *TAG = "ota";
+
+// keep in sync with partitions.csv
+static const esp_partition_t partitions[] =
+{
+	{ ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, 0x9000, 0x4000, "nvs" },
+	{ ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, 0x10000, 0xF0000, "ota_0" },
+	{ ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, 0x110000, 0xF0000, "ota_1" },
+	{ ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, 0x210000, 0x200000, "storage" },
+};
+
+static struct
+{
+	const esp_partition_t *partition;
+	size_t written;
+	bool active;
+} ota;
+
+static int partition_open(const esp_partition_t *partition)
+{
+	char name[32], path[256];
+	int fd;
+
+	snprintf(name, sizeof(name), "flash_%s.bin", partition->label);
+	fd = open(sim_data_path(name, path, sizeof(path)), O_RDWR | O_CREAT, 0644);
+	if (fd < 0)
+		return -1;
+
+	// a new partition is erased flash
+	if (lseek(fd, 0, SEEK_END) < partition->size)
+	{
+		static const uint8_t erased[4096] = { [0 ... 4095] = 0xff };
+		off_t size = lseek(fd, 0, SEEK_END);
+
+		while (size < partition->size)
+		{
+			size_t n = MIN(sizeof(erased), partition->size - size);
+			if (pwrite(fd, erased, n, size) != (ssize_t)n)
+				break;
+			size += n;
+		}
+	}
+	return fd;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+	esp_partition_subtype_t subtype, const char *label)
+{
+	for (unsigned int i = 0; i < sizeof(partitions) / sizeof(partitions[0]); i++)
+	{
+		if (partitions[i].type != type)
+			continue;
+		if (subtype != ESP_PARTITION_SUBTYPE_ANY && partitions[i].subtype != subtype)
+			continue;
+		if (label && strcmp(label, partitions[i].label) != 0)
+			continue;
+		return &partitions[i];
+	}
+	return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+	int fd;
+	ssize_t n;
+
+	if (src_offset + size > partition->size)
+		return ESP_ERR_INVALID_SIZE;
+	fd = partition_open(partition);
+	if (fd < 0)
+		return ESP_FAIL;
+	n = pread(fd, dst, size, src_offset);
+	close(fd);
+	return n == (ssize_t)size ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+{
+	uint8_t *old = malloc(size);
+	const uint8_t *data = src;
+	int fd;
+	esp_err_t err = ESP_FAIL;
+
+	if (dst_offset + size > partition->size)
+	{
+		free(old);
+		return ESP_ERR_INVALID_SIZE;
+	}
+	fd = partition_open(partition);
+
+	// flash writes can only clear bits
+	if (fd >= 0 && old && pread(fd, old, size, dst_offset) == (ssize_t)size)
+	{
+		for (size_t i = 0; i < size; i++)
+			old[i] &= data[i];
+		if (pwrite(fd, old, size, dst_offset) == (ssize_t)size)
+			err = ESP_OK;
+	}
+	if (fd >= 0)
+		close(fd);
+	free(old);
+	return err;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t start_addr, size_t size)
+{
+	static const uint8_t erased[4096] = { [0 ... 4095] = 0xff };
+	int fd;
+
+	if (start_addr % 4096 || size % 4096)
+		return ESP_ERR_INVALID_ARG;
+	if (start_addr + size > partition->size)
+		return ESP_ERR_INVALID_SIZE;
+
+	fd = partition_open(partition);
+	if (fd < 0)
+		return ESP_FAIL;
+	for (size_t offset = 0; offset < size; offset += sizeof(erased))
+	{
+		if (pwrite(fd, erased, sizeof(erased), start_addr + offset) != sizeof(erased))
+		{
+			close(fd);
+			return ESP_FAIL;
+		}
+	}
+	close(fd);
+	return ESP_OK;
+}
+
+const esp_partition_t *esp_ota_get_boot_partition(void)
+{
+	char path[256], label[17] = "ota_0";
+	FILE *f = fopen(sim_data_path("otadata", path, sizeof(path)), "r");
+
+	if (f)
+	{
+		if (fscanf(f, "%16s", label) != 1)
+			strcpy(label, "ota_0");
+		fclose(f);
+	}
+	return esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, label);
+}
+
+const esp_partition_t *esp_ota_get_running_partition(void)
+{
+	static const esp_partition_t *running;
+
+	// whatever was selected when the process started
+	if (!running)
+		running = esp_ota_get_boot_partition();
+	return running;
+}
+
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from)
+{
+	const esp_partition_t *running = start_from ? start_from : esp_ota_get_running_partition();
+
+	return esp_partition_find_first(ESP_PARTITION_TYPE_APP,
+		running->subtype == ESP_PARTITION_SUBTYPE_APP_OTA_0 ? ESP_PARTITION_SUBTYPE_APP_OTA_1 : ESP_PARTITION_SUBTYPE_APP_OTA_0,
+		NULL);
+}
+
+esp_err_t esp_ota_begin(const esp_partition_t *partition, size_t image_size, esp_ota_handle_t *out_handle)
+{
+	esp_err_t err;
+
+	if (partition == esp_ota_get_running_partition())
+		return ESP_ERR_OTA_PARTITION_CONFLICT;
+
+	err = esp_partition_erase_range(partition, 0, partition->size);
+	if (err != ESP_OK)
+		return err;
+
+	ota.partition = partition;
+	ota.written = 0;
+	ota.active = true;
+	*out_handle = 1;
+	return ESP_OK;
+}
+
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size)
+{
+	esp_err_t err;
+
+	if (handle != 1 || !ota.active)
+		return ESP_ERR_INVALID_ARG;
+
+	if (ota.written == 0 && size && ((const uint8_t*)data)[0] != ESP_IMAGE_HEADER_MAGIC)
+	{
+		ESP_LOGE(TAG, "OTA image has invalid magic byte (expected 0xE9, saw 0x%02x)", ((const uint8_t*)data)[0]);
+		return ESP_ERR_OTA_VALIDATE_FAILED;
+	}
+
+	err = esp_partition_write(ota.partition, ota.written, data, size);
+	if (err == ESP_OK)
+		ota.written += size;
+	return err;
+}
+
+esp_err_t esp_ota_end(esp_ota_handle_t handle)
+{
+	if (handle != 1 || !ota.active)
+		return ESP_ERR_NOT_FOUND;
+
+	ota.active = false;
+	if (ota.written == 0)
+		return ESP_ERR_OTA_VALIDATE_FAILED;
+	return ESP_OK;
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition)
+{
+	char path[256];
+	FILE *f;
+	uint8_t magic;
+
+	if (!partition || partition->type != ESP_PARTITION_TYPE_APP)
+		return ESP_ERR_INVALID_ARG;
+	if (esp_partition_read(partition, 0, &magic, 1) != ESP_OK || magic != ESP_IMAGE_HEADER_MAGIC)
+		return ESP_ERR_OTA_VALIDATE_FAILED;
+
+	f = fopen(sim_data_path("otadata", path, sizeof(path)), "w");
+	if (!f)
+		return ESP_FAIL;
+	fprintf(f, "%s\n", partition->label);
+	fclose(f);
+	ESP_LOGI(TAG, "Boot partition is now %s", partition->label);
+	return ESP_OK;
+}
+
+struct esp_http_client
+{
+	esp_http_client_config_t config;
+	char *url;
+	int fd;
+	struct
+	{
+		char *key;
+		char *value;
+	} headers[MAX_CLIENT_HEADERS];
+	int num_headers;
+	int status;
+	int64_t content_length;
+	int64_t received;
+	char buf[CLIENT_BUF];
+	size_t buf_start, buf_len;
+};
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+	esp_http_client_handle_t client = calloc(1, sizeof(*client));
+
+	if (!client)
+		return NULL;
+	client->config = *config;
+	client->url = strdup(config->url ? config->url : "");
+	client->fd = -1;
+	client->content_length = -1;
+	return client;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url)
+{
+	free(client->url);
+	client->url = strdup(url);
+	return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value)
+{
+	for (int i = 0; i < client->num_headers; i++)
+	{
+		if (strcasecmp(client->headers[i].key, key) == 0)
+		{
+			free(client->headers[i].value);
+			client->headers[i].value = strdup(value);
+			return ESP_OK;
+		}
+	}
+
+	if (client->num_headers >= MAX_CLIENT_HEADERS)
+		return ESP_ERR_NO_MEM;
+	client->headers[client->num_headers].key = strdup(key);
+	client->headers[client->num_headers].value = strdup(value);
+	client->num_headers++;
+	return ESP_OK;
+}
+
+esp_err_t esp_http_client_get_header(esp_http_client_handle_t client, const char *key, char **value)
+{
+	*value = NULL;
+	for (int i = 0; i < client->num_headers; i++)
+	{
+		if (strcasecmp(client->headers[i].key, key) == 0)
+			*value = client->headers[i].value;
+	}
+	return ESP_OK;
+}
+
+static void client_event(esp_http_client_handle_t client, esp_http_client_event_id_t id,
+	char *key, char *value, void *data, int len)
+{
+	esp_http_client_event_t evt =
+	{
+		.event_id = id,
+		.client = client,
+		.data = data,
+		.data_len = len,
+		.user_data = client->config.user_data,
+		.header_key = key,
+		.header_value = value,
+	};
+
+	if (client->config.event_handler)
+		client->config.event_handler(&evt);
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len)
+{
+	char host[128], port[8] = "80", request[1024];
+	const char *p, *path;
+	struct addrinfo hints = { .ai_socktype = SOCK_STREAM }, *res;
+	int len;
+
+	if (strncmp(client->url, "http://", 7) != 0)
+	{
+		ESP_LOGE(TAG, "Only http:// is simulated");
+		return ESP_ERR_NOT_SUPPORTED;
+	}
+
+	p = client->url + 7;
+	path = strchr(p, '/');
+	if (!path)
+		path = "/";
+	len = strcspn(p, ":/");
+	if (len >= (int)sizeof(host))
+		return ESP_ERR_INVALID_ARG;
+	memcpy(host, p, len);
+	host[len] = 0;
+	if (p[len] == ':')
+		snprintf(port, sizeof(port), "%d", atoi(p + len + 1));
+
+	if (getaddrinfo(host, port, &hints, &res) != 0)
+		return ESP_FAIL;
+	client->fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+	if (client->fd >= 0 && connect(client->fd, res->ai_addr, res->ai_addrlen) < 0)
+	{
+		close(client->fd);
+		client->fd = -1;
+	}
+	freeaddrinfo(res);
+	if (client->fd < 0)
+		return ESP_FAIL;
+
+	if (client->config.timeout_ms)
+	{
+		struct timeval tv = { client->config.timeout_ms / 1000, (client->config.timeout_ms % 1000) * 1000 };
+		setsockopt(client->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+	}
+	client_event(client, HTTP_EVENT_ON_CONNECTED, NULL, NULL, NULL, 0);
+
+	len = snprintf(request, sizeof(request), "%s %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: ESP8266 HTTP Client\r\nConnection: close\r\n",
+		client->config.method == HTTP_METHOD_POST ? "POST" : client->config.method == HTTP_METHOD_HEAD ? "HEAD" : "GET",
+		path, host);
+	for (int i = 0; i < client->num_headers; i++)
+		len += snprintf(request + len, sizeof(request) - len, "%s: %s\r\n", client->headers[i].key, client->headers[i].value);
+	if (write_len > 0)
+		len += snprintf(request + len, sizeof(request) - len, "Content-Length: %d\r\n", write_len);
+	len += snprintf(request + len, sizeof(request) - len, "\r\n");
+
+	if (len >= (int)sizeof(request) || send(client->fd, request, len, MSG_NOSIGNAL) != len)
+		return ESP_FAIL;
+	client_event(client, HTTP_EVENT_HEADER_SENT, NULL, NULL, NULL, 0);
+	return ESP_OK;
+}
+
+int esp_http_client_fetch_headers(esp_http_client_handle_t client)
+{
+	char *end = NULL, *line;
+
+	client->buf_len = 0;
+	client->buf_start = 0;
+	client->status = 0;
+	client->content_length = -1;
+	while (!end)
+	{
+		ssize_t n;
+
+		if (client->buf_len >= sizeof(client->buf) - 1)
+			return ESP_FAIL;
+		n = recv(client->fd, client->buf + client->buf_len, sizeof(client->buf) - 1 - client->buf_len, 0);
+		if (n <= 0)
+			return ESP_FAIL;
+		client->buf_len += n;
+		client->buf[client->buf_len] = 0;
+		end = strstr(client->buf, "\r\n\r\n");
+	}
+
+	if (sscanf(client->buf, "HTTP/%*s %d", &client->status) != 1)
+		return ESP_FAIL;
+
+	*end = 0;
+	line = strstr(client->buf, "\r\n");
+	while (line)
+	{
+		char *key = line + 2, *value, *next = strstr(key, "\r\n");
+
+		if (next)
+			*next = 0;
+		value = strchr(key, ':');
+		if (value)
+		{
+			*value++ = 0;
+			while (*value == ' ')
+				value++;
+			if (strcasecmp(key, "Content-Length") == 0)
+				client->content_length = strtoll(value, NULL, 10);
+			client_event(client, HTTP_EVENT_ON_HEADER, key, value, NULL, 0);
+		}
+		line = next;
+	}
+
+	client->buf_start = end + 4 - client->buf;
+	client->received = 0;
+	return client->content_length < 0 ? 0 : client->content_length;
+}
+
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len)
+{
+	int n;
+
+	if (client->content_length >= 0)
+		len = MIN(len, client->content_length - client->received);
+	if (len <= 0)
+		return 0;
+
+	if (client->buf_start < client->buf_len)
+	{
+		n = MIN((size_t)len, client->buf_len - client->buf_start);
+		memcpy(buffer, client->buf + client->buf_start, n);
+		client->buf_start += n;
+	}
+	else
+	{
+		n = recv(client->fd, buffer, len, 0);
+		if (n < 0)
+			return ESP_FAIL;
+		// the server closed the connection early
+		if (n == 0 && client->content_length >= 0)
+			return ESP_FAIL;
+	}
+
+	client->received += n;
+	if (n > 0)
+		client_event(client, HTTP_EVENT_ON_DATA, NULL, NULL, buffer, n);
+	return n;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client)
+{
+	return client->status;
+}
+
+int esp_http_client_get_content_length(esp_http_client_handle_t client)
+{
+	return client->content_length;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client)
+{
+	if (client->fd >= 0)
+	{
+		close(client->fd);
+		client_event(client, HTTP_EVENT_DISCONNECTED, NULL, NULL, NULL, 0);
+	}
+	client->fd = -1;
+	return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
+{
+	esp_http_client_close(client);
+	for (int i = 0; i < client->num_headers; i++)
+	{
+		free(client->headers[i].key);
+		free(client->headers[i].value);
+	}
+	free(client->url);
+	free(client);
+	return ESP_OK;
+}
+
+esp_err_t esp_https_ota(const esp_http_client_config_t *config)
+{
+	return ESP_ERR_NOT_SUPPORTED;
+}
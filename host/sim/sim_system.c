@@ -0,0 +1,149 @@
+/*
+	Process level parts of the simulator: main(), logging, restart and
+	the few system calls the firmware makes
+*/
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_system.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sim.h"
+
+void app_main(void);
+
+static char **sim_argv;
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t base_mac[6] = { 0x02, 0x00, 0x57, 0x41, 0x54, 0x52 };
+static uint32_t min_free_heap = UINT32_MAX;
+
+const char *sim_data_path(const char *name, char *buf, int len)
+{
+	const char *dir = getenv("WATER_SIM_DIR");
+
+	snprintf(buf, len, "%s/%s", dir ? dir : ".", name);
+	return buf;
+}
+
+int sim_http_port(void)
+{
+	const char *port = getenv("WATER_SIM_PORT");
+
+	return port ? atoi(port) : 8080;
+}
+
+uint32_t esp_log_timestamp(void)
+{
+	return esp_timer_get_time() / 1000;
+}
+
+void esp_log_write(char level, const char *tag, const char *format, ...)
+{
+	va_list args;
+
+	pthread_mutex_lock(&log_lock);
+	printf("%c (%u) %s: ", level, esp_log_timestamp(), tag);
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+	printf("\n");
+	fflush(stdout);
+	pthread_mutex_unlock(&log_lock);
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+	switch (code)
+	{
+	case ESP_OK: return "ESP_OK";
+	case ESP_FAIL: return "ESP_FAIL";
+	case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+	case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+	case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+	case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+	case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+	case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+	case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+	case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+	}
+	return "UNKNOWN ERROR";
+}
+
+/*
+	A reboot starts the process again so that everything is reloaded from
+	the simulated flash
+*/
+void esp_restart(void)
+{
+	ESP_LOGI("sim", "Restarting");
+	fflush(stdout);
+	execv("/proc/self/exe", sim_argv);
+	perror("execv");
+	exit(1);
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+	// the ESP8266 has about 80KB of heap - report what would be left of it
+	struct mallinfo2 info = mallinfo2();
+	uint32_t free_heap = info.uordblks > 80 * 1024 ? 0 : 80 * 1024 - info.uordblks;
+
+	if (free_heap < min_free_heap)
+		min_free_heap = free_heap;
+	return free_heap;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+	esp_get_free_heap_size();
+	return min_free_heap;
+}
+
+uint32_t esp_random(void)
+{
+	uint32_t r;
+
+	if (getrandom(&r, sizeof(r), 0) != sizeof(r))
+		r = (uint32_t)rand();
+	return r;
+}
+
+esp_err_t esp_base_mac_addr_get(uint8_t *mac)
+{
+	memcpy(mac, base_mac, sizeof(base_mac));
+	return ESP_OK;
+}
+
+esp_err_t esp_base_mac_addr_set(uint8_t *mac)
+{
+	memcpy(base_mac, mac, sizeof(base_mac));
+	return ESP_OK;
+}
+
+esp_err_t esp_efuse_mac_get_default(uint8_t *mac)
+{
+	memcpy(mac, base_mac, sizeof(base_mac));
+	return ESP_OK;
+}
+
+int main(int argc, char *argv[])
+{
+	sim_argv = argv;
+	setvbuf(stdout, NULL, _IOLBF, 0);
+
+	ESP_LOGI("sim", "Watering system simulator - web server on http://localhost:%u/", sim_http_port());
+	app_main();
+	sim_gpio_sync();
+
+	// app_main() returns once everything is set up; the tasks keep running
+	while (1)
+		pause();
+	return 0;
+}
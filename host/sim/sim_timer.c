@@ -0,0 +1,170 @@
+/*
+	esp_timer: all callbacks are dispatched from one thread, like the
+	ESP_TIMER_TASK on the device. Starting a timer that is already running
+	re-arms it, as the ESP8266 implementation does.
+*/
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include "esp_timer.h"
+#include "sim.h"
+
+struct esp_timer
+{
+	esp_timer_cb_t callback;
+	void *arg;
+	bool armed;
+	int64_t expiry;
+	uint64_t period;
+	struct esp_timer *next;
+};
+
+static pthread_mutex_t timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timer_cond;
+static pthread_t timer_thread;
+static bool timer_thread_started;
+static struct esp_timer *timers;
+static int64_t start_time;
+
+static int64_t monotonic_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t esp_timer_get_time(void)
+{
+	if (!start_time)
+		start_time = monotonic_us();
+	return monotonic_us() - start_time;
+}
+
+static void *timer_task(void *p)
+{
+	pthread_mutex_lock(&timer_lock);
+	while (1)
+	{
+		struct esp_timer *t, *first = NULL;
+		int64_t now = esp_timer_get_time();
+
+		for (t = timers; t; t = t->next)
+			if (t->armed && (!first || t->expiry < first->expiry))
+				first = t;
+
+		if (!first)
+		{
+			pthread_cond_wait(&timer_cond, &timer_lock);
+			continue;
+		}
+
+		if (first->expiry > now)
+		{
+			struct timespec ts;
+			int64_t wake = monotonic_us() + (first->expiry - now);
+
+			ts.tv_sec = wake / 1000000;
+			ts.tv_nsec = (wake % 1000000) * 1000;
+			pthread_cond_timedwait(&timer_cond, &timer_lock, &ts);
+			continue;
+		}
+
+		if (first->period)
+			first->expiry += first->period;
+		else
+			first->armed = false;
+
+		pthread_mutex_unlock(&timer_lock);
+		first->callback(first->arg);
+		sim_gpio_sync();
+		pthread_mutex_lock(&timer_lock);
+	}
+	return NULL;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+	struct esp_timer *t = calloc(1, sizeof(*t));
+
+	if (!t)
+		return ESP_ERR_NO_MEM;
+	t->callback = create_args->callback;
+	t->arg = create_args->arg;
+
+	pthread_mutex_lock(&timer_lock);
+	if (!timer_thread_started)
+	{
+		pthread_condattr_t attr;
+
+		pthread_condattr_init(&attr);
+		pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+		pthread_cond_init(&timer_cond, &attr);
+		pthread_create(&timer_thread, NULL, timer_task, NULL);
+		timer_thread_started = true;
+	}
+	t->next = timers;
+	timers = t;
+	pthread_mutex_unlock(&timer_lock);
+
+	*out_handle = t;
+	return ESP_OK;
+}
+
+static esp_err_t timer_arm(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period)
+{
+	if (!timer)
+		return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&timer_lock);
+	timer->expiry = esp_timer_get_time() + timeout_us;
+	timer->period = period;
+	timer->armed = true;
+	pthread_cond_signal(&timer_cond);
+	pthread_mutex_unlock(&timer_lock);
+	return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+	return timer_arm(timer, timeout_us, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+	return timer_arm(timer, period, period);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+	esp_err_t err = ESP_OK;
+
+	if (!timer)
+		return ESP_ERR_INVALID_ARG;
+
+	pthread_mutex_lock(&timer_lock);
+	if (!timer->armed)
+		err = ESP_ERR_INVALID_STATE;
+	timer->armed = false;
+	pthread_mutex_unlock(&timer_lock);
+	return err;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+	struct esp_timer **p;
+
+	pthread_mutex_lock(&timer_lock);
+	for (p = &timers; *p; p = &(*p)->next)
+	{
+		if (*p == timer)
+		{
+			*p = timer->next;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&timer_lock);
+	free(timer);
+	return ESP_OK;
+}
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+#
+# Checks the JSON API of water_sim - out of range and malformed members
+# of a new event must be refused, not wrapped into the 8 bit fields of
+# the event. Run by ctest:
+#
+#   api_test.py <water_sim> <scratch dir>
+import sys
+
+sys.dont_write_bytecode = True
+from sim import Sim
+
+GOOD = {'zone': 0, 'hour': 7, 'minute': 30, 'days': 42, 'skip': 0, 'duration': 60}
+
+BAD = [
+	{'hour': 24},
+	{'hour': 256},
+	{'minute': 60},
+	{'minute': 300},
+	{'days': 128},
+	{'days': 256},
+	{'skip': 256},
+	{'zone': 99},
+	{'zone': 256},
+	{'duration': 86401},
+	{'duration': 4294967356},
+	{'hour': 99999999999999999999999},
+	{'hour': -1},
+	{'hour': '7x'},
+	{'hour': ''},
+	{'minute': 1.5},
+]
+
+
+def main():
+	if len(sys.argv) != 3:
+		sys.exit('usage: api_test.py <water_sim> <scratch dir>')
+	failed = 0
+
+	with Sim(sys.argv[1], sys.argv[2]) as sim:
+		for change in BAD:
+			status, body = sim.json('POST', '/api/events', dict(GOOD, **change))
+			if status != 400:
+				print('%s: %u %s, expected 400' % (change, status, body))
+				failed += 1
+		status, body = sim.json('GET', '/api/events')
+		if body['events']:
+			print('refused events were added: %s' % body['events'])
+			failed += 1
+
+		# the limits themselves are fine
+		for change in ({'hour': 23, 'minute': 59, 'days': 127}, {'skip': 255}, {'duration': 86400}, {}):
+			status, body = sim.json('POST', '/api/events', dict(GOOD, **change))
+			if status != 201:
+				print('%s: %u %s, expected 201' % (change, status, body))
+				failed += 1
+		status, body = sim.json('GET', '/api/events')
+		events = body['events']
+		if len(events) != 4 or events[0]['hour'] != 23 or events[0]['days'] != 0 or events[1]['skip'] != 255:
+			print('unexpected events: %s' % events)
+			failed += 1
+
+	if failed:
+		sys.exit('%u checks failed' % failed)
+	print('%u bad events refused' % len(BAD))
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+#
+# Firmware updates of water_sim from tools/ota_server.py over a bad link:
+# a download that keeps being cut off is resumed, one cut off by a
+# reboot goes on from what was kept in flash, a file that changed in the
+# meantime is fetched again, and only an image that matches its SHA-256
+# manifest is booted. Run by ctest:
+#
+#   ota_test.py <water_sim> <ota_server.py> <scratch dir>
+import hashlib
+import os
+import shutil
+import socket
+import subprocess
+import sys
+import time
+import urllib.parse
+
+sys.dont_write_bytecode = True
+from sim import Sim, free_port
+
+IMAGE_SIZE = 300 * 1024
+SAVE_EVERY = 64 * 1024		# OTA_SAVE_EVERY in main/ota.c
+
+
+class Server:
+	def __init__(self, script, directory, *args):
+		self.port = free_port()
+		self.log = open(directory + '.log', 'w')
+		self.proc = subprocess.Popen([sys.executable, script, '--port', str(self.port)] + list(args) + [directory],
+			stdout=self.log, stderr=subprocess.STDOUT)
+		for _ in range(100):
+			try:
+				socket.create_connection(('127.0.0.1', self.port), timeout=1).close()
+				return
+			except OSError:
+				time.sleep(0.1)
+		self.close()
+		raise RuntimeError('ota_server.py didn\'t start - see %s.log' % directory)
+
+	def close(self):
+		self.proc.kill()
+		self.proc.wait()
+		self.log.close()
+
+
+def make_image(directory, seed, digest=None):
+	# only the first byte has to look like an app image
+	image = b'\xe9' + hashlib.shake_256(seed).digest(IMAGE_SIZE - 1)
+	with open(os.path.join(directory, 'water.bin'), 'wb') as f:
+		f.write(image)
+	with open(os.path.join(directory, 'water.bin.sha256'), 'w') as f:
+		f.write('%s  water.bin\n' % (digest or hashlib.sha256(image).hexdigest()))
+	return image
+
+
+def start_update(sim, port):
+	url = 'http://127.0.0.1:%u/water.bin' % port
+	status, _ = sim.request('GET', '/?action=set_upgrade&url=' + urllib.parse.quote(url, safe=''))
+	if status != 200:
+		raise AssertionError('set_upgrade answered %d' % status)
+	status, _ = sim.request('GET', '/?action=update_fw')
+	if status != 200:
+		raise AssertionError('update_fw answered %d' % status)
+
+
+# polls /ota/status until 'until' is true of it, or the update ends
+def wait(sim, until=lambda ota: False, timeout=60):
+	end = time.time() + timeout
+	while time.time() < end:
+		_, ota = sim.json('GET', '/ota/status')
+		if until(ota) or ota['state'] in ('done', 'failed'):
+			return ota
+		time.sleep(0.05)
+	raise AssertionError('the update is still %s after %d s' % (ota['state'], timeout))
+
+
+def in_flash(sim, image):
+	with open(os.path.join(sim.dir, 'flash_ota_1.bin'), 'rb') as f:
+		return f.read(len(image)) == image
+
+
+def booted(sim):
+	try:
+		with open(os.path.join(sim.dir, 'otadata')) as f:
+			return f.read().strip() == 'ota_1'
+	except FileNotFoundError:
+		return False
+
+
+def check(name, ok, sim):
+	if not ok:
+		print('FAIL %s - see %s/sim.log' % (name, sim.dir))
+	return 0 if ok else 1
+
+
+def dropped(exe, server, scratch):
+	os.makedirs(scratch + '/www')
+	image = make_image(scratch + '/www', b'dropped')
+	srv = Server(server, scratch + '/www', '--drop', str(100 * 1024))
+	try:
+		with Sim(exe, scratch + '/sim') as sim:
+			start_update(sim, srv.port)
+			ota = wait(sim)
+			return check('dropped', ota['state'] == 'done' and ota['verified'] and ota['resumes'] >= 2
+				and in_flash(sim, image) and booted(sim), sim)
+	finally:
+		srv.close()
+
+
+def rebooted(exe, server, scratch, change):
+	os.makedirs(scratch + '/www')
+	image = make_image(scratch + '/www', b'rebooted')
+	srv = Server(server, scratch + '/www', '--rate', str(100 * 1024))
+	try:
+		with Sim(exe, scratch + '/sim') as sim:
+			start_update(sim, srv.port)
+			ota = wait(sim, lambda ota: ota['written'] >= 2 * SAVE_EVERY)
+			if ota['state'] != 'downloading':
+				return check('rebooted: cut off halfway', False, sim)
+			sim.restart()
+
+			if change:
+				# same size, but a new ETag
+				time.sleep(0.01)
+				image = make_image(scratch + '/www', b'changed')
+			start_update(sim, srv.port)
+			ota = wait(sim)
+			resumed = ota['resumed_from'] == 0 if change else ota['resumed_from'] >= SAVE_EVERY
+			log = sim.log_text()
+			logged = 'has changed since' in log if change else 'Resuming at' in log
+			return check('changed' if change else 'rebooted', ota['state'] == 'done' and ota['verified']
+				and resumed and logged and in_flash(sim, image) and booted(sim), sim)
+	finally:
+		srv.close()
+
+
+def bad_digest(exe, server, scratch):
+	os.makedirs(scratch + '/www')
+	make_image(scratch + '/www', b'bad', digest='0' * 64)
+	srv = Server(server, scratch + '/www', '--drop', str(100 * 1024))
+	try:
+		with Sim(exe, scratch + '/sim') as sim:
+			start_update(sim, srv.port)
+			ota = wait(sim)
+			return check('bad digest', ota['state'] == 'failed' and not ota['verified']
+				and 'doesn\'t match its manifest' in sim.log_text() and not booted(sim), sim)
+	finally:
+		srv.close()
+
+
+def main():
+	if len(sys.argv) != 4:
+		sys.exit('usage: ota_test.py <water_sim> <ota_server.py> <scratch dir>')
+	exe, server, scratch = sys.argv[1:]
+	shutil.rmtree(scratch, ignore_errors=True)
+
+	failed = dropped(exe, server, scratch + '/dropped')
+	failed += rebooted(exe, server, scratch + '/rebooted', False)
+	failed += rebooted(exe, server, scratch + '/changed', True)
+	failed += bad_digest(exe, server, scratch + '/bad')
+	if failed:
+		sys.exit('%u cases failed' % failed)
+	print('4 updates went as expected')
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+#
+# Makes updates with tools/mkdelta.py and applies them with ota_patch,
+# the firmware's decoder, checking that each rebuilds the image byte for
+# byte. Run by ctest:
+#
+#   patch_test.py <ota_patch> <mkdelta.py> <scratch dir>
+#
+# The images are a host binary and an edited copy of it - code moved,
+# bytes changed, inserted and removed - like two builds of the firmware.
+import os
+import random
+import subprocess
+import sys
+
+
+def edit(image, rng):
+	out = bytearray(image)
+	for _ in range(20):
+		pos = rng.randrange(len(out))
+		kind = rng.randrange(3)
+		if kind == 0:
+			out[pos:pos + 16] = bytes(rng.randrange(256) for _ in range(16))
+		elif kind == 1:
+			out[pos:pos] = bytes(rng.randrange(256) for _ in range(rng.randrange(1, 200)))
+		else:
+			del out[pos:pos + rng.randrange(1, 200)]
+	# a block moved, as a linker does when a function grows
+	start = rng.randrange(len(out) // 2)
+	block = out[start:start + 4096]
+	del out[start:start + 4096]
+	out[len(out) // 2:len(out) // 2] = block
+	return bytes(out)
+
+
+def run(*args):
+	result = subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+	if result.returncode:
+		sys.exit('%s failed:\n%s' % (' '.join(args), result.stdout.decode(errors='replace')))
+
+
+def check(ota_patch, mkdelta, scratch, name, base, image):
+	base_path = os.path.join(scratch, name + '-base.bin')
+	image_path = os.path.join(scratch, name + '.bin')
+	patch_path = os.path.join(scratch, name + '.wpt')
+	out_path = os.path.join(scratch, name + '-out.bin')
+	with open(base_path, 'wb') as f:
+		f.write(base)
+	with open(image_path, 'wb') as f:
+		f.write(image)
+
+	if base:
+		run(sys.executable, mkdelta, '--base', base_path, image_path, patch_path)
+	else:
+		run(sys.executable, mkdelta, image_path, patch_path)
+	run(ota_patch, base_path if base else os.devnull, patch_path, out_path)
+
+	with open(out_path, 'rb') as f:
+		out = f.read()
+	if out != image:
+		diff = next((i for i in range(min(len(out), len(image))) if out[i] != image[i]), min(len(out), len(image)))
+		sys.exit('%s: %u bytes rebuilt, %u expected, first difference at %u' % (name, len(out), len(image), diff))
+	print('%s: %u bytes from a %u byte patch' % (name, len(image), os.path.getsize(patch_path)))
+
+
+def main():
+	if len(sys.argv) != 4:
+		sys.exit('usage: patch_test.py <ota_patch> <mkdelta.py> <scratch dir>')
+	ota_patch, mkdelta, scratch = sys.argv[1:]
+	os.makedirs(scratch, exist_ok=True)
+	rng = random.Random(1)
+
+	with open(ota_patch, 'rb') as f:
+		base = f.read()[:96 * 1024]
+	image = edit(base, rng)
+
+	check(ota_patch, mkdelta, scratch, 'delta', base, image)
+	check(ota_patch, mkdelta, scratch, 'full', b'', image)
+	check(ota_patch, mkdelta, scratch, 'same', base, base)
+	check(ota_patch, mkdelta, scratch, 'random', base, bytes(rng.randrange(256) for _ in range(8192)))
+
+
+if __name__ == '__main__':
+	main()
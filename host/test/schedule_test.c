@@ -0,0 +1,238 @@
+/*
+	Tests of the schedule calculations against a fake clock, in the
+	Pacific timezone so the DST changes of 2024 can be checked.
+
+	ctest --test-dir build-host
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "schedule.h"
+
+#define SUNDAY (1 << 0)
+#define MONDAY (1 << 1)
+#define WEDNESDAY (1 << 3)
+#define SATURDAY (1 << 6)
+
+static unsigned int failures;
+static time_t fake_now;		// the clock the tests move forward
+
+#define CHECK_TIME(what, got, expect) check_time(__LINE__, what, got, expect)
+
+static void check_time(int line, const char *what, time_t got, time_t expect)
+{
+	char g[32] = "never", e[32] = "never";
+	struct tm tm;
+
+	if (got == expect)
+		return;
+	if (got != SCHEDULE_NEVER)
+		strftime(g, sizeof(g), "%a %F %R %Z", localtime_r(&got, &tm));
+	if (expect != SCHEDULE_NEVER)
+		strftime(e, sizeof(e), "%a %F %R %Z", localtime_r(&expect, &tm));
+	fprintf(stderr, "line %d: %s: got %s, expected %s\n", line, what, g, e);
+	failures++;
+}
+
+// a local time, with mktime() working out whether DST is in force
+static time_t local(int year, int month, int day, int hour, int minute)
+{
+	struct tm tm = { 0 };
+
+	tm.tm_year = year - 1900;
+	tm.tm_mon = month - 1;
+	tm.tm_mday = day;
+	tm.tm_hour = hour;
+	tm.tm_min = minute;
+	tm.tm_isdst = -1;
+	return mktime(&tm);
+}
+
+static water_event daily(int hour, int minute, uint8_t days)
+{
+	water_event event = { .enabled = true, .hour = hour, .minute = minute, .days = days, .duration = 60 };
+
+	return event;
+}
+
+static void test_weekdays(void)
+{
+	water_event event = daily(6, 30, MONDAY | WEDNESDAY);
+
+	// Sunday 2 June 2024
+	fake_now = local(2024, 6, 2, 12, 0);
+	CHECK_TIME("Monday", fake_now = schedule_event_next(&event, fake_now), local(2024, 6, 3, 6, 30));
+	CHECK_TIME("Wednesday", fake_now = schedule_event_next(&event, fake_now), local(2024, 6, 5, 6, 30));
+	CHECK_TIME("next week", fake_now = schedule_event_next(&event, fake_now), local(2024, 6, 10, 6, 30));
+
+	// later on the same day, and a minute too late for it
+	event = daily(6, 30, SUNDAY);
+	CHECK_TIME("later today", schedule_event_next(&event, local(2024, 6, 2, 6, 29)), local(2024, 6, 2, 6, 30));
+	CHECK_TIME("just missed", schedule_event_next(&event, local(2024, 6, 2, 6, 30)), local(2024, 6, 9, 6, 30));
+
+	// every day of the week is the same as none
+	event = daily(6, 30, 0x7F);
+	CHECK_TIME("all days", schedule_event_next(&event, local(2024, 6, 2, 12, 0)), local(2024, 6, 3, 6, 30));
+}
+
+static void test_rollovers(void)
+{
+	water_event event = daily(23, 30, 0);
+
+	CHECK_TIME("day", schedule_event_next(&event, local(2024, 6, 2, 23, 45)), local(2024, 6, 3, 23, 30));
+	CHECK_TIME("month", schedule_event_next(&event, local(2024, 6, 30, 23, 45)), local(2024, 7, 1, 23, 30));
+	CHECK_TIME("year", schedule_event_next(&event, local(2024, 12, 31, 23, 45)), local(2025, 1, 1, 23, 30));
+	CHECK_TIME("leap day", schedule_event_next(&event, local(2024, 2, 28, 23, 45)), local(2024, 2, 29, 23, 30));
+
+	event = daily(0, 0, 0);
+	CHECK_TIME("midnight", schedule_event_next(&event, local(2024, 6, 2, 23, 59)), local(2024, 6, 3, 0, 0));
+
+	// Saturday night to Sunday morning crosses the week
+	event = daily(0, 15, SUNDAY);
+	CHECK_TIME("week", schedule_event_next(&event, local(2024, 6, 1, 23, 0)), local(2024, 6, 2, 0, 15));
+	event = daily(8, 0, SATURDAY);
+	CHECK_TIME("back to Saturday", schedule_event_next(&event, local(2024, 6, 2, 9, 0)), local(2024, 6, 8, 8, 0));
+}
+
+static void test_skip(void)
+{
+	water_event event = { .enabled = true, .skip = 60, .duration = 10 };
+	time_t hour = local(2024, 6, 2, 13, 0);
+
+	// on every whole multiple of 'skip', across the hour
+	CHECK_TIME("skip", schedule_event_next(&event, hour - 61), hour - 60);
+	CHECK_TIME("skip hour", schedule_event_next(&event, hour - 1), hour);
+	CHECK_TIME("skip exact", schedule_event_next(&event, hour), hour + 60);
+
+	event.skip = 250;
+	fake_now = 1000;
+	for (unsigned int i = 1; i <= 4; i++)
+		CHECK_TIME("skip count", fake_now = schedule_event_next(&event, fake_now), 1000 + i * 250);
+}
+
+static void test_dst(void)
+{
+	water_event event = daily(6, 0, 0);
+	time_t before;
+
+	// spring forward on 10 March 2024: the day is 23 hours long
+	before = local(2024, 3, 9, 6, 0);
+	CHECK_TIME("spring", schedule_event_next(&event, before), before + 23 * 3600);
+
+	// fall back on 3 November 2024: 25 hours
+	before = local(2024, 11, 2, 6, 0);
+	CHECK_TIME("fall", schedule_event_next(&event, before), before + 25 * 3600);
+
+	// 02:30 doesn't exist on 10 March - it still fires that day, after 02:00
+	event = daily(2, 30, 0);
+	before = local(2024, 3, 10, 1, 0);
+	{
+		time_t t = schedule_event_next(&event, before);
+		struct tm tm;
+
+		localtime_r(&t, &tm);
+		if (t <= before || tm.tm_mday != 10 || tm.tm_hour < 2)
+		{
+			fprintf(stderr, "line %d: the missing 02:30 fired at %s", __LINE__, asctime(&tm));
+			failures++;
+		}
+	}
+
+	// 01:30 happens twice on 3 November, the event fires once
+	event = daily(1, 30, 0);
+	before = local(2024, 11, 3, 0, 0);
+	fake_now = schedule_event_next(&event, before);
+	CHECK_TIME("repeated hour, then the next day", schedule_event_next(&event, fake_now), local(2024, 11, 4, 1, 30));
+}
+
+static void test_empty(void)
+{
+	water_event events[2] = { daily(6, 0, 0), daily(7, 0, 0) };
+	schedule_store store;
+
+	fake_now = local(2024, 6, 2, 12, 0);
+	CHECK_TIME("no events", schedule_next(events, 0, fake_now), SCHEDULE_NEVER);
+
+	events[0].enabled = false;
+	events[1].enabled = false;
+	CHECK_TIME("disabled", schedule_event_next(&events[0], fake_now), SCHEDULE_NEVER);
+	CHECK_TIME("all disabled", schedule_next(events, 2, fake_now), SCHEDULE_NEVER);
+
+	schedule_init(&store);
+	CHECK_TIME("empty store", schedule_peek(&store, NULL), SCHEDULE_NEVER);
+}
+
+/*
+	A week of a mixed schedule, run by the store on the fake clock, fires
+	in the same order as scanning the events does
+*/
+static void test_store(void)
+{
+	water_event events[] =
+	{
+		daily(6, 30, MONDAY | WEDNESDAY),
+		daily(23, 59, 0),
+		daily(0, 0, SUNDAY | SATURDAY),
+		{ .enabled = true, .skip = 240, .duration = 30 },
+		daily(12, 0, 0),
+	};
+	const unsigned int count = sizeof(events) / sizeof(events[0]);
+	time_t start = local(2024, 6, 2, 0, 0);
+	time_t end = local(2024, 6, 9, 0, 0);
+	schedule_store store;
+	unsigned int fired = 0;
+
+	fake_now = start;
+	schedule_init(&store);
+	for (unsigned int i = 0; i < count; i++)
+		schedule_add(&store, &events[i], fake_now);
+
+	while (fake_now < end)
+	{
+		time_t expect = schedule_next(events, count, fake_now);
+
+		CHECK_TIME("store", schedule_peek(&store, NULL), expect);
+		if (failures)
+			return;
+		fake_now = expect;
+		// events due at the same time each fire
+		while (schedule_peek(&store, NULL) == fake_now)
+		{
+			schedule_fired(&store);
+			fired++;
+		}
+	}
+	// and each event as many times as it does on its own
+	for (unsigned int i = 0; i < count; i++)
+	{
+		for (time_t t = schedule_event_next(&events[i], start); t <= fake_now; t = schedule_event_next(&events[i], t))
+			fired--;
+	}
+	if (fired)
+	{
+		fprintf(stderr, "store: %d events fired too many\n", (int)fired);
+		failures++;
+	}
+}
+
+int main(void)
+{
+	setenv("TZ", "PST8PDT,M3.2.0,M11.1.0", 1);
+	tzset();
+
+	test_weekdays();
+	test_rollovers();
+	test_skip();
+	test_dst();
+	test_empty();
+	test_store();
+
+	if (failures)
+	{
+		fprintf(stderr, "%u failed\n", failures);
+		return 1;
+	}
+	printf("schedule: all passed\n");
+	return 0;
+}
@@ -0,0 +1,80 @@
+#
+# Runs ./build-host/water_sim for the tests in this directory. Each run
+# gets a free port and an empty flash directory of its own, so ctest can
+# run the tests side by side:
+#
+#   with Sim(path_to_water_sim, scratch_dir) as sim:
+#       status, body = sim.request('GET', '/api/config')
+#
+import json
+import os
+import shutil
+import socket
+import subprocess
+import time
+import urllib.error
+import urllib.request
+
+
+def free_port():
+	with socket.socket() as s:
+		s.bind(('127.0.0.1', 0))
+		return s.getsockname()[1]
+
+
+class Sim:
+	def __init__(self, exe, scratch, env=None):
+		self.exe = exe
+		self.dir = scratch
+		self.port = free_port()
+		self.env = dict(os.environ, WATER_SIM_PORT=str(self.port), WATER_SIM_DIR=self.dir, **(env or {}))
+		self.url = 'http://127.0.0.1:%u' % self.port
+
+	def __enter__(self):
+		shutil.rmtree(self.dir, ignore_errors=True)
+		os.makedirs(self.dir)
+		self.log = open(os.path.join(self.dir, 'sim.log'), 'w')
+		self.start()
+		return self
+
+	def __exit__(self, *exc):
+		self.proc.kill()
+		self.proc.wait()
+		self.log.close()
+
+	def start(self):
+		self.proc = subprocess.Popen([self.exe], env=self.env, stdout=self.log, stderr=subprocess.STDOUT)
+		for _ in range(100):
+			try:
+				self.request('GET', '/api/config')
+				return
+			except OSError:
+				time.sleep(0.1)
+		self.__exit__(None, None, None)
+		raise RuntimeError('water_sim didn\'t start - see %s/sim.log' % self.dir)
+
+	# pulls the plug - what is in flash and NVS stays for the next start
+	def restart(self):
+		self.proc.kill()
+		self.proc.wait()
+		self.start()
+
+	def request(self, method, path, body=None):
+		if isinstance(body, (dict, list)):
+			body = json.dumps(body).encode()
+		elif isinstance(body, str):
+			body = body.encode()
+		req = urllib.request.Request(self.url + path, data=body, method=method)
+		try:
+			with urllib.request.urlopen(req, timeout=10) as r:
+				return r.status, r.read()
+		except urllib.error.HTTPError as e:
+			return e.code, e.read()
+
+	def json(self, method, path, body=None):
+		status, data = self.request(method, path, body)
+		return status, json.loads(data) if data else None
+
+	def log_text(self):
+		with open(os.path.join(self.dir, 'sim.log'), errors='replace') as f:
+			return f.read()
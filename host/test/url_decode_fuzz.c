@@ -0,0 +1,69 @@
+/*
+	libFuzzer target for url_decode(). The first byte of the input picks
+	the size of the output buffer and the rest is decoded, both into that
+	buffer and in place. Each buffer is allocated at its exact size so
+	AddressSanitizer catches a write past it.
+
+	./build-host/url_decode_fuzz [corpus dir] [-runs=N]
+
+	Only built when the compiler has -fsanitize=fuzzer (clang).
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "query.h"
+
+#define CHECK(cond) do { if (!(cond)) abort(); } while (0)
+
+// what a successful or short decode must have left in 'dst'
+static void check_result(const char *dst, size_t size, int n, size_t len)
+{
+	if (n >= 0)
+	{
+		CHECK((size_t)n < size);
+		CHECK((size_t)n <= len);
+		CHECK(dst[n] == '\0');
+	}
+	else
+	{
+		CHECK(n == -1);
+		CHECK(size == 0 || dst[size - 1] == '\0');
+	}
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	const char *src;
+	size_t len, dst_size;
+	char *dst, *buf;
+	int n, m;
+
+	if (size == 0)
+		return 0;
+	src = (const char *)data + 1;
+	len = size - 1;
+
+	// from no room at all to more than any decode needs
+	dst_size = data[0] % (len + 2);
+	dst = malloc(dst_size ? dst_size : 1);
+	n = url_decode(dst, dst_size, src, len);
+	check_result(dst, dst_size, n, len);
+	CHECK(dst_size > 0 || n == -1);
+
+	// in place with room for the terminator, which always fits
+	buf = malloc(len + 1);
+	memcpy(buf, src, len);
+	m = url_decode(buf, len + 1, buf, len);
+	check_result(buf, len + 1, m, len);
+	CHECK(m >= 0);
+
+	// a short decode keeps what fitted, which is the start of the whole one
+	if (n >= 0)
+		CHECK(n == m && memcmp(dst, buf, n + 1) == 0);
+	else if (dst_size > 0)
+		CHECK(memcmp(dst, buf, dst_size - 1) == 0);
+
+	free(buf);
+	free(dst);
+	return 0;
+}
@@ -0,0 +1,95 @@
+/*
+	Applies an update made by tools/mkdelta.py with the firmware's own
+	decoder, in the same small pieces the device uses, so the result can
+	be compared with the image the patch was made from.
+
+	./build-host/ota_patch <base> <patch> <image>
+
+	The base is only read for a delta - pass /dev/null for a compressed
+	image.
+*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "patch.h"
+
+#define IN_CHUNK 1000		// odd sizes so commands are split between calls
+#define OUT_CHUNK 2048
+
+// the decoder's messages, without the rest of the simulator
+void esp_log_write(char level, const char *tag, const char *format, ...)
+{
+	va_list args;
+
+	fprintf(stderr, "%c %s: ", level, tag);
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+
+static esp_err_t read_base(void *ctx, size_t offset, void *buf, size_t len)
+{
+	FILE *base = ctx;
+
+	if (fseek(base, offset, SEEK_SET) != 0 || fread(buf, 1, len, base) != len)
+		return ESP_FAIL;
+	return ESP_OK;
+}
+
+int main(int argc, char *argv[])
+{
+	static patch_state p;
+	uint8_t in[IN_CHUNK], out[OUT_CHUNK];
+	FILE *base, *patch, *image;
+	size_t in_len;
+	esp_err_t err;
+
+	if (argc != 4)
+	{
+		fprintf(stderr, "usage: %s <base> <patch> <image>\n", argv[0]);
+		return 2;
+	}
+	base = fopen(argv[1], "rb");
+	patch = fopen(argv[2], "rb");
+	image = fopen(argv[3], "wb");
+	if (!base || !patch || !image)
+	{
+		perror("open");
+		return 2;
+	}
+
+	patch_init(&p, read_base, base);
+	while ((in_len = fread(in, 1, sizeof(in), patch)) > 0)
+	{
+		size_t pos = 0;
+
+		// a copy may go on after the input is used up, until 'out' isn't filled
+		while (1)
+		{
+			size_t used;
+			int n = patch_run(&p, in + pos, in_len - pos, &used, out, sizeof(out));
+
+			if (n < 0)
+			{
+				fprintf(stderr, "patch failed (0x%x)\n", (int)p.err);
+				return 1;
+			}
+			fwrite(out, 1, n, image);
+			pos += used;
+			if (pos == in_len && n < (int)sizeof(out))
+				break;
+		}
+	}
+
+	err = patch_finish(&p);
+	fclose(image);
+	if (err != ESP_OK)
+	{
+		fprintf(stderr, "patch failed (0x%x)\n", (int)err);
+		return 1;
+	}
+	printf("%s: %u bytes\n", argv[3], p.written);
+	return 0;
+}
@@ -0,0 +1,34 @@
+// Generated by tools/gen_action_hash.py from the actions[] table in main.c - do not edit
+#ifndef _ACTION_HASH_H
+#define _ACTION_HASH_H
+
+#include <stdint.h>
+
+#define ACTION_HASH_SEED 0x811C9E8Du
+#define ACTION_HASH_BITS 4
+#define ACTION_HASH_COUNT 11		// entries in actions[]
+#define ACTION_HASH_EMPTY 0xFF
+#define ACTION_HASH_BUCKET(hash) ((hash) >> (32 - ACTION_HASH_BITS))
+
+// index in actions[] for each bucket
+static const uint8_t action_hash[1 << ACTION_HASH_BITS] =
+{
+	0,		// water_on
+	2,		// add_event
+	3,		// del_event
+	7,		// set_time
+	ACTION_HASH_EMPTY,
+	ACTION_HASH_EMPTY,
+	ACTION_HASH_EMPTY,
+	1,		// water_off
+	9,		// set_upgrade
+	ACTION_HASH_EMPTY,
+	ACTION_HASH_EMPTY,
+	4,		// update_fw
+	8,		// set_wifi
+	6,		// set_ntp
+	10,		// check_update
+	5,		// set_hostname
+};
+
+#endif // _ACTION_HASH_H
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include "asset.h"
+#include "query.h"
+
+#define ASSET_ETAG_SEED 0x811C9DC5u		// FNV-1a offset basis
+
+// longest If-None-Match that is checked - a browser sends one ETag back
+#define MAX_IF_NONE_MATCH 64
+// longest Accept-Encoding that is read, longer lists are cut short
+#define MAX_ACCEPT_ENCODING 128
+
+bool asset_not_modified(httpd_req_t *req, const char *etag, const char *cache)
+{
+	char match[MAX_IF_NONE_MATCH];
+
+	httpd_resp_set_hdr(req, "ETag", etag);
+	httpd_resp_set_hdr(req, "Cache-Control", cache);
+
+	if (httpd_req_get_hdr_value_str(req, "If-None-Match", match, sizeof(match)) != ESP_OK)
+		return false;
+	if (!strstr(match, etag) && strcmp(match, "*") != 0)
+		return false;
+
+	httpd_resp_set_status(req, "304 Not Modified");
+	httpd_resp_send(req, NULL, 0);
+	return true;
+}
+
+// the parameters of an encoding have "q=0", "q=0.00" or the like
+static bool q_is_zero(const char *params)
+{
+	const char *q = strstr(params, "q=");
+
+	if (!q || q[2] != '0')
+		return false;
+	q += 2 + strspn(q + 2, "0.");
+	return *q == '\0' || *q == ' ' || *q == '\t' || *q == ';';
+}
+
+/*
+	Is "gzip" (or "*") in Accept-Encoding, and not with a q of 0? Without
+	the header only the identity encoding is safe - that is what curl and
+	other simple clients expect.
+*/
+bool asset_accepts_gzip(httpd_req_t *req)
+{
+	char accept[MAX_ACCEPT_ENCODING];
+	char *p = accept;
+	esp_err_t err;
+
+	httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+	err = httpd_req_get_hdr_value_str(req, "Accept-Encoding", accept, sizeof(accept));
+	if (err != ESP_OK && err != ESP_ERR_HTTPD_RESULT_TRUNC)
+		return false;
+
+	while (*p)
+	{
+		size_t len = strcspn(p, ",");
+		char *next = p[len] ? p + len + 1 : p + len;
+
+		p[len] = '\0';
+		p += strspn(p, " \t");
+		len = strcspn(p, " \t;");
+		if (((len == 4 && strncasecmp(p, "gzip", 4) == 0) || (len == 1 && *p == '*')) && !q_is_zero(p + len))
+			return true;
+		p = next;
+	}
+	return false;
+}
+
+/*
+	A compressed asset is only kept gzipped, to save the flash - clients
+	that don't take gzip get a 406, as for the files of the UI bundle.
+*/
+esp_err_t asset_handler(httpd_req_t *req)
+{
+	static const char message[] = "Only available gzipped\n";
+	const asset *a = req->user_ctx;
+
+	if (a->gzip && !asset_accepts_gzip(req))
+	{
+		httpd_resp_set_status(req, "406 Not Acceptable");
+		httpd_resp_set_type(req, "text/plain");
+		return httpd_resp_send(req, message, sizeof(message) - 1);
+	}
+	if (asset_not_modified(req, a->etag, a->cache))
+		return ESP_OK;
+
+	httpd_resp_set_type(req, a->type);
+	if (a->gzip)
+		httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+	return httpd_resp_send(req, (const char*)a->data, a->size);
+}
+
+void asset_etag(char *etag, const char *const *values, unsigned int count)
+{
+	uint32_t hash = ASSET_ETAG_SEED;
+
+	// a separator keeps ("ab", "c") and ("a", "bc") apart
+	for (unsigned int i = 0; i < count; i++)
+		hash = query_hash("\x1f", query_hash(values[i], hash));
+	snprintf(etag, ASSET_ETAG_SIZE, "W/\"%08x\"", (unsigned int)hash);
+}
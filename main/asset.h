@@ -0,0 +1,44 @@
+#ifndef _ASSET_H
+#define _ASSET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <esp_http_server.h>
+
+#define ASSET_ETAG_SIZE 20		// room for a quoted ETag made by asset_etag()
+
+/*
+	A file that is built into the firmware, ready to send. The assets are
+	made from main/www by tools/mkassets.py (asset_data.h).
+*/
+typedef struct asset
+{
+	const char *type;			// Content-Type
+	const char *etag;			// quoted, changes when the content does
+	const char *cache;		// Cache-Control
+	bool gzip;					// 'data' is gzipped
+	const uint8_t *data;
+	size_t size;
+} asset;
+
+// URI handler - user_ctx is the asset
+esp_err_t asset_handler(httpd_req_t *req);
+
+/*
+	Sets the ETag and Cache-Control headers, which must stay valid until
+	the response is sent. If the client already has this version it gets
+	a 304 and true is returned - the handler has nothing more to send.
+*/
+bool asset_not_modified(httpd_req_t *req, const char *etag, const char *cache);
+
+/*
+	Does the client take a gzipped body? Only when it says so in
+	Accept-Encoding. Sets Vary, as the answer depends on it.
+*/
+bool asset_accepts_gzip(httpd_req_t *req);
+
+// a quoted ETag for a page made from 'count' strings
+void asset_etag(char *etag, const char *const *values, unsigned int count);
+
+#endif // _ASSET_H
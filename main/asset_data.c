@@ -0,0 +1,323 @@
+// Generated by tools/mkassets.py from main/www - do not edit
+#include "asset.h"
+#include "asset_data.h"
+
+// favicon.png: 4445 bytes
+static const uint8_t favicon_png_data[] =
+{
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20, 0x08, 0x02, 0x00, 0x00, 0x00, 0xfc, 0x18, 0xed,
+	0xa3, 0x00, 0x00, 0x09, 0xe9, 0x7a, 0x54, 0x58, 0x74, 0x52, 0x61, 0x77, 0x20, 0x70, 0x72, 0x6f,
+	0x66, 0x69, 0x6c, 0x65, 0x20, 0x74, 0x79, 0x70, 0x65, 0x20, 0x65, 0x78, 0x69, 0x66, 0x00, 0x00,
+	0x78, 0xda, 0xed, 0x98, 0x5b, 0x96, 0xe4, 0x36, 0x0e, 0x44, 0xff, 0xb9, 0x8a, 0x59, 0x02, 0x5f,
+	0xe0, 0x63, 0x39, 0x20, 0x41, 0x9e, 0x33, 0x3b, 0x98, 0xe5, 0xcf, 0x85, 0x32, 0xb3, 0xdc, 0xdd,
+	0x6e, 0xdb, 0xed, 0x33, 0xfe, 0x9c, 0x52, 0x67, 0x49, 0xa5, 0x94, 0x48, 0x02, 0x11, 0x08, 0x04,
+	0x3b, 0x9c, 0xff, 0xfc, 0xfb, 0x86, 0x7f, 0xf1, 0x93, 0x47, 0x6f, 0xa1, 0x4a, 0x1f, 0x6d, 0xb6,
+	0x16, 0xf9, 0xa9, 0xb3, 0xce, 0xac, 0x5c, 0x8c, 0xf8, 0xfa, 0x99, 0xcf, 0xef, 0x14, 0xeb, 0xf3,
+	0xfb, 0xf9, 0xc9, 0xef, 0xaf, 0xf8, 0xfb, 0xbb, 0xfb, 0xe1, 0xeb, 0x8b, 0xcc, 0xad, 0xc2, 0xb9,
+	0xbc, 0xfe, 0xec, 0xfa, 0x7e, 0x5e, 0xb9, 0x2f, 0xbf, 0xbd, 0xf0, 0x99, 0x23, 0xad, 0xef, 0xef,
+	0x87, 0xf1, 0xfe, 0x26, 0x8f, 0xf7, 0x40, 0x29, 0x7e, 0x37, 0x75, 0xf1, 0x99, 0xfd, 0xda, 0xbe,
+	0x5d, 0x24, 0xf7, 0xf3, 0xeb, 0x7e, 0xaa, 0xef, 0x81, 0xe6, 0x79, 0x5d, 0xb4, 0x39, 0xfa, 0xb7,
+	0x4b, 0x5d, 0xef, 0x81, 0xf6, 0xfb, 0xc1, 0x67, 0x29, 0xef, 0x4f, 0xde, 0xef, 0xa7, 0x3e, 0xe1,
+	0xf2, 0x77, 0xf8, 0xf6, 0x46, 0xed, 0x64, 0xc9, 0x84, 0x89, 0x4a, 0xce, 0xa7, 0xa4, 0x12, 0x9f,
+	0xdf, 0xe3, 0xb5, 0x82, 0xe2, 0x9f, 0x54, 0x94, 0x73, 0xe7, 0x77, 0x2e, 0x9d, 0xe7, 0x62, 0x99,
+	0x5c, 0xf3, 0x4c, 0x78, 0x7d, 0xf1, 0x1e, 0x8c, 0x84, 0x7c, 0x17, 0xde, 0xe7, 0x1c, 0xe3, 0xb7,
+	0x09, 0xfa, 0x2e, 0xc9, 0x9f, 0xab, 0xf0, 0x63, 0xf6, 0xbf, 0xae, 0x7e, 0x48, 0x7e, 0xd6, 0xf7,
+	0xfd, 0xf2, 0x43, 0x2e, 0xdb, 0x3b, 0x47, 0x5c, 0xfc, 0xf4, 0x8b, 0x24, 0x3f, 0xdc, 0x2f, 0x5f,
+	0xd3, 0xe4, 0x6f, 0x27, 0x2e, 0x5f, 0x2b, 0xca, 0xdf, 0x7f, 0xc1, 0x40, 0xfa, 0xbb, 0x70, 0xde,
+	0x9f, 0x7b, 0x6d, 0xdc, 0x7b, 0x5e, 0xd1, 0x69, 0x6d, 0x64, 0xb4, 0xbd, 0x19, 0x15, 0xc3, 0x27,
+	0x3b, 0xfe, 0x0e, 0x0f, 0x2e, 0x52, 0x5e, 0x9e, 0xd7, 0x1a, 0x47, 0xe7, 0x23, 0x5c, 0xf7, 0xe7,
+	0x98, 0x1c, 0x83, 0x69, 0x36, 0x90, 0x5b, 0xdc, 0x71, 0x71, 0xec, 0x34, 0x53, 0x06, 0x95, 0x1b,
+	0x52, 0x4d, 0x96, 0x34, 0xdd, 0x74, 0x9e, 0xf3, 0x4e, 0x9b, 0x25, 0xd6, 0x7c, 0x32, 0x98, 0xe4,
+	0x9c, 0x37, 0x40, 0xf9, 0xbd, 0x01, 0x46, 0x33, 0x6f, 0x80, 0x49, 0xa5, 0xfa, 0x91, 0x6e, 0xee,
+	0x20, 0x66, 0x65, 0x80, 0xdf, 0xce, 0x27, 0x94, 0xc2, 0xed, 0xfc, 0xb5, 0x96, 0xf4, 0xcc, 0x3b,
+	0x9f, 0xf9, 0x76, 0x1a, 0xcc, 0x6c, 0x89, 0x47, 0x73, 0x62, 0xb0, 0xc4, 0x2b, 0x7f, 0x78, 0x84,
+	0x3f, 0xfb, 0xf2, 0xef, 0x1c, 0xe1, 0xde, 0xed, 0x29, 0x4a, 0x71, 0x7c, 0xe5, 0x8a, 0x75, 0x65,
+	0xe7, 0x35, 0xcb, 0x70, 0xe4, 0xfc, 0x37, 0x4f, 0x01, 0x48, 0xba, 0x6f, 0xdc, 0xe4, 0x49, 0xf0,
+	0xe7, 0x78, 0xc3, 0x1f, 0xbf, 0xe1, 0x8f, 0x53, 0xb5, 0xf2, 0x98, 0xa7, 0x79, 0x10, 0xa0, 0xc6,
+	0xf5, 0x1a, 0x62, 0x49, 0xfa, 0x8d, 0x5b, 0xe5, 0xc1, 0xb9, 0xf0, 0x9c, 0x70, 0x7e, 0x95, 0x50,
+	0x0a, 0xdd, 0xde, 0x03, 0x90, 0x22, 0xe6, 0x16, 0x16, 0x93, 0x0a, 0x08, 0xc4, 0x96, 0x8a, 0xa4,
+	0x96, 0x62, 0xcf, 0xb9, 0xa7, 0x44, 0x1e, 0x07, 0x00, 0x29, 0x2b, 0xcf, 0xa5, 0xe6, 0x05, 0x02,
+	0x49, 0x24, 0x1b, 0x8b, 0xcc, 0xb5, 0x94, 0x96, 0x43, 0xcf, 0x23, 0xfb, 0xdc, 0xbc, 0xd3, 0xd3,
+	0xf3, 0x6c, 0x96, 0xdc, 0xb2, 0xdf, 0x46, 0x9b, 0x00, 0x42, 0x4a, 0xa3, 0xb6, 0x86, 0xd7, 0x14,
+	0x60, 0xd5, 0x2a, 0xf0, 0xa7, 0xd7, 0x01, 0x87, 0x54, 0x8a, 0x54, 0x11, 0x69, 0xd2, 0x65, 0x04,
+	0x99, 0xa2, 0xad, 0xb4, 0xda, 0xa4, 0xb5, 0xd6, 0x9b, 0x8b, 0x9c, 0xf6, 0xd2, 0x6b, 0x97, 0xde,
+	0x7a, 0xef, 0xa3, 0xcf, 0xae, 0xa3, 0x8c, 0x3a, 0x64, 0xb4, 0xd1, 0xc7, 0x18, 0x73, 0xe8, 0xcc,
+	0xb3, 0xa0, 0x81, 0x32, 0xdb, 0xec, 0x73, 0xcc, 0x39, 0x55, 0x73, 0x50, 0x26, 0x52, 0xc6, 0x52,
+	0x9e, 0x57, 0xee, 0xac, 0xbc, 0xca, 0xaa, 0x4b, 0x56, 0x5b, 0x7d, 0x8d, 0x35, 0x97, 0x6e, 0xe8,
+	0xb3, 0xeb, 0x96, 0xdd, 0x76, 0xdf, 0x63, 0xcf, 0xad, 0x96, 0xad, 0x18, 0x32, 0x61, 0xcd, 0xba,
+	0x0d, 0x9b, 0xa6, 0x27, 0x85, 0x83, 0x52, 0x9c, 0x7a, 0xe4, 0xb4, 0xd3, 0xcf, 0x38, 0xf3, 0xe8,
+	0x85, 0x6b, 0xb7, 0xdc, 0x7a, 0xe5, 0xb6, 0xdb, 0xef, 0xb8, 0xf3, 0xea, 0x17, 0x6a, 0x6f, 0x54,
+	0x7f, 0x77, 0xfc, 0x0d, 0xd4, 0xd2, 0x1b, 0xb5, 0xfc, 0x20, 0xe5, 0xcf, 0xf5, 0x2f, 0xd4, 0xb8,
+	0x1b, 0x7a, 0xff, 0x0c, 0x91, 0x5c, 0x4e, 0xc4, 0x31, 0x03, 0xb1, 0x5c, 0x13, 0x88, 0x77, 0x47,
+	0x00, 0x42, 0x67, 0xc7, 0x2c, 0x8e, 0x54, 0x6b, 0x76, 0xe4, 0x1c, 0xb3, 0x38, 0x33, 0x45, 0x21,
+	0x99, 0x45, 0x8a, 0x63, 0x13, 0x2c, 0x39, 0x62, 0x40, 0x58, 0x4f, 0xca, 0x72, 0xd3, 0x17, 0x76,
+	0xbf, 0x21, 0xf7, 0x4b, 0xb8, 0x05, 0x19, 0xbf, 0x84, 0x5b, 0xfe, 0x2b, 0xe4, 0x82, 0x43, 0xf7,
+	0x4f, 0x20, 0x17, 0x80, 0xee, 0xf7, 0xb8, 0xfd, 0x04, 0x35, 0x73, 0xb9, 0xdb, 0x0f, 0x62, 0xaf,
+	0x2a, 0xf4, 0x9c, 0xc6, 0x42, 0xf5, 0xf1, 0x8c, 0xe6, 0x11, 0xf8, 0xc4, 0xc8, 0xaf, 0xff, 0xf5,
+	0xfc, 0xff, 0x81, 0xfe, 0xb9, 0x81, 0x56, 0x6e, 0x6b, 0x5b, 0x9b, 0xa5, 0xb7, 0x02, 0x17, 0xcb,
+	0x1c, 0x57, 0x44, 0x77, 0xd4, 0x3b, 0xb5, 0x2d, 0x04, 0x2a, 0x64, 0xe4, 0xe9, 0x5a, 0x3c, 0x36,
+	0x5b, 0x5c, 0xb3, 0x1c, 0xeb, 0x27, 0xf6, 0x35, 0x0d, 0xc2, 0xee, 0x64, 0xe2, 0xac, 0xc2, 0x5e,
+	0xe4, 0x69, 0x66, 0x6d, 0x59, 0x9f, 0xd1, 0x7a, 0xbc, 0x75, 0xee, 0xb3, 0x9b, 0xab, 0xd8, 0xbe,
+	0x56, 0xaf, 0x6e, 0xd5, 0xd0, 0x19, 0x93, 0x01, 0xad, 0xb5, 0xb9, 0x21, 0x72, 0x29, 0xba, 0x46,
+	0x3b, 0x75, 0x39, 0x3b, 0x29, 0x55, 0x99, 0x4b, 0x94, 0xb9, 0xd3, 0xd6, 0x54, 0x85, 0x7f, 0x6e,
+	0x64, 0x7e, 0x76, 0x0e, 0x7f, 0xf4, 0xc5, 0x73, 0x2e, 0x79, 0x45, 0x1d, 0x49, 0x29, 0xad, 0xf7,
+	0xdd, 0x9c, 0xf2, 0x1a, 0x59, 0x37, 0x1c, 0x9d, 0x97, 0x80, 0x7d, 0x69, 0xbd, 0x9f, 0xb4, 0x42,
+	0x5c, 0xc7, 0xf2, 0x55, 0xd3, 0xdd, 0xd4, 0xba, 0x66, 0xe3, 0x1d, 0x39, 0x6a, 0xf5, 0x94, 0xb8,
+	0xd0, 0xe5, 0x9b, 0x08, 0x37, 0x1b, 0x4b, 0x32, 0xbe, 0xea, 0xf5, 0x90, 0xaf, 0x5a, 0xc6, 0x7e,
+	0xb2, 0xa7, 0x6e, 0x2e, 0xb2, 0xce, 0x36, 0x94, 0x15, 0x1d, 0xc9, 0x6b, 0x93, 0xb1, 0xe3, 0x53,
+	0x2b, 0xe5, 0xb3, 0xd7, 0xd8, 0xc4, 0x7b, 0x27, 0x09, 0xb6, 0x73, 0x08, 0xee, 0x16, 0xb5, 0x46,
+	0x17, 0xa5, 0x8a, 0xd5, 0x07, 0x17, 0xaa, 0x68, 0xf5, 0x7d, 0x7b, 0x39, 0x9b, 0x01, 0x79, 0xfd,
+	0x84, 0xc5, 0xdc, 0xab, 0xd5, 0xcd, 0xb3, 0x82, 0x2f, 0x5c, 0x4f, 0x04, 0x85, 0xa6, 0xfd, 0x99,
+	0xf1, 0x9b, 0xf3, 0x74, 0x7f, 0xd8, 0xfc, 0xcd, 0xa4, 0x23, 0x22, 0x3c, 0xa4, 0x53, 0x6f, 0x61,
+	0xd8, 0x32, 0x03, 0x21, 0x79, 0x5b, 0x31, 0xa0, 0x68, 0xe3, 0x44, 0xd0, 0xbc, 0xe7, 0x3a, 0x72,
+	0x6d, 0x52, 0xeb, 0x04, 0x5b, 0xf8, 0x0c, 0xcb, 0x04, 0x05, 0x40, 0x2a, 0x63, 0xdd, 0xd6, 0x1d,
+	0xe5, 0xb6, 0x50, 0x2d, 0x0f, 0xf4, 0x34, 0x5f, 0x6f, 0xa8, 0x24, 0xcb, 0xed, 0x83, 0x2f, 0x94,
+	0xc5, 0x89, 0xae, 0x45, 0xf9, 0xd7, 0xcc, 0xa7, 0xe9, 0x18, 0x56, 0x56, 0x97, 0x42, 0x1e, 0x4e,
+	0x29, 0xf3, 0x78, 0xa0, 0x07, 0xdd, 0x3d, 0xe7, 0xca, 0xc9, 0x57, 0x2a, 0xa2, 0x03, 0xb1, 0x10,
+	0xa6, 0x12, 0xa6, 0x0f, 0xf0, 0x0a, 0x93, 0xc7, 0x95, 0xe1, 0xd3, 0x6d, 0x48, 0x4a, 0xd7, 0x6d,
+	0x64, 0xbd, 0x4c, 0x96, 0x9b, 0x4f, 0x83, 0x20, 0xe8, 0xc9, 0x3c, 0x64, 0x42, 0xfa, 0x6c, 0x90,
+	0x87, 0x1c, 0x0e, 0x39, 0x7b, 0xed, 0x7d, 0xeb, 0xa2, 0x1d, 0xad, 0xbd, 0xce, 0x2a, 0x3a, 0x0e,
+	0x4e, 0xa8, 0xfa, 0xdd, 0x96, 0x40, 0xd6, 0x8e, 0x1e, 0x5e, 0x20, 0x00, 0x96, 0x33, 0x4f, 0xed,
+	0xad, 0xd1, 0x42, 0xac, 0xb3, 0xda, 0x06, 0xb0, 0x96, 0x59, 0x15, 0x49, 0x5a, 0x32, 0x77, 0x96,
+	0xad, 0x5d, 0x5a, 0x00, 0xbc, 0xfb, 0x68, 0x61, 0x5b, 0x2c, 0x85, 0x96, 0x2d, 0xc3, 0x64, 0x15,
+	0x94, 0x8f, 0x1d, 0xc1, 0xcf, 0x28, 0x46, 0x96, 0xf0, 0x59, 0x39, 0xab, 0xf4, 0x7d, 0x6e, 0xdd,
+	0x48, 0xeb, 0xe9, 0x88, 0x3f, 0xb1, 0x98, 0x68, 0xaf, 0x2c, 0xdd, 0xae, 0x2c, 0xdb, 0xf0, 0xf9,
+	0xd2, 0xa8, 0x1b, 0x95, 0x65, 0xc2, 0xe8, 0xc3, 0xc6, 0x49, 0xca, 0xe0, 0xa6, 0xb2, 0x6a, 0xca,
+	0x4e, 0x1a, 0x18, 0x79, 0x68, 0x07, 0xcb, 0x59, 0x49, 0xb4, 0x90, 0xb4, 0x06, 0xe2, 0x6a, 0x0c,
+	0x09, 0x42, 0x04, 0xbc, 0xbd, 0x12, 0xd7, 0x33, 0x2f, 0x0c, 0xc4, 0xc1, 0x93, 0xa5, 0x68, 0x72,
+	0x46, 0x27, 0x5b, 0x57, 0x36, 0x5a, 0x0f, 0x36, 0xcb, 0x26, 0xc1, 0xdd, 0x41, 0x78, 0x76, 0x75,
+	0xae, 0x05, 0x4b, 0x35, 0x24, 0xc9, 0xde, 0x97, 0x34, 0x9e, 0x28, 0xbe, 0x4c, 0x95, 0x6a, 0xda,
+	0xea, 0xcd, 0xc9, 0x3b, 0xc1, 0x3e, 0x64, 0x6f, 0xc4, 0xe3, 0x4b, 0x84, 0x98, 0x73, 0x51, 0xa1,
+	0x3c, 0x37, 0xc4, 0x14, 0x0a, 0x15, 0x2a, 0xba, 0x52, 0xea, 0x75, 0x2d, 0x09, 0xc5, 0x1a, 0x11,
+	0x5b, 0xc4, 0x0a, 0xec, 0x33, 0x1d, 0x98, 0x53, 0x1c, 0x0c, 0xb9, 0xd9, 0xfb, 0x43, 0x23, 0x5b,
+	0x2b, 0x52, 0xcc, 0xae, 0x18, 0x14, 0xc1, 0x87, 0xb2, 0x32, 0x47, 0x94, 0x27, 0x75, 0xee, 0xbb,
+	0xe0, 0x4e, 0x10, 0x21, 0x39, 0xe4, 0x55, 0x78, 0x25, 0x77, 0x72, 0x72, 0x26, 0x7d, 0x76, 0xd0,
+	0xd8, 0x08, 0x99, 0xa2, 0x85, 0x54, 0x70, 0x08, 0xf4, 0xa5, 0x29, 0xee, 0xe8, 0x48, 0x61, 0x7b,
+	0x72, 0x72, 0x31, 0x35, 0xef, 0x58, 0xe3, 0xc5, 0x7c, 0x8b, 0xe1, 0xd4, 0x8f, 0x7c, 0xd1, 0x93,
+	0x4c, 0x6f, 0xdf, 0x64, 0xb0, 0x51, 0x79, 0x08, 0x09, 0x92, 0x53, 0x48, 0x3f, 0x3c, 0x49, 0x70,
+	0x19, 0xb6, 0xb2, 0x60, 0x2b, 0xcf, 0x82, 0xa2, 0xc2, 0xab, 0x02, 0x97, 0xa0, 0xe0, 0xb8, 0xba,
+	0x58, 0x51, 0x6d, 0xe8, 0x42, 0x3d, 0x87, 0x30, 0x2c, 0x22, 0x61, 0xb6, 0x09, 0x9a, 0x2e, 0x4d,
+	0x3e, 0x86, 0x45, 0x6f, 0x9e, 0xa2, 0x8f, 0x5b, 0xb3, 0x82, 0xbc, 0x31, 0x57, 0x35, 0x04, 0x8c,
+	0x07, 0xbc, 0xf8, 0xd8, 0x76, 0x41, 0x80, 0xce, 0x57, 0x61, 0xe2, 0x9e, 0x1b, 0x49, 0xc2, 0xa7,
+	0x49, 0x29, 0xb9, 0x75, 0xa6, 0xbb, 0xd2, 0xad, 0xef, 0x69, 0x5c, 0x40, 0x42, 0x4a, 0xf1, 0x68,
+	0x1f, 0x69, 0xa0, 0x0f, 0x1f, 0x5d, 0xa2, 0xe1, 0xc6, 0x21, 0x3d, 0x77, 0x58, 0x81, 0x36, 0x64,
+	0xab, 0xd4, 0x1a, 0xd9, 0x61, 0x4a, 0x81, 0x8e, 0xd3, 0xab, 0xad, 0x1f, 0x97, 0x60, 0xef, 0xae,
+	0x2c, 0x06, 0x5d, 0x43, 0x13, 0x88, 0x4e, 0x4a, 0x9a, 0x52, 0x0c, 0x31, 0x3b, 0xd3, 0x20, 0x22,
+	0xc5, 0xe4, 0x03, 0x76, 0xc1, 0xe8, 0x8f, 0x47, 0x21, 0x7d, 0x07, 0xf8, 0x49, 0x3f, 0x5e, 0xc4,
+	0x81, 0x9a, 0xcc, 0x81, 0x83, 0x58, 0x97, 0x29, 0xb0, 0x09, 0xb0, 0x8c, 0xa2, 0x07, 0x51, 0xcc,
+	0xff, 0xdd, 0xf7, 0xba, 0xb1, 0x5f, 0x8b, 0xbb, 0x6d, 0x79, 0x31, 0xc3, 0x46, 0x69, 0x7d, 0x86,
+	0x9b, 0x04, 0x79, 0xea, 0x51, 0xf5, 0x12, 0x1c, 0x7c, 0xd9, 0x11, 0x1d, 0x3d, 0x24, 0x60, 0x9b,
+	0xc7, 0xe1, 0x06, 0x06, 0x0b, 0xe2, 0x49, 0xc3, 0x7c, 0x70, 0x27, 0x41, 0x3f, 0x2a, 0x10, 0x19,
+	0x1c, 0xe6, 0xd9, 0x69, 0x24, 0x8e, 0x30, 0x03, 0xac, 0x43, 0x17, 0x79, 0xb6, 0x82, 0xcd, 0x7c,
+	0xc9, 0x1a, 0x76, 0x97, 0xf2, 0x80, 0xbd, 0x88, 0x61, 0x61, 0x22, 0xc4, 0x4a, 0x8c, 0x12, 0xa5,
+	0x7c, 0x13, 0x54, 0x28, 0xed, 0xc1, 0xef, 0x4c, 0xbc, 0x51, 0x16, 0x7c, 0x9b, 0xac, 0x79, 0xe8,
+	0x22, 0xac, 0x88, 0xb1, 0x2f, 0x65, 0x88, 0xc4, 0x55, 0xcc, 0xc9, 0x04, 0xb7, 0xe1, 0x19, 0x4a,
+	0xa3, 0x23, 0x29, 0x04, 0x8b, 0xa6, 0xaa, 0x13, 0x6a, 0xd2, 0x62, 0x68, 0x3b, 0x15, 0x45, 0x5b,
+	0x83, 0x5a, 0xa2, 0x7e, 0x9a, 0x22, 0x44, 0xe0, 0x1d, 0x5e, 0x84, 0x62, 0x5b, 0xfa, 0x63, 0x57,
+	0x64, 0xcb, 0x43, 0x2d, 0xea, 0x52, 0x7d, 0x64, 0x85, 0x92, 0xa4, 0xcc, 0x5a, 0xcd, 0xe9, 0x58,
+	0xd9, 0xba, 0x31, 0x45, 0x14, 0x20, 0x8e, 0xed, 0xcc, 0x29, 0xde, 0x45, 0x00, 0xb7, 0x35, 0xc8,
+	0x54, 0xe8, 0x8a, 0xe7, 0xa5, 0xd7, 0xe0, 0xbe, 0x63, 0x37, 0xc9, 0x4e, 0x17, 0xe4, 0xc2, 0xcb,
+	0x2d, 0x0d, 0x2f, 0xc4, 0x66, 0x8e, 0x09, 0x06, 0xcb, 0x2b, 0x14, 0x5f, 0x19, 0x5f, 0x19, 0x83,
+	0x3b, 0x31, 0x94, 0xe4, 0xc5, 0xe7, 0xc9, 0x1c, 0xd8, 0xd0, 0xb7, 0xf6, 0xc3, 0x27, 0xea, 0xde,
+	0x04, 0x3d, 0xf5, 0x26, 0xd9, 0x56, 0x9c, 0x34, 0xdb, 0x2d, 0x63, 0x28, 0x0b, 0x6a, 0xe6, 0xdd,
+	0xab, 0xdb, 0x84, 0x71, 0x40, 0x82, 0xf4, 0xe1, 0x33, 0x83, 0x14, 0x78, 0x01, 0xbd, 0x16, 0xba,
+	0x29, 0x54, 0x16, 0xf5, 0x83, 0x03, 0x67, 0xc3, 0x08, 0x1b, 0xd9, 0x6a, 0x00, 0xff, 0x71, 0xa6,
+	0x41, 0xc9, 0xfc, 0x42, 0x1f, 0xec, 0x5d, 0xaa, 0xbd, 0x97, 0x68, 0xbd, 0xf1, 0xd3, 0xe0, 0x42,
+	0xfc, 0xb1, 0xef, 0xa0, 0x61, 0x97, 0xe8, 0x48, 0x31, 0x7a, 0xd3, 0xb1, 0xb4, 0x00, 0xf3, 0x30,
+	0x56, 0x68, 0xe4, 0x67, 0x34, 0x18, 0x46, 0xb9, 0x34, 0x97, 0x6d, 0xd9, 0xfe, 0x24, 0x6c, 0xcd,
+	0xa3, 0x85, 0x74, 0x59, 0xc0, 0x23, 0x8d, 0x9b, 0x8e, 0xe0, 0xb4, 0x11, 0xec, 0x3a, 0x85, 0x5e,
+	0xbd, 0xe2, 0x9e, 0xe4, 0x57, 0xf5, 0x22, 0xa3, 0xe8, 0xc9, 0x92, 0x97, 0x95, 0x37, 0x37, 0xa7,
+	0x8c, 0x8b, 0x65, 0x84, 0x63, 0x4f, 0xca, 0x82, 0x3f, 0x4c, 0x72, 0x7e, 0x63, 0x10, 0x11, 0x27,
+	0xa5, 0x07, 0x09, 0xeb, 0x27, 0x81, 0x98, 0x57, 0x7d, 0x27, 0x51, 0x36, 0xbd, 0xa3, 0xc0, 0x02,
+	0xc4, 0x61, 0xd0, 0x1d, 0x8c, 0xd6, 0x05, 0x69, 0xf0, 0xb9, 0x26, 0x35, 0xc0, 0xfc, 0x8f, 0xa8,
+	0x20, 0x3f, 0x7f, 0xec, 0x90, 0x20, 0x7e, 0x7b, 0x42, 0x87, 0x8a, 0xf4, 0x46, 0xba, 0x6b, 0x3f,
+	0x2e, 0xd9, 0x5c, 0x37, 0xd2, 0x25, 0x61, 0xe0, 0x81, 0xa3, 0x17, 0x09, 0xbd, 0x6b, 0xb8, 0x06,
+	0x98, 0x5b, 0x10, 0x74, 0x33, 0x5d, 0x97, 0x0c, 0x0e, 0x6a, 0xeb, 0x59, 0x10, 0x81, 0xa0, 0x00,
+	0x4f, 0x81, 0xa0, 0xa8, 0x91, 0x36, 0xb5, 0x08, 0x1f, 0xad, 0x8d, 0x38, 0x07, 0x0b, 0x05, 0x93,
+	0xf0, 0x5c, 0x8b, 0xeb, 0x0e, 0x82, 0xbb, 0x6a, 0x75, 0xd5, 0x21, 0xb6, 0x89, 0x61, 0xd8, 0xe6,
+	0x1e, 0xcd, 0xdd, 0x44, 0x71, 0xcb, 0x86, 0x62, 0xd2, 0xf7, 0xed, 0x4c, 0x24, 0x73, 0x1f, 0x04,
+	0x08, 0xb7, 0xc1, 0xce, 0x80, 0x7e, 0x1a, 0xe8, 0x3d, 0xf7, 0xf1, 0xfd, 0x67, 0x16, 0x58, 0xf0,
+	0x8b, 0xae, 0xb1, 0x60, 0x42, 0x16, 0xd9, 0x5f, 0x46, 0x6c, 0x3b, 0x9e, 0x85, 0x89, 0xa0, 0x74,
+	0xd0, 0x19, 0xa7, 0x32, 0x21, 0x13, 0xb7, 0x64, 0x98, 0xfc, 0xd0, 0x79, 0x79, 0x15, 0xa5, 0x48,
+	0x43, 0xf7, 0x5e, 0x16, 0x9b, 0xc7, 0x9d, 0xbf, 0xc2, 0x72, 0xad, 0xe8, 0xd5, 0xb7, 0x49, 0xd5,
+	0x09, 0x17, 0xea, 0x60, 0x2f, 0x95, 0xe7, 0x13, 0x3b, 0x8f, 0x64, 0xc0, 0xf3, 0xd0, 0xf7, 0x98,
+	0x11, 0xfb, 0xd5, 0xdc, 0x1e, 0x82, 0x5b, 0x4f, 0x65, 0x3c, 0x53, 0x52, 0x7a, 0x6c, 0x18, 0x8e,
+	0x67, 0xfb, 0xb0, 0x65, 0x59, 0xc4, 0x48, 0xe9, 0xa2, 0x8e, 0xe1, 0x1d, 0x0d, 0xc9, 0x19, 0x6f,
+	0x7d, 0x8b, 0x7f, 0x71, 0x4e, 0xa8, 0xfc, 0x69, 0xcd, 0xc5, 0x00, 0x0d, 0x80, 0x4f, 0x98, 0xcf,
+	0xd3, 0x03, 0x2d, 0x9d, 0x68, 0xa7, 0x6b, 0x0e, 0xbb, 0x20, 0xe5, 0x8f, 0xe9, 0xdd, 0x96, 0xfd,
+	0xce, 0xe5, 0xb5, 0xc6, 0x06, 0xcd, 0xb0, 0x76, 0x88, 0x9a, 0x6f, 0xe1, 0xe0, 0x1c, 0x94, 0x24,
+	0xa6, 0x29, 0x3d, 0x7d, 0xac, 0x17, 0xc5, 0x45, 0xc0, 0xc1, 0xeb, 0x19, 0x83, 0xe2, 0x75, 0x7d,
+	0x3c, 0x8d, 0x6d, 0x3b, 0xba, 0x90, 0x90, 0x5a, 0xf7, 0x8a, 0xcf, 0xc9, 0x11, 0x63, 0x2e, 0xcc,
+	0x9e, 0xef, 0x9c, 0x1c, 0x31, 0xaa, 0x22, 0xc3, 0x61, 0xac, 0x13, 0xd5, 0x47, 0x33, 0x76, 0xe2,
+	0x87, 0xe9, 0x55, 0x9a, 0xfb, 0xac, 0x7f, 0xee, 0x7e, 0x7f, 0x72, 0x96, 0x64, 0x5e, 0x46, 0x31,
+	0xd2, 0x67, 0xa9, 0xfe, 0xd3, 0xdd, 0x5c, 0x0a, 0xed, 0x07, 0xea, 0xd0, 0xa9, 0xdd, 0xcf, 0x77,
+	0x3a, 0x68, 0x74, 0xb1, 0x2f, 0x7d, 0xd3, 0x02, 0x72, 0xd1, 0x57, 0xc3, 0x62, 0x07, 0xea, 0x7b,
+	0xcd, 0xf9, 0xea, 0x6f, 0x94, 0x99, 0xc7, 0x81, 0xf2, 0x64, 0xae, 0xc2, 0xd3, 0xcf, 0x7c, 0x63,
+	0x19, 0x5f, 0x38, 0x72, 0xa4, 0x12, 0xa9, 0x33, 0xd2, 0x42, 0x07, 0x45, 0xf1, 0xb2, 0xf7, 0x8c,
+	0xab, 0xa8, 0x12, 0xb6, 0xf7, 0xd2, 0x98, 0x8f, 0xb9, 0xcc, 0x62, 0x40, 0xe9, 0x1e, 0x98, 0x9f,
+	0x17, 0x5a, 0x88, 0xff, 0x1e, 0x3f, 0x73, 0xb0, 0xbf, 0x74, 0x7e, 0x58, 0xa0, 0xea, 0x24, 0xa3,
+	0xd3, 0x1e, 0x54, 0x80, 0x2d, 0x05, 0x7d, 0x0c, 0xd3, 0x88, 0x1c, 0x63, 0x16, 0x30, 0x08, 0x9a,
+	0x1e, 0x55, 0x4a, 0xd8, 0x92, 0x76, 0xdc, 0x41, 0xec, 0x83, 0x20, 0x63, 0x6c, 0x29, 0x7a, 0xac,
+	0xc8, 0x65, 0xd7, 0x7b, 0xd7, 0x62, 0xa3, 0x7a, 0x9f, 0x1d, 0xea, 0x09, 0xc5, 0xeb, 0xf2, 0xd2,
+	0x51, 0xdd, 0xc1, 0x5f, 0xa4, 0x10, 0x8d, 0x60, 0x03, 0xcb, 0x67, 0xdf, 0xdd, 0xef, 0xa1, 0x6d,
+	0xd2, 0x95, 0x1e, 0x93, 0x8e, 0xf4, 0x62, 0x96, 0xf1, 0xa4, 0xbc, 0xbd, 0xa4, 0x5c, 0xda, 0xf1,
+	0xf0, 0xff, 0x7e, 0x2a, 0x4c, 0xc1, 0xa6, 0x86, 0x76, 0xf3, 0xec, 0x0c, 0x30, 0x45, 0x65, 0x6f,
+	0x61, 0x90, 0x7e, 0xcd, 0xbe, 0x06, 0xd9, 0xe6, 0xfe, 0xb6, 0xaf, 0xec, 0x9b, 0x23, 0xdf, 0x10,
+	0x91, 0xff, 0xc7, 0x46, 0x5f, 0xb6, 0x07, 0x38, 0x4f, 0x76, 0x03, 0xb4, 0x2b, 0xff, 0xaf, 0x31,
+	0x12, 0xed, 0xfa, 0x2b, 0xec, 0xeb, 0xff, 0x6e, 0x8e, 0xd8, 0x7b, 0xcf, 0xf0, 0x5f, 0x3c, 0xc9,
+	0xc1, 0x0d, 0xee, 0xe7, 0x9c, 0xa2, 0x00, 0x00, 0x01, 0x85, 0x69, 0x43, 0x43, 0x50, 0x49, 0x43,
+	0x43, 0x20, 0x70, 0x72, 0x6f, 0x66, 0x69, 0x6c, 0x65, 0x00, 0x00, 0x78, 0x9c, 0x7d, 0x91, 0x3d,
+	0x48, 0xc3, 0x40, 0x1c, 0xc5, 0x5f, 0x53, 0xa5, 0x2a, 0x15, 0x05, 0x3b, 0x88, 0x3a, 0x64, 0xa8,
+	0xba, 0x58, 0x10, 0x15, 0x71, 0xd4, 0x2a, 0x14, 0xa1, 0x42, 0xa8, 0x15, 0x5a, 0x75, 0x30, 0xb9,
+	0xf4, 0x0b, 0x9a, 0x34, 0x24, 0x29, 0x2e, 0x8e, 0x82, 0x6b, 0xc1, 0xc1, 0x8f, 0xc5, 0xaa, 0x83,
+	0x8b, 0xb3, 0xae, 0x0e, 0xae, 0x82, 0x20, 0xf8, 0x01, 0xe2, 0xe6, 0xe6, 0xa4, 0xe8, 0x22, 0x25,
+	0xfe, 0x2f, 0x2d, 0xb4, 0x88, 0xf1, 0xe0, 0xb8, 0x1f, 0xef, 0xee, 0x3d, 0xee, 0xde, 0x01, 0x42,
+	0xb5, 0xc8, 0x34, 0xab, 0x6d, 0x1c, 0xd0, 0x74, 0xdb, 0x4c, 0xc4, 0xa2, 0x62, 0x2a, 0xbd, 0x2a,
+	0x06, 0x5e, 0x11, 0xc0, 0x20, 0x7a, 0xd1, 0x89, 0x51, 0x99, 0x59, 0xc6, 0x9c, 0x24, 0xc5, 0xe1,
+	0x39, 0xbe, 0xee, 0xe1, 0xe3, 0xeb, 0x5d, 0x84, 0x67, 0x79, 0x9f, 0xfb, 0x73, 0x74, 0xab, 0x19,
+	0x8b, 0x01, 0x3e, 0x91, 0x78, 0x96, 0x19, 0xa6, 0x4d, 0xbc, 0x41, 0x3c, 0xbd, 0x69, 0x1b, 0x9c,
+	0xf7, 0x89, 0x43, 0x2c, 0x2f, 0xab, 0xc4, 0xe7, 0xc4, 0x63, 0x26, 0x5d, 0x90, 0xf8, 0x91, 0xeb,
+	0x4a, 0x9d, 0xdf, 0x38, 0xe7, 0x5c, 0x16, 0x78, 0x66, 0xc8, 0x4c, 0x26, 0xe6, 0x89, 0x43, 0xc4,
+	0x62, 0xae, 0x85, 0x95, 0x16, 0x66, 0x79, 0x53, 0x23, 0x9e, 0x22, 0x0e, 0xab, 0x9a, 0x4e, 0xf9,
+	0x42, 0xaa, 0xce, 0x2a, 0xe7, 0x2d, 0xce, 0x5a, 0xb1, 0xcc, 0x1a, 0xf7, 0xe4, 0x2f, 0x0c, 0x66,
+	0xf4, 0x95, 0x65, 0xae, 0xd3, 0x1c, 0x42, 0x0c, 0x8b, 0x58, 0x82, 0x04, 0x11, 0x0a, 0xca, 0x28,
+	0xa0, 0x08, 0x1b, 0x11, 0x5a, 0x75, 0x52, 0x2c, 0x24, 0x68, 0x3f, 0xea, 0xe1, 0x1f, 0x70, 0xfd,
+	0x12, 0xb9, 0x14, 0x72, 0x15, 0xc0, 0xc8, 0xb1, 0x80, 0x12, 0x34, 0xc8, 0xae, 0x1f, 0xfc, 0x0f,
+	0x7e, 0x77, 0x6b, 0x65, 0x27, 0x27, 0xea, 0x49, 0xc1, 0x28, 0xd0, 0xfe, 0xe2, 0x38, 0x1f, 0xc3,
+	0x40, 0x60, 0x17, 0xa8, 0x55, 0x1c, 0xe7, 0xfb, 0xd8, 0x71, 0x6a, 0x27, 0x80, 0xff, 0x19, 0xb8,
+	0xd2, 0x9b, 0xfe, 0x52, 0x15, 0x98, 0xf9, 0x24, 0xbd, 0xd2, 0xd4, 0xc2, 0x47, 0x40, 0xcf, 0x36,
+	0x70, 0x71, 0xdd, 0xd4, 0x94, 0x3d, 0xe0, 0x72, 0x07, 0xe8, 0x7f, 0x32, 0x64, 0x53, 0x76, 0x25,
+	0x3f, 0x4d, 0x21, 0x9b, 0x05, 0xde, 0xcf, 0xe8, 0x9b, 0xd2, 0x40, 0xdf, 0x2d, 0xd0, 0xb5, 0x56,
+	0xef, 0xad, 0xb1, 0x8f, 0xd3, 0x07, 0x20, 0x49, 0x5d, 0xc5, 0x6f, 0x80, 0x83, 0x43, 0x60, 0x24,
+	0x47, 0xd9, 0xeb, 0x1e, 0xef, 0xee, 0x68, 0xed, 0xed, 0xdf, 0x33, 0x8d, 0xfe, 0x7e, 0x00, 0x61,
+	0xac, 0x72, 0xa0, 0x04, 0x29, 0x5d, 0xe4, 0x00, 0x00, 0x00, 0x09, 0x70, 0x48, 0x59, 0x73, 0x00,
+	0x00, 0x2e, 0x23, 0x00, 0x00, 0x2e, 0x23, 0x01, 0x78, 0xa5, 0x3f, 0x76, 0x00, 0x00, 0x00, 0x07,
+	0x74, 0x49, 0x4d, 0x45, 0x07, 0xe5, 0x07, 0x1b, 0x10, 0x12, 0x0b, 0x4c, 0x65, 0x26, 0x34, 0x00,
+	0x00, 0x05, 0x76, 0x49, 0x44, 0x41, 0x54, 0x48, 0xc7, 0xed, 0x56, 0x7d, 0x6c, 0x9f, 0x55, 0x15,
+	0x7e, 0xce, 0xbd, 0xf7, 0xfd, 0x7d, 0xb4, 0x6b, 0x47, 0x07, 0x63, 0x5f, 0xc0, 0x34, 0x04, 0x49,
+	0xd6, 0xf2, 0xa1, 0x5b, 0xad, 0x52, 0x6c, 0x00, 0x17, 0x92, 0x49, 0xe7, 0x90, 0x0d, 0x21, 0x02,
+	0x06, 0x17, 0xc2, 0x36, 0x37, 0xea, 0xaa, 0x73, 0xba, 0x39, 0x45, 0xf7, 0x9f, 0x03, 0x15, 0x8c,
+	0xcc, 0xf8, 0x37, 0x61, 0xe0, 0x4c, 0xf6, 0x91, 0x10, 0x94, 0x94, 0xf9, 0x6b, 0x02, 0xd8, 0x49,
+	0x65, 0x80, 0xdd, 0x74, 0xdd, 0x07, 0xcc, 0xb1, 0x5a, 0x5a, 0x4a, 0xfb, 0xeb, 0xda, 0xfd, 0xbe,
+	0xde, 0x7b, 0xcf, 0xe3, 0x1f, 0xef, 0x98, 0xb8, 0x75, 0xa3, 0x1a, 0x89, 0xff, 0x78, 0xf2, 0xe6,
+	0xcd, 0x7d, 0xdf, 0xdc, 0x73, 0x9e, 0x93, 0xe7, 0x9e, 0xfb, 0x9c, 0x23, 0x24, 0xf1, 0x51, 0x9a,
+	0xc1, 0x47, 0x6c, 0xff, 0x07, 0xf8, 0xdf, 0x03, 0xb8, 0x73, 0x7f, 0x15, 0xc7, 0xc7, 0xfb, 0xdf,
+	0x7a, 0x73, 0xf4, 0xdd, 0x77, 0x7d, 0x1c, 0xa7, 0xb2, 0xd9, 0x69, 0xb3, 0x66, 0xcf, 0xb8, 0xe2,
+	0x8a, 0x54, 0x3a, 0xfd, 0x5f, 0x00, 0x18, 0x1e, 0x18, 0xe8, 0xda, 0xb1, 0xe3, 0x0f, 0x8f, 0xfd,
+	0x54, 0x67, 0xce, 0xba, 0xbc, 0xb9, 0x39, 0x55, 0x55, 0x55, 0x3a, 0x39, 0xf6, 0xf6, 0x9e, 0x8e,
+	0x6c, 0x55, 0xf6, 0xb3, 0x2b, 0x56, 0x35, 0x2d, 0xfa, 0xc2, 0x45, 0x17, 0x5f, 0x3c, 0xf9, 0xd0,
+	0x21, 0x84, 0xfe, 0xbf, 0x1d, 0x03, 0x49, 0x92, 0xaa, 0xfa, 0xea, 0x0b, 0x1d, 0x1b, 0xeb, 0xe7,
+	0xfd, 0x72, 0xf3, 0xe6, 0xa3, 0xbd, 0xbd, 0x21, 0x78, 0xbe, 0x6f, 0x95, 0x4a, 0xe5, 0x60, 0x4f,
+	0xcf, 0xe3, 0xeb, 0xd7, 0x7f, 0x77, 0xc1, 0x27, 0xbb, 0x3b, 0x73, 0x9c, 0x84, 0x55, 0xca, 0xe5,
+	0xee, 0x17, 0x3a, 0xb6, 0x2c, 0x5b, 0xda, 0x36, 0xeb, 0xd2, 0xd3, 0x00, 0x9d, 0xdb, 0xb7, 0x7f,
+	0xab, 0x6e, 0xda, 0xae, 0xa7, 0x9e, 0x52, 0xd5, 0x09, 0x7d, 0x54, 0xb5, 0x2b, 0x97, 0x5b, 0x3b,
+	0xf7, 0xf2, 0xdf, 0x6e, 0x3b, 0xef, 0x1e, 0xaa, 0x92, 0x1c, 0xec, 0xeb, 0xdb, 0xba, 0x6a, 0x65,
+	0xdb, 0xa5, 0xd3, 0x1f, 0x6d, 0x6f, 0x7f, 0x6d, 0x6f, 0x17, 0x48, 0xf6, 0xee, 0xdb, 0xb7, 0x76,
+	0xce, 0x9c, 0x9f, 0x3d, 0xf8, 0xe0, 0xd6, 0xef, 0xac, 0x2f, 0x15, 0x0a, 0xe7, 0xfa, 0x9d, 0x59,
+	0x3d, 0xb6, 0x66, 0xf5, 0xea, 0xea, 0xcc, 0x4b, 0xcf, 0xff, 0xee, 0x7c, 0xb9, 0x1f, 0x3b, 0x78,
+	0x70, 0x73, 0xcb, 0x8d, 0x6b, 0x17, 0xcc, 0x7f, 0xfd, 0x95, 0x3f, 0x26, 0x79, 0x48, 0xa5, 0x5c,
+	0xfe, 0xf1, 0xb2, 0x65, 0x4d, 0x0f, 0x3c, 0x70, 0xf3, 0xa2, 0x45, 0x4f, 0xff, 0xe4, 0x51, 0x9f,
+	0x1f, 0xb9, 0xec, 0xda, 0xeb, 0x42, 0xa5, 0x12, 0x8f, 0x8f, 0xbb, 0x28, 0xca, 0xd6, 0xd4, 0x44,
+	0x99, 0x8c, 0x8f, 0x2b, 0x63, 0xc3, 0xc3, 0x43, 0xc7, 0x8f, 0x1d, 0xdd, 0xbd, 0x33, 0x56, 0x2d,
+	0x45, 0x6e, 0xc3, 0xf3, 0x9d, 0x33, 0x66, 0xcf, 0x3e, 0x8b, 0xf4, 0xc1, 0x13, 0x27, 0x7e, 0x75,
+	0xd7, 0x97, 0x47, 0xd3, 0x99, 0x75, 0x4f, 0x3e, 0x39, 0x73, 0xce, 0x9c, 0xd3, 0x87, 0xdc, 0xbb,
+	0x6f, 0xdf, 0xe0, 0xc8, 0x48, 0xcb, 0xad, 0xb7, 0xba, 0x28, 0x9a, 0xb7, 0xa0, 0x71, 0x4f, 0xfb,
+	0x9a, 0xf7, 0x9e, 0xdd, 0x2d, 0xc6, 0xc1, 0x08, 0x05, 0x20, 0x09, 0xa1, 0x80, 0xaa, 0x41, 0x83,
+	0x55, 0x1f, 0x04, 0xa9, 0x4c, 0x2a, 0xb7, 0x6b, 0xc7, 0xdd, 0x5f, 0x5f, 0xf3, 0xc1, 0xe8, 0x95,
+	0x52, 0x69, 0xfb, 0xe6, 0x1f, 0xbd, 0x73, 0xf8, 0xf0, 0xfa, 0xae, 0xbd, 0x67, 0xa2, 0x03, 0x70,
+	0xaf, 0xe7, 0x72, 0x9f, 0x5b, 0xbe, 0x3c, 0x9d, 0xc9, 0x00, 0xe8, 0x7d, 0xe9, 0xc5, 0xc2, 0xa1,
+	0x37, 0xab, 0xa6, 0xd5, 0x49, 0x2a, 0x4d, 0x40, 0x95, 0x21, 0xf8, 0xe0, 0x95, 0x02, 0x89, 0x2c,
+	0x9d, 0x2d, 0x17, 0xc6, 0x8b, 0x85, 0xb1, 0x72, 0xe4, 0xf6, 0xfe, 0xe6, 0xe9, 0xbb, 0x56, 0xad,
+	0x16, 0x91, 0x33, 0x81, 0x3a, 0xb6, 0x6d, 0x7b, 0x6b, 0xf7, 0xae, 0x45, 0x8f, 0xff, 0x7c, 0xee,
+	0x95, 0x57, 0xfe, 0x4b, 0x99, 0xfe, 0xf9, 0xb9, 0xe7, 0xee, 0x7e, 0xe4, 0x91, 0xe4, 0xe3, 0xc4,
+	0xcb, 0x2f, 0x07, 0x88, 0xf7, 0xaa, 0xa1, 0x1c, 0xe2, 0x58, 0xbd, 0x6a, 0x1c, 0x18, 0x2a, 0xa4,
+	0x06, 0xaa, 0x92, 0x31, 0x59, 0x01, 0xbc, 0x55, 0xc9, 0xe7, 0x4f, 0xe6, 0xf3, 0x53, 0xeb, 0xea,
+	0x12, 0xc7, 0x43, 0x6f, 0xbc, 0xf1, 0xe2, 0xc3, 0x1b, 0xfd, 0xc7, 0x3e, 0x7e, 0xf3, 0xe2, 0xc5,
+	0x67, 0xdf, 0xe4, 0xe1, 0xee, 0x57, 0x93, 0x7d, 0x63, 0xf9, 0xfc, 0xd8, 0x5f, 0xff, 0x42, 0x81,
+	0x27, 0xbc, 0x8f, 0x35, 0xa8, 0x08, 0x88, 0xa0, 0xc2, 0xf0, 0xbe, 0xa6, 0x33, 0x79, 0x14, 0x0c,
+	0x3a, 0x9a, 0x1f, 0x49, 0x42, 0x8c, 0x8d, 0x8e, 0xfe, 0xfa, 0xdb, 0xeb, 0xc6, 0x47, 0x4e, 0x2e,
+	0xd9, 0xf4, 0xfd, 0xea, 0x29, 0x53, 0xce, 0x91, 0x0a, 0x21, 0x55, 0x01, 0xe4, 0x87, 0x86, 0x34,
+	0xa8, 0xb8, 0x88, 0x82, 0x10, 0xc7, 0x1a, 0x57, 0xe2, 0x72, 0xd1, 0xc7, 0x65, 0x02, 0x14, 0x18,
+	0xe7, 0x4c, 0x3a, 0x12, 0x6b, 0x01, 0x08, 0xa0, 0xe5, 0xf2, 0xd0, 0xc0, 0x80, 0xaa, 0xaa, 0xea,
+	0x8e, 0x27, 0x7e, 0x91, 0x7f, 0xed, 0x4f, 0xe9, 0xa6, 0xcf, 0xdc, 0xb0, 0x70, 0xe1, 0x04, 0x37,
+	0xb9, 0xa6, 0xa1, 0x61, 0x78, 0x68, 0x08, 0xc0, 0x50, 0x5f, 0x1f, 0x2b, 0x65, 0xaa, 0xc6, 0xa5,
+	0x52, 0xf0, 0x31, 0xbd, 0x42, 0x03, 0x08, 0x90, 0x92, 0x24, 0x4e, 0xa8, 0x2a, 0x00, 0x11, 0xf8,
+	0x7c, 0xfe, 0xbd, 0x81, 0x01, 0x92, 0xaf, 0x74, 0xe6, 0x7a, 0xb6, 0x6c, 0x29, 0x8d, 0x9f, 0xfa,
+	0xca, 0x86, 0x8d, 0x99, 0x6c, 0x76, 0x02, 0xb1, 0x6b, 0x68, 0x6d, 0x3d, 0xbc, 0xbf, 0x07, 0xc0,
+	0xe0, 0xdb, 0xc7, 0x35, 0xae, 0xd0, 0x88, 0x7a, 0xaf, 0x81, 0x4a, 0xd2, 0x18, 0xc9, 0xa6, 0x82,
+	0x2a, 0x01, 0x90, 0xf4, 0x41, 0x98, 0x2c, 0xe1, 0x87, 0x47, 0x8f, 0xee, 0xef, 0x19, 0xec, 0xef,
+	0x7f, 0xa6, 0xed, 0x1b, 0xea, 0x43, 0x5d, 0x6b, 0x6b, 0x63, 0x4b, 0xcb, 0xc4, 0x6a, 0x7a, 0xfd,
+	0x4d, 0x37, 0xe5, 0x9e, 0xd8, 0x5a, 0x2c, 0x14, 0xfa, 0x0e, 0x1c, 0x40, 0x1c, 0x40, 0xc2, 0x59,
+	0x31, 0xa2, 0xd4, 0xa0, 0x1a, 0x82, 0x52, 0x84, 0x80, 0x86, 0x90, 0x30, 0x09, 0x00, 0x02, 0x01,
+	0x3a, 0x37, 0xfd, 0x60, 0x63, 0xf3, 0x0d, 0x7a, 0xe4, 0x48, 0xb1, 0x50, 0xbc, 0x7d, 0xdd, 0xba,
+	0x54, 0x2a, 0x35, 0xb1, 0xd8, 0xd5, 0x37, 0x36, 0xd6, 0xd6, 0xd6, 0x76, 0xec, 0xdc, 0x79, 0xfc,
+	0xf7, 0x7b, 0xc4, 0x18, 0x18, 0xa3, 0x3e, 0x10, 0x10, 0x11, 0x26, 0x59, 0x1b, 0x23, 0x22, 0x12,
+	0x39, 0x0d, 0x9e, 0xa5, 0x0a, 0x00, 0x21, 0xc4, 0x02, 0x41, 0x7c, 0xdf, 0xdf, 0x63, 0x72, 0xfa,
+	0x9d, 0x4b, 0xaf, 0x6f, 0x6a, 0x3a, 0xaf, 0x9a, 0x66, 0xaa, 0xaa, 0xbe, 0xb4, 0x69, 0xd3, 0xae,
+	0x87, 0xd6, 0x54, 0xa5, 0x22, 0xd5, 0x40, 0x0d, 0x24, 0x34, 0x04, 0x92, 0x62, 0xad, 0xb1, 0x46,
+	0x43, 0xa0, 0x0f, 0x08, 0x01, 0x20, 0x44, 0x92, 0x23, 0xb1, 0x29, 0x63, 0xbc, 0x52, 0x35, 0x06,
+	0xee, 0x68, 0xff, 0xa6, 0x8b, 0xa2, 0x0b, 0x35, 0x9c, 0x4f, 0xdf, 0x72, 0xcb, 0x25, 0x8d, 0x8d,
+	0xa1, 0x5c, 0x46, 0x42, 0xb0, 0x08, 0x8c, 0x81, 0x00, 0x00, 0x83, 0x8a, 0x31, 0x12, 0x39, 0x31,
+	0x86, 0x4a, 0x90, 0x89, 0x8f, 0x15, 0x71, 0xd5, 0xa9, 0x40, 0x5e, 0x76, 0xef, 0x3d, 0xd7, 0x36,
+	0x36, 0x7e, 0x48, 0x47, 0x4b, 0x67, 0x32, 0x2d, 0xf7, 0xdd, 0xa7, 0x71, 0x0c, 0x11, 0x55, 0x6a,
+	0x08, 0x50, 0x05, 0x04, 0x89, 0xd2, 0xa9, 0xd2, 0x07, 0x50, 0x21, 0x62, 0x81, 0x08, 0x30, 0x02,
+	0x90, 0xa9, 0xda, 0x29, 0x62, 0x65, 0x69, 0x5b, 0x9b, 0x31, 0xe6, 0xc3, 0x1b, 0xce, 0x70, 0xff,
+	0x3b, 0x08, 0x81, 0x90, 0x44, 0x14, 0x71, 0xfa, 0x5a, 0x89, 0x18, 0x83, 0xa0, 0x49, 0x91, 0x26,
+	0x61, 0x2c, 0x10, 0x00, 0x06, 0x46, 0xd5, 0x53, 0xea, 0x57, 0xdc, 0xd9, 0xf0, 0xa9, 0xf9, 0x1f,
+	0x14, 0x8c, 0xf3, 0xf6, 0xe4, 0x9a, 0x69, 0x75, 0x10, 0x11, 0x91, 0xe4, 0x9d, 0xf8, 0x08, 0x68,
+	0x8c, 0x13, 0x1a, 0x0b, 0x63, 0x81, 0xa4, 0x46, 0x13, 0xea, 0x44, 0x40, 0xd5, 0xa5, 0x2b, 0x57,
+	0x5e, 0x38, 0xfd, 0x7f, 0x02, 0xcc, 0xff, 0xfc, 0xc2, 0xec, 0x35, 0xd7, 0xb0, 0xa6, 0x86, 0xd9,
+	0x2c, 0xa3, 0x0c, 0x6d, 0x04, 0x6b, 0x21, 0x06, 0x21, 0x88, 0x15, 0x1a, 0xaa, 0x80, 0x22, 0x30,
+	0x86, 0x46, 0xe0, 0x8c, 0xc9, 0x56, 0x5f, 0xbd, 0xf8, 0x8e, 0x4f, 0xd4, 0x37, 0x4c, 0x76, 0xaa,
+	0xa8, 0x99, 0x3a, 0xb5, 0x75, 0xc3, 0xf7, 0x98, 0xc9, 0x30, 0x72, 0x8c, 0x0c, 0xad, 0xa3, 0x33,
+	0xc1, 0x49, 0x6c, 0x35, 0x36, 0x1a, 0x5b, 0xc4, 0xce, 0x78, 0x27, 0x3e, 0x12, 0x9f, 0xb6, 0xac,
+	0xae, 0x32, 0xb5, 0x53, 0x6f, 0xfb, 0xda, 0xf2, 0x0b, 0x93, 0x73, 0xf6, 0xd8, 0x72, 0x5d, 0x73,
+	0xf3, 0xdc, 0x25, 0x4b, 0x8c, 0x33, 0x22, 0x22, 0x46, 0x00, 0x27, 0x74, 0xa4, 0x21, 0xa0, 0xa0,
+	0x52, 0x15, 0x24, 0x09, 0x31, 0x62, 0xec, 0x8c, 0x1b, 0x5b, 0xae, 0x9a, 0x57, 0xff, 0xef, 0x01,
+	0x38, 0xe7, 0xbe, 0xf8, 0x50, 0x1b, 0x13, 0xc1, 0x4c, 0x68, 0x86, 0x08, 0x22, 0x11, 0x6b, 0xc4,
+	0x88, 0x18, 0x11, 0x81, 0x35, 0x62, 0x2d, 0x44, 0x16, 0x7e, 0xf5, 0x7e, 0x31, 0x93, 0x9a, 0xa9,
+	0xe4, 0xac, 0xe9, 0xfa, 0xd0, 0xfe, 0x9e, 0x03, 0x5d, 0x5d, 0x03, 0x47, 0x8e, 0xf6, 0x75, 0x77,
+	0x8f, 0xe5, 0x72, 0xae, 0xba, 0x06, 0x0a, 0x42, 0x05, 0xa4, 0x28, 0xad, 0x09, 0x82, 0xab, 0xdb,
+	0xda, 0x57, 0x3c, 0xfc, 0x43, 0xeb, 0xdc, 0x7f, 0x02, 0x70, 0xc6, 0x48, 0x96, 0x8a, 0xc5, 0xc2,
+	0xa9, 0x53, 0x3e, 0x8e, 0x2b, 0xc5, 0x62, 0xb1, 0x50, 0x88, 0xcb, 0x65, 0xb1, 0x66, 0xfa, 0xac,
+	0xd9, 0xd3, 0x67, 0xce, 0x9c, 0xfc, 0x74, 0xf4, 0x0f, 0xd7, 0x7a, 0x90, 0x52, 0x34, 0x97, 0x8a,
+	0x41, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+const asset asset_favicon_png =
+{
+	.type = "image/png",
+	.etag = "\"93e63e02e9cdc743\"",
+	.cache = "public, max-age=604800",
+	.gzip = false,
+	.data = favicon_png_data,
+	.size = sizeof(favicon_png_data),
+};
+
+// time.html: 261 bytes, 187 gzipped
+static const uint8_t time_html_data[] =
+{
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x55, 0x4f, 0xcb, 0x0a, 0xc2, 0x30,
+	0x10, 0xbc, 0xf7, 0x2b, 0x96, 0xdc, 0x25, 0x78, 0xdf, 0xe6, 0xe4, 0x07, 0x08, 0xad, 0x78, 0x94,
+	0xb4, 0x59, 0x4d, 0x20, 0x8f, 0xd2, 0x6e, 0x85, 0xfe, 0xbd, 0x1b, 0x8b, 0xa2, 0xa7, 0x65, 0x86,
+	0x99, 0xd9, 0x19, 0xf4, 0x9c, 0xa2, 0x41, 0x0e, 0x1c, 0xc9, 0x5c, 0x2d, 0xd3, 0x1c, 0xf2, 0x03,
+	0xba, 0x6d, 0x61, 0x4a, 0xa8, 0x77, 0xba, 0xc1, 0xa1, 0xb8, 0x4d, 0x8e, 0x3f, 0x9a, 0x8e, 0x18,
+	0x4e, 0x22, 0x03, 0x9b, 0x1d, 0xf4, 0x21, 0x11, 0x6a, 0x61, 0x1b, 0xbc, 0x97, 0x39, 0x81, 0x1d,
+	0x39, 0x94, 0xdc, 0x2a, 0xad, 0x20, 0x11, 0xfb, 0xe2, 0x5a, 0x75, 0xbe, 0xf4, 0xaa, 0x06, 0xcc,
+	0x06, 0x43, 0x9e, 0x56, 0x06, 0xde, 0x26, 0x6a, 0x95, 0x0f, 0xce, 0x51, 0x56, 0x90, 0x6d, 0x12,
+	0xb4, 0xfb, 0x14, 0x3c, 0x6d, 0x5c, 0x05, 0x2e, 0xc4, 0x37, 0x96, 0xe8, 0x6a, 0xfc, 0x35, 0x39,
+	0xf9, 0x5b, 0xf9, 0x43, 0x2c, 0xa3, 0x8d, 0x1f, 0xf3, 0xae, 0xac, 0x1f, 0xfe, 0xd5, 0xcb, 0x3a,
+	0xa4, 0xc0, 0xdf, 0x50, 0x29, 0x5e, 0xf3, 0x74, 0x2d, 0x6a, 0x50, 0xbf, 0x17, 0x49, 0xf7, 0xba,
+	0xbe, 0x79, 0x01, 0xad, 0x87, 0xf5, 0x55, 0x05, 0x01, 0x00, 0x00,
+};
+
+const asset asset_time_html =
+{
+	.type = "text/html",
+	.etag = "\"75f8a4799ca4c32b-gz\"",
+	.cache = "no-cache",
+	.gzip = true,
+	.data = time_html_data,
+	.size = sizeof(time_html_data),
+};
@@ -0,0 +1,10 @@
+// Generated by tools/mkassets.py from main/www - do not edit
+#ifndef _ASSET_DATA_H
+#define _ASSET_DATA_H
+
+#include "asset.h"
+
+extern const asset asset_favicon_png;
+extern const asset asset_time_html;
+
+#endif // _ASSET_DATA_H
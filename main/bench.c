@@ -0,0 +1,21 @@
+#include "bench.h"
+
+void bench_end(bench_counter *c, uint32_t start)
+{
+	uint32_t cycles = soc_get_ccount() - start;
+
+	c->calls++;
+	c->total += cycles;
+	if (cycles < c->min)
+		c->min = cycles;
+	if (cycles > c->max)
+		c->max = cycles;
+}
+
+void bench_reset(bench_counter *c)
+{
+	c->calls = 0;
+	c->total = 0;
+	c->min = UINT32_MAX;
+	c->max = 0;
+}
@@ -0,0 +1,47 @@
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include <stdint.h>
+#include "esp_attr.h"
+#include "driver/soc.h"
+#include "sdkconfig.h"
+
+/*
+	Functions called in loops on every request or scheduler run. With
+	CONFIG_WATER_HOT_IRAM they run from IRAM rather than through the
+	flash cache, at the cost of the IRAM they take.
+*/
+#ifdef CONFIG_WATER_HOT_IRAM
+#define BENCH_HOT IRAM_ATTR
+#else
+#define BENCH_HOT
+#endif
+
+/*
+	CPU cycles taken by a function, counted with the CCOUNT register - see
+	/debug/bench. A counter is only updated from one task, so it has no
+	lock. CCOUNT wraps after 26 s at 160 MHz, which is far longer than
+	anything measured.
+*/
+typedef struct bench_counter
+{
+	const char *name;
+	uint32_t calls;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+} bench_counter;
+
+#define BENCH_COUNTER(fn) { .name = fn, .min = UINT32_MAX }
+
+static inline uint32_t bench_start(void)
+{
+	return soc_get_ccount();
+}
+
+// the function measured from 'start' has returned
+void bench_end(bench_counter *c, uint32_t start);
+
+void bench_reset(bench_counter *c);
+
+#endif // _BENCH_H
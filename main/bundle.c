@@ -0,0 +1,177 @@
+#include <string.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "asset.h"
+#include "bundle.h"
+#include "crc.h"
+#include "writer.h"
+
+#define HEADER_SIZE 16
+#define ENTRY_SIZE 96
+#define CRC_CHUNK 256			// bytes of the files read at a time to check them
+#define FLAG_GZIP 1
+#define FLAG_PAGE 2
+#define CACHE_PAGE "no-cache"
+#define CACHE_OTHER "public, max-age=604800"
+
+static const char *TAG="BUNDLE";
+static const uint8_t magic[4] = { 'W', 'U', 'I', '2' };
+static const esp_partition_t *partition;
+static bundle_file files[BUNDLE_MAX_FILES];
+static unsigned int file_count;
+
+static uint32_t get32(const uint8_t *p)
+{
+	return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// copy a NUL padded field of the table, which may fill it
+static void get_str(char *dst, size_t size, const uint8_t *src, size_t len)
+{
+	size_t n = strnlen((const char*)src, len);
+
+	if (n >= size)
+		n = size - 1;
+	memcpy(dst, src, n);
+	dst[n] = '\0';
+}
+
+unsigned int bundle_init(void)
+{
+	uint8_t header[HEADER_SIZE];
+	uint8_t entry[ENTRY_SIZE];
+	uint8_t chunk[CRC_CHUNK];
+	unsigned int count;
+	uint32_t crc = 0;
+	uint32_t size;
+	uint32_t pos;
+
+	file_count = 0;
+	partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, "storage");
+	if (!partition || esp_partition_read(partition, 0, header, sizeof(header)) != ESP_OK)
+		return 0;
+	if (memcmp(header, magic, sizeof(magic)) != 0)
+	{
+		ESP_LOGI(TAG, "No UI bundle in flash");
+		return 0;
+	}
+
+	count = header[4] | header[5] << 8;
+	size = get32(&header[12]);
+	if (count > BUNDLE_MAX_FILES || size > partition->size || size < HEADER_SIZE + count * ENTRY_SIZE)
+	{
+		ESP_LOGE(TAG, "Bundle of %u files, %u bytes is too large", count, size);
+		return 0;
+	}
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		bundle_file *f = &files[i];
+
+		if (esp_partition_read(partition, HEADER_SIZE + i * ENTRY_SIZE, entry, sizeof(entry)) != ESP_OK)
+			return 0;
+		crc = crc32(crc, entry, sizeof(entry));
+
+		get_str(f->path, sizeof(f->path), &entry[0], 40);
+		get_str(f->type, sizeof(f->type), &entry[40], 24);
+		f->etag[0] = '"';
+		get_str(&f->etag[1], sizeof(f->etag) - 2, &entry[64], 16);
+		strcat(f->etag, "\"");
+		f->offset = get32(&entry[80]);
+		f->size = get32(&entry[84]);
+		f->gzip = entry[88] & FLAG_GZIP;
+		f->page = entry[88] & FLAG_PAGE;
+		if (f->offset > size || f->size > size - f->offset)
+		{
+			ESP_LOGE(TAG, "%s is outside the bundle", f->path);
+			return 0;
+		}
+	}
+
+	// the files, so a bundle that was only partly written is ignored
+	for (pos = HEADER_SIZE + count * ENTRY_SIZE; pos < size; )
+	{
+		uint32_t len = size - pos < sizeof(chunk) ? size - pos : sizeof(chunk);
+
+		if (esp_partition_read(partition, pos, chunk, len) != ESP_OK)
+			return 0;
+		crc = crc32(crc, chunk, len);
+		pos += len;
+	}
+	if (crc != get32(&header[8]))
+	{
+		ESP_LOGE(TAG, "Bundle is corrupt");
+		return 0;
+	}
+
+	file_count = count;
+	ESP_LOGI(TAG, "UI bundle of %u files, %u bytes", count, size);
+	return count;
+}
+
+const bundle_file *bundle_get(unsigned int index)
+{
+	return index < file_count ? &files[index] : NULL;
+}
+
+const bundle_file *bundle_find(const char *path)
+{
+	for (unsigned int i = 0; i < file_count; i++)
+	{
+		if (strcmp(files[i].path, path) == 0)
+			return &files[i];
+	}
+	return NULL;
+}
+
+// only the gzipped copy is in flash
+bool bundle_acceptable(httpd_req_t *req, const bundle_file *file)
+{
+	return !file->gzip || asset_accepts_gzip(req);
+}
+
+/*
+	The file goes straight from flash to the socket in chunks - it is
+	never assembled in RAM
+*/
+esp_err_t bundle_send(httpd_req_t *req, const bundle_file *file)
+{
+	char buf[WRITER_CHUNK_SIZE];
+	uint32_t sent = 0;
+
+	if (asset_not_modified(req, file->etag, file->page ? CACHE_PAGE : CACHE_OTHER))
+		return ESP_OK;
+
+	httpd_resp_set_type(req, file->type);
+	if (file->gzip)
+		httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+
+	while (sent < file->size)
+	{
+		uint32_t len = file->size - sent;
+		esp_err_t err;
+
+		if (len > sizeof(buf))
+			len = sizeof(buf);
+		err = esp_partition_read(partition, file->offset + sent, buf, len);
+		if (err == ESP_OK)
+			err = httpd_resp_send_chunk(req, buf, len);
+		if (err != ESP_OK)
+			return err;
+		sent += len;
+	}
+	return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+esp_err_t bundle_handler(httpd_req_t *req)
+{
+	static const char message[] = "Only available gzipped\n";
+
+	if (!bundle_acceptable(req, req->user_ctx))
+	{
+		httpd_resp_set_status(req, "406 Not Acceptable");
+		httpd_resp_set_type(req, "text/plain");
+		return httpd_resp_send(req, message, sizeof(message) - 1);
+	}
+	return bundle_send(req, req->user_ctx);
+}
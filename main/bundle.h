@@ -0,0 +1,45 @@
+#ifndef _BUNDLE_H
+#define _BUNDLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <esp_http_server.h>
+
+#define BUNDLE_MAX_FILES 8			// tools/mkbundle.py must match
+#define BUNDLE_PATH 40
+#define BUNDLE_TYPE 24
+#define BUNDLE_ETAG 19				// quoted, with the terminator
+
+/*
+	The web UI, packed by tools/mkbundle.py into the start of the storage
+	partition. It can be flashed without a new firmware. Only the table
+	of files is kept in RAM - a file is read from flash one chunk at a
+	time while it is sent. A gzipped file is only sent to clients that
+	take gzip, others get a 406.
+*/
+typedef struct bundle_file
+{
+	char path[BUNDLE_PATH];		// the URI, /ui/<name>
+	char type[BUNDLE_TYPE];
+	char etag[BUNDLE_ETAG];
+	bool gzip;
+	bool page;						// checked every time instead of cached
+	uint32_t offset;				// in the partition
+	uint32_t size;
+} bundle_file;
+
+// reads the table - returns the number of files, 0 if there is no bundle
+unsigned int bundle_init(void);
+
+const bundle_file *bundle_get(unsigned int index);
+const bundle_file *bundle_find(const char *path);
+
+// URI handler - user_ctx is the file
+esp_err_t bundle_handler(httpd_req_t *req);
+// can bundle_send() send the file to this client?
+bool bundle_acceptable(httpd_req_t *req, const bundle_file *file);
+
+// only after bundle_acceptable()
+esp_err_t bundle_send(httpd_req_t *req, const bundle_file *file);
+
+#endif // _BUNDLE_H
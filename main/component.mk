@@ -2,6 +2,10 @@
 # "main" pseudo-component makefile.
 #
 # (Uses default behaviour of compiling all source files in directory, adding 'include' to include path.)
+# The files in www/ are built in through asset_data.c - see tools/mkassets.py
+# and the pages in templates/ through template_data.c - see tools/mktemplates.py
 
-COMPONENT_EMBED_FILES := favicon.png
-
+# after the project's -Os or -Og, so it wins - see sdkconfig.release-O2
+ifdef CONFIG_WATER_OPTIMIZE_SPEED
+CFLAGS += -O2
+endif
@@ -0,0 +1,359 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "sdkconfig.h"
+#include "config.h"
+
+#define COMMIT_DELAY ((uint64_t)CONFIG_WATER_COMMIT_DELAY * 1000)
+
+static const char *TAG="CONFIG";
+static const char *nvs_name;
+static const config_item *config_items;
+static unsigned int config_count;
+static uint32_t dirty;					// bit n is set when item n must be written
+static SemaphoreHandle_t lock;		// protects the values and 'dirty'
+static esp_timer_handle_t commit_timer;
+static uint8_t *held;					// the values when config_hold() was called, NULL if not held
+static uint32_t held_dirty;
+
+static const config_item *find_item(const char *key, unsigned int *index)
+{
+	for (unsigned int i = 0; i < config_count; i++)
+	{
+		if (strcmp(config_items[i].key, key) == 0)
+		{
+			*index = i;
+			return &config_items[i];
+		}
+	}
+	return NULL;
+}
+
+static size_t item_length(const config_item *item)
+{
+	return item->length ? *item->length : item->size;
+}
+
+// bytes config_hold() keeps for an item - the value, then its length
+static size_t held_size(const config_item *item)
+{
+	return item->size + (item->length ? sizeof(size_t) : 0);
+}
+
+// restart the quiet period, unless the changes are held back
+static void commit_later(void)
+{
+	if (held)
+		return;
+	esp_timer_stop(commit_timer);
+	esp_timer_start_once(commit_timer, COMMIT_DELAY);
+}
+
+/*
+	Write all dirty items and commit them. The lock is only held while a
+	value is copied, so requests aren't blocked while the flash is busy.
+	Values too large to copy are written with the lock held.
+*/
+static esp_err_t commit(void)
+{
+	char value[CONFIG_MAX_VALUE];
+	uint32_t pending;
+	unsigned int written = 0;
+	nvs_handle nvs;
+	esp_err_t err;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	pending = dirty;
+	dirty = 0;
+	xSemaphoreGive(lock);
+
+	if (!pending)
+		return ESP_OK;
+
+	err = nvs_open(nvs_name, NVS_READWRITE, &nvs);
+	if (err == ESP_OK)
+	{
+		for (unsigned int i = 0; i < config_count && err == ESP_OK; i++)
+		{
+			const config_item *item = &config_items[i];
+			const void *data = value;
+			size_t length;
+
+			if (!(pending & (1U << i)))
+				continue;
+
+			xSemaphoreTake(lock, portMAX_DELAY);
+			length = item_length(item);
+			if (item->size <= CONFIG_MAX_VALUE)
+			{
+				memcpy(value, item->value, length);
+				xSemaphoreGive(lock);
+			}
+			else
+				data = item->value;
+
+			if (item->type == CONFIG_STR)
+				err = nvs_set_str(nvs, item->key, data);
+			else
+				err = nvs_set_blob(nvs, item->key, data, length);
+
+			if (data != value)
+				xSemaphoreGive(lock);
+
+			if (err == ESP_OK)
+			{
+				pending &= ~(1U << i);
+				written++;
+			}
+			else
+				ESP_LOGE(TAG, "Can't write %s (%d)", item->key, err);
+		}
+
+		if (written)
+		{
+			esp_err_t commit_err = nvs_commit(nvs);
+			if (err == ESP_OK)
+				err = commit_err;
+		}
+		nvs_close(nvs);
+	}
+
+	// try again with the next change
+	if (pending)
+	{
+		xSemaphoreTake(lock, portMAX_DELAY);
+		dirty |= pending;
+		xSemaphoreGive(lock);
+	}
+
+	if (written)
+		ESP_LOGI(TAG, "Committed %u items", written);
+	return err;
+}
+
+static void commit_callback(void *arg)
+{
+	if (!held)
+		commit();
+}
+
+esp_err_t config_init(const char *name_space, const config_item *items, unsigned int count)
+{
+	const esp_timer_create_args_t commit_timer_args = {
+		.callback = commit_callback,
+		.arg = NULL,
+		.dispatch_method = ESP_TIMER_TASK,
+		.name = "config"
+	};
+	nvs_handle nvs;
+	esp_err_t err;
+
+	if (count > CONFIG_MAX_ITEMS)
+		return ESP_ERR_INVALID_ARG;
+
+	nvs_name = name_space;
+	config_items = items;
+	config_count = count;
+	lock = xSemaphoreCreateMutex();
+	if (!lock)
+		return ESP_ERR_NO_MEM;
+	err = esp_timer_create(&commit_timer_args, &commit_timer);
+	if (err != ESP_OK)
+		return err;
+
+	// nothing stored yet
+	if (nvs_open(nvs_name, NVS_READONLY, &nvs) != ESP_OK)
+		return ESP_OK;
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const config_item *item = &items[i];
+		char value[CONFIG_MAX_VALUE];
+		void *data = item->size <= CONFIG_MAX_VALUE ? value : item->value;
+		size_t length = item->size;
+
+		// small values are read into a scratch buffer so a failed read can't
+		// leave half a value behind
+		if (item->type == CONFIG_STR)
+			err = nvs_get_str(nvs, item->key, data, &length);
+		else
+			err = nvs_get_blob(nvs, item->key, data, &length);
+
+		if (err == ESP_OK && (item->type == CONFIG_STR || item->length || length == item->size))
+		{
+			if (data == value)
+				memcpy(item->value, value, length);
+			if (item->length)
+				*item->length = length;
+			continue;
+		}
+
+		if (err != ESP_ERR_NVS_NOT_FOUND)
+			ESP_LOGW(TAG, "Ignoring stored %s (%d)", item->key, err);
+		if (data != value)
+			memset(item->value, 0, item->size);
+	}
+	nvs_close(nvs);
+
+	return ESP_OK;
+}
+
+esp_err_t config_set(const char *key, const void *value)
+{
+	const config_item *item;
+	unsigned int index;
+	size_t length;
+	bool changed;
+
+	item = find_item(key, &index);
+	if (!item)
+		return ESP_ERR_NOT_FOUND;
+
+	if (item->type == CONFIG_STR)
+	{
+		length = strlen(value) + 1;
+		if (length > item->size)
+			return ESP_ERR_INVALID_SIZE;
+	}
+	else if (item->length)
+		return ESP_ERR_INVALID_ARG;
+	else
+		length = item->size;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	changed = memcmp(item->value, value, length) != 0;
+	if (changed)
+	{
+		memcpy(item->value, value, length);
+		dirty |= 1U << index;
+	}
+	xSemaphoreGive(lock);
+
+	if (changed)
+		commit_later();
+	return ESP_OK;
+}
+
+esp_err_t config_get_str(const char *key, char *value, size_t size)
+{
+	unsigned int index;
+	const config_item *item = find_item(key, &index);
+	esp_err_t err = ESP_OK;
+
+	if (!item || item->type != CONFIG_STR)
+		return ESP_ERR_NOT_FOUND;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	if (strlen(item->value) < size)
+		strcpy(value, item->value);
+	else
+		err = ESP_ERR_INVALID_SIZE;
+	xSemaphoreGive(lock);
+	return err;
+}
+
+void *config_edit_begin(const char *key)
+{
+	unsigned int index;
+	const config_item *item = find_item(key, &index);
+
+	if (!item)
+		return NULL;
+	xSemaphoreTake(lock, portMAX_DELAY);
+	return item->value;
+}
+
+void config_edit_end(const char *key, size_t length)
+{
+	unsigned int index;
+	const config_item *item = find_item(key, &index);
+
+	// config_edit_begin() didn't take the lock either
+	if (!item)
+		return;
+	if (item->length)
+		*item->length = length;
+	dirty |= 1U << index;
+	xSemaphoreGive(lock);
+
+	commit_later();
+}
+
+esp_err_t config_flush(void)
+{
+	if (!commit_timer)
+		return ESP_OK;
+
+	esp_timer_stop(commit_timer);
+	return commit();
+}
+
+esp_err_t config_hold(void)
+{
+	size_t size = 0;
+	uint8_t *copy;
+
+	if (held)
+		return ESP_ERR_INVALID_STATE;
+	for (unsigned int i = 0; i < config_count; i++)
+		size += held_size(&config_items[i]);
+	copy = malloc(size);
+	if (!copy)
+		return ESP_ERR_NO_MEM;
+
+	// a commit that is already waiting would write the changes made while held
+	esp_timer_stop(commit_timer);
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	held = copy;
+	held_dirty = dirty;
+	for (unsigned int i = 0; i < config_count; i++)
+	{
+		const config_item *item = &config_items[i];
+
+		memcpy(copy, item->value, item->size);
+		if (item->length)
+			memcpy(copy + item->size, item->length, sizeof(size_t));
+		copy += held_size(item);
+	}
+	xSemaphoreGive(lock);
+	return ESP_OK;
+}
+
+void config_release(bool keep)
+{
+	const uint8_t *copy = held;
+	uint32_t pending;
+
+	if (!held)
+		return;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	if (!keep)
+	{
+		for (unsigned int i = 0; i < config_count; i++)
+		{
+			const config_item *item = &config_items[i];
+
+			memcpy(item->value, copy, item->size);
+			if (item->length)
+				memcpy(item->length, copy + item->size, sizeof(size_t));
+			copy += held_size(item);
+		}
+		dirty = held_dirty;
+	}
+	free(held);
+	held = NULL;
+	pending = dirty;
+	xSemaphoreGive(lock);
+
+	// what was waiting before the hold, or was changed during it
+	if (pending)
+		commit_later();
+}
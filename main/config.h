@@ -0,0 +1,71 @@
+#ifndef _CONFIG_H
+#define _CONFIG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#define CONFIG_MAX_ITEMS 32		// one dirty bit each
+#define CONFIG_MAX_VALUE 64		// larger values block config_set() while they are written
+
+typedef enum
+{
+	CONFIG_STR,
+	CONFIG_BLOB,
+} config_type;
+
+/*
+	A persistent setting. The value lives in the caller's variable - the
+	store only copies into it and remembers that it has to be written.
+*/
+typedef struct config_item
+{
+	const char *key;		// NVS key
+	config_type type;
+	void *value;			// RAM copy of the setting
+	size_t size;			// size of 'value', including the terminator of a string
+	size_t *length;		// bytes used of a variable sized blob, NULL if fixed
+} config_item;
+
+/*
+	Reads every item from the namespace in one pass. Items that are not
+	stored keep the value they already have.
+*/
+esp_err_t config_init(const char *name_space, const config_item *items, unsigned int count);
+
+/*
+	Changes the value of an item. Changed items are written together once
+	no other change has been made for CONFIG_WATER_COMMIT_DELAY ms, so a
+	burst of requests costs one commit. Setting the same value again
+	doesn't touch the flash. Variable sized blobs are changed with
+	config_edit_begin() instead.
+*/
+esp_err_t config_set(const char *key, const void *value);
+
+/*
+	Copies a string setting into 'value', for tasks other than the one
+	that changes it. ESP_ERR_INVALID_SIZE if it doesn't fit in 'size'.
+*/
+esp_err_t config_get_str(const char *key, char *value, size_t size);
+
+/*
+	Changes a value in place, for variable sized blobs and values too
+	large to copy. Other changes wait until config_edit_end() marks the
+	item as changed.
+*/
+void *config_edit_begin(const char *key);
+void config_edit_end(const char *key, size_t length);
+
+// write pending changes now, e.g. before a reboot
+esp_err_t config_flush(void);
+
+/*
+	Holds back the commit of changes and keeps a copy of every value, so
+	that a set of changes can be dropped together. config_release() then
+	either keeps what was changed since, to be committed as usual, or
+	puts the copies back. There is one hold at a time.
+*/
+esp_err_t config_hold(void);
+void config_release(bool keep);
+
+#endif // _CONFIG_H
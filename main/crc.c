@@ -0,0 +1,20 @@
+#include "bench.h"
+#include "crc.h"
+
+/*
+	Bit at a time - it only runs over data that is read from flash or the
+	network anyway, and a table would cost 1 KB
+*/
+uint32_t BENCH_HOT crc32(uint32_t crc, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+
+	crc = ~crc;
+	while (len--)
+	{
+		crc ^= *p++;
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+	}
+	return ~crc;
+}
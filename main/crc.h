@@ -0,0 +1,13 @@
+#ifndef _CRC_H
+#define _CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+	CRC-32 as zlib.crc32() computes it - start with 0 and pass the
+	result back in to continue over more data
+*/
+uint32_t crc32(uint32_t crc, const void *data, size_t len);
+
+#endif // _CRC_H
@@ -0,0 +1,335 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "history.h"
+
+#define RING (HISTORY_SECTORS * HISTORY_PER_SECTOR)	// records in the log
+#define READ_BLOCK 16			// records read from flash at once
+#define NO_EVENT 0xFFFF
+
+static const char *TAG="HISTORY";
+static const uint8_t magic[4] = { 'W', 'H', 'L', '1' };
+static const esp_partition_t *partition;
+static size_t base;						// offset of the log in the partition
+static uint32_t next_seq;				// of the next record written
+static SemaphoreHandle_t lock;		// protects the queue
+static SemaphoreHandle_t flash_lock;	// protects the log and 'next_seq'
+static esp_timer_handle_t flush_timer;
+static history_record pending[HISTORY_PENDING];
+static unsigned int pending_count;
+static unsigned int dropped;
+
+static uint8_t crc8(const uint8_t *data, size_t len)
+{
+	uint8_t crc = 0;
+
+	while (len--)
+	{
+		crc ^= *data++;
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+	}
+	return crc;
+}
+
+static size_t sector_offset(uint32_t seq)
+{
+	return base + (seq % RING) / HISTORY_PER_SECTOR * HISTORY_SECTOR_SIZE;
+}
+
+static size_t record_offset(uint32_t seq)
+{
+	return sector_offset(seq) + (1 + seq % HISTORY_PER_SECTOR) * HISTORY_RECORD;
+}
+
+static void encode(uint8_t *rec, const history_record *r, uint32_t seq)
+{
+	uint32_t t = r->time;
+	uint16_t event = r->event < 0 ? NO_EVENT : r->event;
+
+	rec[0] = seq;
+	rec[1] = seq >> 8;
+	rec[2] = seq >> 16;
+	rec[3] = seq >> 24;
+	rec[4] = t;
+	rec[5] = t >> 8;
+	rec[6] = t >> 16;
+	rec[7] = t >> 24;
+	rec[8] = r->duration;
+	rec[9] = r->duration >> 8;
+	rec[10] = r->duration >> 16;
+	rec[11] = r->zone | (r->on ? 0x80 : 0);
+	rec[12] = r->cause;
+	rec[13] = event;
+	rec[14] = event >> 8;
+	rec[15] = crc8(rec, HISTORY_RECORD - 1);
+}
+
+/*
+	Erased flash and a torn write fail here. The caller also checks that
+	the sequence number belongs where the record was read from, which
+	catches what was there before the log.
+*/
+static bool decode(const uint8_t *rec, history_record *r)
+{
+	uint16_t event;
+
+	if (crc8(rec, HISTORY_RECORD - 1) != rec[15])
+		return false;
+
+	r->seq = rec[0] | rec[1] << 8 | rec[2] << 16 | (uint32_t)rec[3] << 24;
+	r->time = rec[4] | rec[5] << 8 | rec[6] << 16 | (uint32_t)rec[7] << 24;
+	r->duration = rec[8] | rec[9] << 8 | rec[10] << 16;
+	r->zone = rec[11] & 0x7F;
+	r->on = rec[11] & 0x80;
+	r->cause = rec[12];
+	event = rec[13] | rec[14] << 8;
+	r->event = event == NO_EVENT ? -1 : event;
+	return true;
+}
+
+/*
+	The next record starts a sector - drop the oldest records in it
+*/
+static void start_sector(uint32_t seq)
+{
+	esp_err_t err = esp_partition_erase_range(partition, sector_offset(seq), HISTORY_SECTOR_SIZE);
+
+	if (err == ESP_OK)
+		err = esp_partition_write(partition, sector_offset(seq), magic, sizeof(magic));
+	if (err != ESP_OK)
+		ESP_LOGE(TAG, "Can't start sector at %u (%d)", seq, err);
+}
+
+/*
+	Records in the same sector go in one write. Called with the flash lock.
+*/
+static void write_records(const history_record *records, unsigned int count)
+{
+	uint8_t buf[HISTORY_PENDING * HISTORY_RECORD];
+	uint32_t first = next_seq;
+	size_t len = 0;
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		uint32_t seq = next_seq++;
+
+		if (seq % HISTORY_PER_SECTOR == 0)
+		{
+			if (len)
+				esp_partition_write(partition, record_offset(first), buf, len);
+			len = 0;
+			first = seq;
+			start_sector(seq);
+		}
+		encode(&buf[len], &records[i], seq);
+		len += HISTORY_RECORD;
+	}
+
+	if (len && esp_partition_write(partition, record_offset(first), buf, len) != ESP_OK)
+		ESP_LOGE(TAG, "Can't write %u records", count);
+}
+
+static void queue_record(const history_record *r)
+{
+	xSemaphoreTake(lock, portMAX_DELAY);
+	if (pending_count < HISTORY_PENDING)
+	{
+		pending[pending_count++] = *r;
+		if (pending_count == 1)
+			esp_timer_start_once(flush_timer, HISTORY_FLUSH_DELAY);
+	}
+	else
+		dropped++;
+	xSemaphoreGive(lock);
+}
+
+static void flush_callback(void *arg)
+{
+	history_flush();
+}
+
+void history_flush(void)
+{
+	history_record records[HISTORY_PENDING];
+	unsigned int count;
+	unsigned int lost;
+
+	if (!partition)
+		return;
+
+	// take the queue so new records don't wait for the flash
+	xSemaphoreTake(lock, portMAX_DELAY);
+	esp_timer_stop(flush_timer);
+	count = pending_count;
+	memcpy(records, pending, count * sizeof(history_record));
+	pending_count = 0;
+	lost = dropped;
+	dropped = 0;
+	xSemaphoreGive(lock);
+
+	if (lost)
+		ESP_LOGW(TAG, "Queue full - %u records lost", lost);
+	if (!count)
+		return;
+
+	xSemaphoreTake(flash_lock, portMAX_DELAY);
+	write_records(records, count);
+	xSemaphoreGive(flash_lock);
+}
+
+void history_log(unsigned int zone, const zone_status *zs)
+{
+	history_record r;
+
+	if (!partition)
+		return;
+
+	r.zone = zone;
+	r.on = zs->on;
+	r.cause = zs->cause;
+	r.event = zs->event;
+	if (zs->on)
+	{
+		r.time = zs->last_watering;
+		r.duration = 0;
+	}
+	else
+	{
+		r.time = zs->last_watering + zs->last_duration;
+		r.duration = zs->last_duration;
+	}
+	queue_record(&r);
+}
+
+void history_init(void)
+{
+	const esp_timer_create_args_t flush_timer_args = {
+		.callback = flush_callback,
+		.dispatch_method = ESP_TIMER_TASK,
+		.name = "history"
+	};
+	uint8_t buf[READ_BLOCK * HISTORY_RECORD];
+	history_record last[ZONE_MAX];
+	bool seen[ZONE_MAX] = { false };
+	bool found = false;
+
+	partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, "storage");
+	if (!partition || partition->size < HISTORY_SECTORS * HISTORY_SECTOR_SIZE)
+	{
+		ESP_LOGE(TAG, "No storage partition - history is off");
+		partition = NULL;
+		return;
+	}
+	base = partition->size - HISTORY_SECTORS * HISTORY_SECTOR_SIZE;
+	lock = xSemaphoreCreateMutex();
+	flash_lock = xSemaphoreCreateMutex();
+	esp_timer_create(&flush_timer_args, &flush_timer);
+
+	// the newest record is the end of the log, and the newest of each zone says if it was left on
+	for (unsigned int sector = 0; sector < HISTORY_SECTORS; sector++)
+	{
+		size_t offset = base + sector * HISTORY_SECTOR_SIZE;
+
+		if (esp_partition_read(partition, offset, buf, sizeof(magic)) != ESP_OK
+			|| memcmp(buf, magic, sizeof(magic)) != 0)
+			continue;
+
+		for (size_t block = 0; block < HISTORY_SECTOR_SIZE; block += sizeof(buf))
+		{
+			if (esp_partition_read(partition, offset + block, buf, sizeof(buf)) != ESP_OK)
+				break;
+			for (unsigned int i = 0; i < READ_BLOCK; i++)
+			{
+				history_record r;
+				unsigned int index = block / HISTORY_RECORD + i;
+
+				// the header takes the place of a record
+				if (index == 0 || !decode(&buf[i * HISTORY_RECORD], &r))
+					continue;
+				if (r.seq % RING != sector * HISTORY_PER_SECTOR + index - 1 || r.zone >= ZONE_MAX)
+					continue;
+
+				if (!found || r.seq >= next_seq)
+				{
+					next_seq = r.seq + 1;
+					found = true;
+				}
+				if (!seen[r.zone] || r.seq > last[r.zone].seq)
+				{
+					last[r.zone] = r;
+					seen[r.zone] = true;
+				}
+			}
+		}
+	}
+	ESP_LOGI(TAG, "Next record is %u", next_seq);
+
+	// the valves closed when the controller was reset, but nobody knows when
+	for (unsigned int zone = 0; zone < ZONE_MAX; zone++)
+	{
+		history_record r;
+
+		if (!seen[zone] || !last[zone].on)
+			continue;
+		r = last[zone];
+		r.time = 0;
+		r.duration = 0;
+		r.on = false;
+		r.cause = ZONE_REBOOT;
+		queue_record(&r);
+	}
+	history_flush();
+}
+
+unsigned int history_read(uint32_t before, history_record *records, unsigned int max)
+{
+	uint8_t buf[READ_BLOCK * HISTORY_RECORD];
+	unsigned int count = 0;
+	uint32_t newest;
+	uint32_t seq;
+
+	if (!partition)
+		return 0;
+
+	xSemaphoreTake(flash_lock, portMAX_DELAY);
+	newest = next_seq;
+	xSemaphoreGive(flash_lock);
+	seq = before < newest ? before : newest;
+
+	// walk back a run of records in one sector at a time, until the log ends
+	while (count < max && seq > 0 && newest - seq < RING)
+	{
+		unsigned int run = seq % HISTORY_PER_SECTOR;
+		uint32_t first;
+		esp_err_t err;
+
+		// 'seq' is one past the next record to read
+		run = run ? run : HISTORY_PER_SECTOR;
+		if (run > READ_BLOCK)
+			run = READ_BLOCK;
+		if (run > seq)
+			run = seq;
+		first = seq - run;
+
+		xSemaphoreTake(flash_lock, portMAX_DELAY);
+		err = esp_partition_read(partition, record_offset(first), buf, run * HISTORY_RECORD);
+		xSemaphoreGive(flash_lock);
+		if (err != ESP_OK)
+			break;
+
+		for (unsigned int i = run; i > 0 && count < max; i--)
+		{
+			history_record *r = &records[count];
+
+			if (decode(&buf[(i - 1) * HISTORY_RECORD], r) && r->seq == first + i - 1)
+				count++;
+		}
+		seq = first;
+	}
+
+	return count;
+}
@@ -0,0 +1,63 @@
+#ifndef _HISTORY_H
+#define _HISTORY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "zone.h"
+
+#define HISTORY_SECTORS 16			// flash sectors at the end of the storage partition
+#define HISTORY_SECTOR_SIZE 4096
+#define HISTORY_RECORD 16
+#define HISTORY_PER_SECTOR (HISTORY_SECTOR_SIZE / HISTORY_RECORD - 1)	// after the sector header
+#define HISTORY_PENDING 16			// records waiting in RAM to be written
+#define HISTORY_FLUSH_DELAY 2000000	// how long a record waits for others (us)
+#define HISTORY_LATEST UINT32_MAX	// history_read() from the newest record
+
+/*
+	Every time a valve opens or closes. The log is a ring of fixed size
+	records in the last HISTORY_SECTORS sectors of the storage partition,
+	used raw rather than through SPIFFS. Each sector starts with a 16 byte
+	header ("WHL1" and then 0xFF), followed by the records:
+		seq (4), time (4), duration (3), zone | 0x80 if on (1),
+		cause (1), event (2, 0xFFFF if none), crc8 (1)
+	All values are little endian. The sequence number gives the place of
+	a record in the ring, so a page of the log is found without a search.
+	Going into a new sector erases it, which drops the oldest
+	HISTORY_PER_SECTOR records.
+*/
+typedef struct history_record
+{
+	uint32_t seq;
+	time_t time;				// 0 if not known
+	uint32_t duration;		// seconds the valve was open, for an off record
+	uint8_t zone;
+	bool on;
+	zone_cause cause;
+	int event;					// slot of the scheduled event, -1 if none
+} history_record;
+
+/*
+	Finds the end of the log, and closes zones that the log says were
+	open when the controller was reset
+*/
+void history_init(void);
+
+/*
+	Log the zone after it changed. The record is only queued - the queue
+	is written to flash HISTORY_FLUSH_DELAY later from the timer task, so
+	switching a valve never waits for the flash.
+*/
+void history_log(unsigned int zone, const zone_status *zs);
+
+// write the queue now, e.g. before a reboot
+void history_flush(void);
+
+/*
+	Up to 'max' records older than 'before', newest first. Returns how
+	many were read - fewer than 'max' at the start of the log. Records
+	still in the queue aren't seen yet.
+*/
+unsigned int history_read(uint32_t before, history_record *records, unsigned int max);
+
+#endif // _HISTORY_H
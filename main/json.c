@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <string.h>
+#include "json.h"
+
+static const char hex[] = "0123456789abcdef";
+
+void json_init(json_writer *j, resp_writer *w)
+{
+	j->w = w;
+	j->depth = 0;
+	j->more = 0;
+}
+
+static void json_escaped(json_writer *j, const char *str)
+{
+	const char *run = str;
+
+	writer_write(j->w, "\"", 1);
+	for (; *str; str++)
+	{
+		uint8_t c = *str;
+		char esc[6] = { '\\', 'u', '0', '0' };
+
+		if (c >= 0x20 && c != '"' && c != '\\')
+			continue;
+
+		// copy the characters that don't need escaping in one go
+		writer_write(j->w, run, str - run);
+		run = str + 1;
+		if (c == '"' || c == '\\')
+		{
+			esc[1] = c;
+			writer_write(j->w, esc, 2);
+		}
+		else
+		{
+			esc[4] = hex[c >> 4];
+			esc[5] = hex[c & 0xF];
+			writer_write(j->w, esc, 6);
+		}
+	}
+	writer_write(j->w, run, str - run);
+	writer_write(j->w, "\"", 1);
+}
+
+/*
+	The comma and the member name that go before every value
+*/
+static void json_key(json_writer *j, const char *key)
+{
+	uint8_t bit = 1 << j->depth;
+
+	if (j->more & bit)
+		writer_write(j->w, ",", 1);
+	j->more |= bit;
+
+	if (key)
+	{
+		json_escaped(j, key);
+		writer_write(j->w, ":", 1);
+	}
+}
+
+static void json_open(json_writer *j, const char *key, const char *bracket)
+{
+	json_key(j, key);
+	writer_write(j->w, bracket, 1);
+	j->depth++;
+	j->more &= ~(1 << j->depth);
+}
+
+static void json_close(json_writer *j, const char *bracket)
+{
+	j->depth--;
+	writer_write(j->w, bracket, 1);
+}
+
+void json_object(json_writer *j, const char *key)
+{
+	json_open(j, key, "{");
+}
+
+void json_object_end(json_writer *j)
+{
+	json_close(j, "}");
+}
+
+void json_array(json_writer *j, const char *key)
+{
+	json_open(j, key, "[");
+}
+
+void json_array_end(json_writer *j)
+{
+	json_close(j, "]");
+}
+
+void json_str(json_writer *j, const char *key, const char *value)
+{
+	if (!value)
+	{
+		json_null(j, key);
+		return;
+	}
+	json_key(j, key);
+	json_escaped(j, value);
+}
+
+void json_int(json_writer *j, const char *key, long value)
+{
+	char num[12];
+
+	json_key(j, key);
+	writer_write(j->w, num, snprintf(num, sizeof(num), "%ld", value));
+}
+
+void json_uint(json_writer *j, const char *key, unsigned long value)
+{
+	char num[12];
+
+	json_key(j, key);
+	writer_write(j->w, num, snprintf(num, sizeof(num), "%lu", value));
+}
+
+// without printf, which doesn't do long long on every libc
+void json_uint64(json_writer *j, const char *key, uint64_t value)
+{
+	char num[21];
+	char *p = num + sizeof(num);
+
+	do
+	{
+		*--p = '0' + value % 10;
+		value /= 10;
+	} while (value);
+
+	json_key(j, key);
+	writer_write(j->w, p, num + sizeof(num) - p);
+}
+
+void json_bool(json_writer *j, const char *key, bool value)
+{
+	json_key(j, key);
+	writer_puts(j->w, value ? "true" : "false");
+}
+
+void json_null(json_writer *j, const char *key)
+{
+	json_key(j, key);
+	writer_puts(j->w, "null");
+}
+
+static char *skip_space(char *p)
+{
+	while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+		p++;
+	return p;
+}
+
+static int hex_value(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+/*
+	'p' is on the opening quote. The string is unescaped where it is -
+	it only gets shorter. Returns what follows the closing quote, NULL if
+	the string isn't valid.
+*/
+static char *parse_string(char *p, char **str)
+{
+	char *dst = ++p;
+
+	*str = dst;
+	while (*p != '"')
+	{
+		unsigned int u = 0;
+
+		if ((uint8_t)*p < 0x20)
+			return NULL;
+		if (*p != '\\')
+		{
+			*dst++ = *p++;
+			continue;
+		}
+
+		switch (*++p)
+		{
+		case '"': case '\\': case '/': *dst++ = *p; break;
+		case 'b': *dst++ = '\b'; break;
+		case 'f': *dst++ = '\f'; break;
+		case 'n': *dst++ = '\n'; break;
+		case 'r': *dst++ = '\r'; break;
+		case 't': *dst++ = '\t'; break;
+		case 'u':
+			for (int i = 1; i <= 4; i++)
+			{
+				int v = hex_value(p[i]);
+				if (v < 0)
+					return NULL;
+				u = u << 4 | v;
+			}
+			p += 4;
+
+			// UTF-8 of a character from the first plane is never longer than its escape
+			if (u == 0)
+				return NULL;
+			if (u < 0x80)
+				*dst++ = u;
+			else if (u < 0x800)
+			{
+				*dst++ = 0xC0 | u >> 6;
+				*dst++ = 0x80 | (u & 0x3F);
+			}
+			else
+			{
+				*dst++ = 0xE0 | u >> 12;
+				*dst++ = 0x80 | (u >> 6 & 0x3F);
+				*dst++ = 0x80 | (u & 0x3F);
+			}
+			break;
+		default:
+			return NULL;
+		}
+		p++;
+	}
+
+	*dst = '\0';
+	return p + 1;
+}
+
+int json_parse_flat(char *json, query_index *q)
+{
+	char *p = skip_space(json);
+
+	q->count = 0;
+	if (*p++ != '{')
+		return -1;
+	p = skip_space(p);
+	if (*p == '}')
+		return *skip_space(p + 1) ? -1 : 0;
+
+	while (1)
+	{
+		char *key, *value;
+		char next;
+
+		if (*p != '"' || !(p = parse_string(p, &key)))
+			return -1;
+		p = skip_space(p);
+		if (*p++ != ':')
+			return -1;
+		p = skip_space(p);
+
+		if (*p == '"')
+		{
+			if (!(p = parse_string(p, &value)))
+				return -1;
+			p = skip_space(p);
+			next = *p;
+		}
+		else
+		{
+			// a number or a literal, which ends at the next separator
+			value = p;
+			p += strcspn(p, " \t\r\n,}{[]\"");
+			if (p == value)
+				return -1;
+			next = *p;
+			if (next == ' ' || next == '\t' || next == '\r' || next == '\n')
+			{
+				*p++ = '\0';
+				p = skip_space(p);
+				next = *p;
+			}
+		}
+		if (next != ',' && next != '}')
+			return -1;
+		*p++ = '\0';
+
+		if (q->count == QUERY_MAX_PARAMS)
+			return -1;
+		q->params[q->count].key = key;
+		q->params[q->count].value = value;
+		q->count++;
+
+		if (next == '}')
+			break;
+		p = skip_space(p);
+	}
+
+	return *skip_space(p) ? -1 : q->count;
+}
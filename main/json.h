@@ -0,0 +1,46 @@
+#ifndef _JSON_H
+#define _JSON_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "query.h"
+#include "writer.h"
+
+#define JSON_MAX_DEPTH 8		// nested objects and arrays
+
+/*
+	Writes JSON straight into a response writer, so nothing is built up
+	in memory first. The writer adds the commas; 'key' is the member name
+	inside an object and NULL everywhere else. Nesting deeper than
+	JSON_MAX_DEPTH is not checked.
+*/
+typedef struct json_writer
+{
+	resp_writer *w;
+	uint8_t depth;
+	uint8_t more;			// bit per level: a value has already been written there
+} json_writer;
+
+void json_init(json_writer *j, resp_writer *w);
+void json_object(json_writer *j, const char *key);
+void json_object_end(json_writer *j);
+void json_array(json_writer *j, const char *key);
+void json_array_end(json_writer *j);
+
+// a NULL string is written as null
+void json_str(json_writer *j, const char *key, const char *value);
+void json_int(json_writer *j, const char *key, long value);
+void json_uint(json_writer *j, const char *key, unsigned long value);
+void json_uint64(json_writer *j, const char *key, uint64_t value);
+void json_bool(json_writer *j, const char *key, bool value);
+void json_null(json_writer *j, const char *key);
+
+/*
+	Reads an object of strings, numbers, true, false and null into 'q'.
+	The text is split and unescaped in place; numbers and literals are
+	kept as text. Nested objects and arrays are not accepted. Returns the
+	number of members, or -1 if it isn't such an object.
+*/
+int json_parse_flat(char *json, query_index *q);
+
+#endif // _JSON_H
@@ -1,6 +1,7 @@
 #include <sys/param.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "freertos/event_groups.h"
 #include "esp_system.h"
 #include "esp_wifi.h"
@@ -16,88 +17,122 @@
 #include <time.h>
 #include "lwip/apps/sntp.h"
 #include <sys/types.h>
-#include <esp_ota_ops.h>
-#include <esp_https_ota.h>
 
 #include <esp_http_server.h>
 
+#include "action_hash.h"
+#include "asset.h"
+#include "asset_data.h"
+#include "bench.h"
+#include "bundle.h"
+#include "config.h"
+#include "history.h"
+#include "json.h"
+#include "metrics.h"
+#include "net.h"
+#include "ota.h"
+#include "prof.h"
+#include "push.h"
+#include "query.h"
+#include "schedule.h"
+#include "template_data.h"
+#include "update.h"
+#include "writer.h"
+#include "zone.h"
+
 #define VER_MAJOR 1
 #define VER_MINOR 12
-#define MAX_RESPONSE 1023
 #define WIFI_CONNECT_TIMEOUT (1000000 * 5)
-#define MAX_EVENTS 5					// number of scheduled watering events
-#define MAX_URI_HANDLERS 10		// registered URIs
-#define MAX_ACTIONS 10				// actions take from PUT commands
-#define OTA_BUF_SIZE 256
-#define PAGE_AUTO_REFRESH "15"
+#define SNTP_POLL_PERIOD 1000000	// how often to look for the first NTP answer (us)
+#define SNTP_POLL_TRIES 10			// then the heartbeat and page loads keep checking
+#define MAX_EVENTS SCHEDULE_MAX_EVENTS	// number of scheduled watering events
+#define LEGACY_EVENTS 5				// events also saved for firmware up to v1.12
+#define MAX_URI_HANDLERS (22 + BUNDLE_MAX_FILES)	// registered URIs
+#define MAX_ACTIONS 11				// actions take from PUT commands
+#define PAGE_AUTO_REFRESH "15"		// only without javascript - otherwise /events keeps the page live
 #define MAX_HOSTNAME 32
 #define MAX_TIMEZONE 8
 #define MAX_SSID 32
 #define MAX_PW	64
 #define MAX_UPGRADE_URL 64
-#define MAX_LINE_LENGTH 100
 #define MAX_DURATION 86400 		// maximum event duration in seconds
+#define STRINGIFY(x) #x
+#define STR(x) STRINGIFY(x)
+#define FORM_LIMITS STR(MAX_HOSTNAME) " " STR(MAX_UPGRADE_URL) " " STR(MAX_DURATION)	// in the forms
+#define SCHEDULE_MAX_SLEEP 3600	// longest the scheduler sleeps before checking the clock (seconds)
+#define SCHEDULE_LATE_LIMIT 60	// events missed by more than this many seconds are skipped
+#define HISTORY_PAGE 50			// /api/history records without a limit
+#define HISTORY_PAGE_MAX 500
+#define BATCH_MAX_BODY 2048			// bytes of actions in one /api/batch
+#define BATCH_MAX_ACTIONS 16
+#define BENCH_ROUNDS 100			// of each parameter /debug/bench decodes
+
+// the sdkconfig the firmware was built with - see sdkconfig.release
+#if defined(CONFIG_WATER_OPTIMIZE_SPEED)
+#define BUILD_PROFILE "release-O2"
+#elif defined(CONFIG_COMPILER_OPTIMIZATION_LEVEL_RELEASE)
+#define BUILD_PROFILE "release"
+#else
+#define BUILD_PROFILE "debug"
+#endif
 
 #ifndef PIN2STR
 #define PIN2STR(a) (a)[0], (a)[1], (a)[2], (a)[3], (a)[4], (a)[5], (a)[6], (a)[7]
 #define PINSTR "%c%c%c%c%c%c%c%c"
 #endif
 
+// what changed, for push_render() - the low bits are the zones
+#define PUSH_INTERNET (1U << ZONE_MAX)
+#define PUSH_SCHEDULE (1U << (ZONE_MAX + 1))
+
 #define BLINK_SLOW 1000000
 #define BLINK_FAST 250000
 
-// on the Wemos D1mini board, this is pin D1
-#define WATER_PIN GPIO_NUM_5
-
 
 // forward definitions of handlers for uris
 esp_err_t handler_index(httpd_req_t *req);
 esp_err_t form_hostname(httpd_req_t *req);
 esp_err_t form_add_event(httpd_req_t *req);
-esp_err_t form_set_time(httpd_req_t *req);
 esp_err_t form_set_ntp(httpd_req_t *req);
 esp_err_t form_set_wifi(httpd_req_t *req);
 esp_err_t form_set_upgrade(httpd_req_t *req);
-esp_err_t favicon(httpd_req_t *req);
-esp_err_t action_handler_water_on(const char *query);
-esp_err_t action_handler_water_off(const char *query);
-esp_err_t action_handler_add_event(const char *query);
-esp_err_t action_handler_del_event(const char *query);
-esp_err_t action_handler_set_hostname(const char *query);
-esp_err_t action_handler_update_fw(const char *query);
-esp_err_t action_handler_set_ntp(const char *query);
-esp_err_t action_handler_set_time(const char *query);
-esp_err_t action_handler_set_wifi(const char *query);
-esp_err_t action_handler_set_upgrade_url(const char *query);
-
-// There are 3 kinds of events:
-// skip > 0: every 'skip' seconds
-// skip = 0, days = 0: special case meaning 'every day'
-// skip = 0, days != 0: on the specified days of the week
-typedef struct water_event
-{
-	bool enabled;			// is the event valid
-	uint8_t hour;			// starting hour
-	uint8_t minute;		// starting minute
-	uint8_t skip;			// how many seconds to skip before recurrance (0 = read 'days')
-	uint8_t days;			// bitmap of specific days to execute on
-	uint32_t duration;	// how many seconds before turning off
-} water_event;
+esp_err_t ota_status(httpd_req_t *req);
+esp_err_t api_status(httpd_req_t *req);
+esp_err_t api_events(httpd_req_t *req);
+esp_err_t api_events_add(httpd_req_t *req);
+esp_err_t api_events_del(httpd_req_t *req);
+esp_err_t api_config(httpd_req_t *req);
+esp_err_t api_config_set(httpd_req_t *req);
+esp_err_t api_batch(httpd_req_t *req);
+esp_err_t api_history(httpd_req_t *req);
+esp_err_t debug_boot(httpd_req_t *req);
+esp_err_t debug_bench(httpd_req_t *req);
+esp_err_t handler_metrics(httpd_req_t *req);
+esp_err_t action_handler_water_on(const query_index *q);
+esp_err_t action_handler_water_off(const query_index *q);
+esp_err_t action_handler_add_event(const query_index *q);
+esp_err_t action_handler_del_event(const query_index *q);
+esp_err_t action_handler_set_hostname(const query_index *q);
+esp_err_t action_handler_update_fw(const query_index *q);
+esp_err_t action_handler_check_update(const query_index *q);
+esp_err_t action_handler_set_ntp(const query_index *q);
+esp_err_t action_handler_set_time(const query_index *q);
+esp_err_t action_handler_set_wifi(const query_index *q);
+esp_err_t action_handler_set_upgrade_url(const query_index *q);
+static void schedule_update(void);
+static void schedule_arm(time_t now);
+static void check_internet(void);
 
 typedef struct program_state
 {
 	int led;			// the blue indicator led
-	bool water_on;		// is the water circuit supposed to be on or not
 	bool internet;		// is there a connection to the Internet?
-	time_t last_watering;
-	int last_duration;
-	water_event schedule[MAX_EVENTS];
 } program_state;
 
 struct action
 {
 	char name[16];
-	esp_err_t (*handler)(const char *query);
+	esp_err_t (*handler)(const query_index *q);
 };
 
 static const char *day_str[] =
@@ -111,29 +146,48 @@ static const char *day_str[] =
 	"Saturday"
 };
 
-extern const uint8_t favicon_png_start[] asm("_binary_favicon_png_start");
-extern const uint8_t favicon_png_end[] asm("_binary_favicon_png_end");
-
 static char ntp_server[64] = "pool.ntp.org";
 static char upgrade_url[64] = "http://192.168.20.30/water.bin";
 static char hostname[MAX_HOSTNAME] = "default";
-static char timezone[MAX_TIMEZONE] = "";
+static char tz_name[MAX_TIMEZONE] = "";
 static const char *TAG="APP";
 static const char nvs_namespace[] = "ns_wifi";
 static esp_wps_config_t wps_config = WPS_CONFIG_INIT_DEFAULT(WPS_TYPE_PBC);
 static esp_timer_handle_t blink_timer;
 static esp_timer_handle_t connect_timer;
 static esp_timer_handle_t schedule_timer;
-static esp_timer_handle_t water_timer;
 static esp_timer_handle_t reboot_timer;
+static esp_timer_handle_t sntp_timer;
+static unsigned int sntp_polls;
+static schedule_store schedule;
+static SemaphoreHandle_t schedule_lock;	// the scheduler runs in the timer task
+static uint8_t sched_blob[SCHEDULE_BLOB_SIZE(MAX_EVENTS)];
+static size_t sched_blob_len;
+static legacy_event legacy_schedule[LEGACY_EVENTS];
+static time_t next_fire = SCHEDULE_NEVER;	// when the schedule timer is due to fire
 static program_state state = 
 {
 	.led = 0,
-	.water_on = false,
-	.last_watering = 0,
-	.last_duration = 0,
 	.internet = false,
 };
+// the page loads once and then follows the events from /events
+static const char page_script[] =
+	"<script>\n"
+	"var es = new EventSource('/events');\n"
+	"function plural(n, s) { return n + ' ' + s + (n == 1 ? '' : 's'); }\n"
+	"es.addEventListener('zone', function(e) {\n"
+	"\tvar d = JSON.parse(e.data);\n"
+	"\tdocument.getElementById('z' + d.zone).textContent = d.on ? 'On' : 'Off';\n"
+	"\tdocument.getElementById('l' + d.zone).textContent = d.last_watering && !d.on ?\n"
+	"\t\t'Last watering at ' + new Date(d.last_watering * 1000).toLocaleString() + ' for ' +\n"
+	"\t\tplural(Math.floor(d.last_duration / 60), 'minute') + ' ' + plural(d.last_duration % 60, 'second') : '';\n"
+	"});\n"
+	"es.addEventListener('internet', function(e) {\n"
+	"\tdocument.getElementById('net').textContent = JSON.parse(e.data).internet ? 'connected' : 'disconnected';\n"
+	"});\n"
+	"es.addEventListener('schedule', function() { location.replace('/'); });\n"
+	"</script>\n";
+
 static struct action actions[MAX_ACTIONS] =
 {
 	{
@@ -176,7 +230,12 @@ static struct action actions[MAX_ACTIONS] =
 		.name = "set_upgrade",
 		.handler = action_handler_set_upgrade_url
 	},
+	{
+		.name = "check_update",
+		.handler = action_handler_check_update
+	},
 };
+_Static_assert(ACTION_HASH_COUNT == MAX_ACTIONS, "action_hash.h is out of date");
 
 httpd_uri_t uris[] = {
 {
@@ -200,8 +259,8 @@ httpd_uri_t uris[] = {
 {
     .uri       = "/time",
     .method    = HTTP_GET,
-    .handler   = form_set_time,
-    .user_ctx  = ""
+    .handler   = asset_handler,
+    .user_ctx  = (void*)&asset_time_html
 },
 {
     .uri       = "/add_event",
@@ -230,50 +289,156 @@ httpd_uri_t uris[] = {
 {
     .uri       = "/favicon.ico",
     .method    = HTTP_GET,
-    .handler   = favicon,
+    .handler   = asset_handler,
+    .user_ctx  = (void*)&asset_favicon_png
+},
+{
+    .uri       = "/ota/status",
+    .method    = HTTP_GET,
+    .handler   = ota_status,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/events",
+    .method    = HTTP_GET,
+    .handler   = push_handler,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/debug/boot",
+    .method    = HTTP_GET,
+    .handler   = debug_boot,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/debug/bench",
+    .method    = HTTP_GET,
+    .handler   = debug_bench,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/metrics",
+    .method    = HTTP_GET,
+    .handler   = handler_metrics,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/api/status",
+    .method    = HTTP_GET,
+    .handler   = api_status,
     .user_ctx  = ""
 },
+{
+    .uri       = "/api/events",
+    .method    = HTTP_GET,
+    .handler   = api_events,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/api/events",
+    .method    = HTTP_POST,
+    .handler   = api_events_add,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/api/events",
+    .method    = HTTP_DELETE,
+    .handler   = api_events_del,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/api/config",
+    .method    = HTTP_GET,
+    .handler   = api_config,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/api/config",
+    .method    = HTTP_POST,
+    .handler   = api_config_set,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/api/batch",
+    .method    = HTTP_POST,
+    .handler   = api_batch,
+    .user_ctx  = ""
+},
+{
+    .uri       = "/api/history",
+    .method    = HTTP_GET,
+    .handler   = api_history,
+    .user_ctx  = ""
+},
+};
+
+#define URI_COUNT (sizeof(uris)/sizeof(httpd_uri_t))
+
+/*
+	Each uri is registered with timed_handler() and one of these as its
+	context, which runs the real handler and records how long it took
+*/
+typedef struct uri_timing
+{
+	httpd_uri_t uri;			// as declared
+	uint32_t errors;			// handler didn't return ESP_OK
+	metrics_hist latency;
+} uri_timing;
+
+static uri_timing uri_timings[URI_COUNT + BUNDLE_MAX_FILES];
+static unsigned int timed_count;
+static metrics_hist action_latency[MAX_ACTIONS];
+
+// cycles of the hot paths - see /debug/bench
+static bench_counter bench_index = BENCH_COUNTER("handler_index");
+
+// the settings kept in flash - there is an "evtNN" key for each of the LEGACY_EVENTS events
+static const config_item config_items[] =
+{
+	{ "ntp0", CONFIG_STR, ntp_server, sizeof(ntp_server) },
+	{ "host", CONFIG_STR, hostname, sizeof(hostname) },
+	{ "timezone", CONFIG_STR, tz_name, sizeof(tz_name) },
+	{ "upgrade", CONFIG_STR, upgrade_url, sizeof(upgrade_url) },
+	{ "sched", CONFIG_BLOB, sched_blob, sizeof(sched_blob), &sched_blob_len },
+	{ "evt00", CONFIG_BLOB, &legacy_schedule[0], sizeof(legacy_event) },
+	{ "evt01", CONFIG_BLOB, &legacy_schedule[1], sizeof(legacy_event) },
+	{ "evt02", CONFIG_BLOB, &legacy_schedule[2], sizeof(legacy_event) },
+	{ "evt03", CONFIG_BLOB, &legacy_schedule[3], sizeof(legacy_event) },
+	{ "evt04", CONFIG_BLOB, &legacy_schedule[4], sizeof(legacy_event) },
 };
 
 /*
-	Taken from https://stackoverflow.com/questions/2673207/c-c-url-decode-library
-	This should be in a library somewhere
+	The NVS key of an event in the legacy format
 */
-void urldecode2(char *dst, const char *src)
+static void legacy_key(char *key, uint8_t evt)
+{
+	sprintf(key, "evt%02u", evt);
+}
+
+static void legacy_set(uint8_t evt, const water_event *event)
 {
-	char a, b;
-	while (*src)
+	legacy_event old;
+	char key[10];
+
+	// zero the padding too, so an unchanged event compares equal
+	memset(&old, 0, sizeof(old));
+	if (event)
 	{
-		if ((*src == '%') &&
-			((a = src[1]) && (b = src[2])) &&
-			(isxdigit(a) && isxdigit(b)))
-		{
-			if (a >= 'a')
-				a -= 'a'-'A';
-			if (a >= 'A')
-				a -= ('A' - 10);
-			else
-				a -= '0';
-			if (b >= 'a')
-				b -= 'a'-'A';
-			if (b >= 'A')
-				b -= ('A' - 10);
-			else
-				b -= '0';
-			*dst++ = 16*a+b;
-			src+=3;
-		}
-		else if (*src == '+')
-		{
-			*dst++ = ' ';
-			src++;
-		}
-		else
-		{
-			*dst++ = *src++;
-		}
+		old.enabled = true;
+		old.hour = event->hour;
+		old.minute = event->minute;
+		old.skip = event->skip;
+		old.days = event->days;
+		old.duration = event->duration;
 	}
-	*dst++ = '\0';
+	legacy_key(key, evt);
+	config_set(key, &old);
+}
+
+static bool legacy_equal(const legacy_event *old, const water_event *event)
+{
+	return old->enabled && old->hour == event->hour && old->minute == event->minute
+		&& old->skip == event->skip && old->days == event->days && old->duration == event->duration;
 }
 
 void toggle_led(void)
@@ -311,7 +476,8 @@ int set_hostname(const char *name)
 		return -1;
 	}
 
-	strncpy(hostname, name, MAX_HOSTNAME);
+	if (name != hostname)
+		strncpy(hostname, name, MAX_HOSTNAME);
 
 	// the host name must be set for mDNS and LWIP
 	mdns_hostname_set(hostname);
@@ -326,148 +492,244 @@ void set_timezone(const char *tz)
 		return;
 	}
 
-	strncpy(timezone, tz, 8);
-	setenv("TZ", timezone, 1);
+	if (tz != tz_name)
+		strncpy(tz_name, tz, 8);
+	setenv("TZ", tz_name, 1);
 	tzset();
+
+	// local times of the events have moved
+	schedule_update();
 }
 
-static void turn_water_on(void)
+/*
+	Save the schedule as one blob. The first LEGACY_EVENTS events of the
+	first zone (the only valve older firmware knows) are also kept in the
+	old "evtNN" keys, so an older firmware that is booted after a rollback
+	still finds its schedule. Call with schedule_lock held.
+*/
+static void schedule_save(void)
 {
-	struct tm timeinfo = { 0 };
-	char timestr[64];
+	uint8_t *blob;
+	uint8_t legacy = 0;
 
-	gpio_set_level(WATER_PIN, 1);
-	state.water_on = true;
+	blob = config_edit_begin("sched");
+	config_edit_end("sched", schedule_pack(&schedule, blob, sizeof(sched_blob)));
+
+	for (unsigned int slot = 0; slot < MAX_EVENTS && legacy < LEGACY_EVENTS; slot++)
+	{
+		const water_event *event = schedule_get(&schedule, slot);
+		if (event && event->zone == 0)
+			legacy_set(legacy++, event);
+	}
+	while (legacy < LEGACY_EVENTS)
+		legacy_set(legacy++, NULL);
 
-	// record the time the water started
-	time(&state.last_watering);
-	localtime_r(&state.last_watering, &timeinfo);
-	strftime(timestr, sizeof(timestr), "%c", &timeinfo);
-	ESP_LOGI(TAG, "Water on at %s", timestr);
+	push_notify(PUSH_SCHEDULE);
 }
 
-static void turn_water_off(void)
+/*
+	Read the schedule that config_init() loaded. The legacy keys win if
+	there is no blob yet, or if an older firmware has changed them since
+	the blob was written.
+*/
+static void schedule_load(void)
 {
-	struct tm timeinfo = { 0 };
+	bool legacy_changed = false;
+	uint8_t legacy = 0;
 	time_t now = 0;
-	char timestr[64];
-
-	gpio_set_level(WATER_PIN, 0);
-	state.water_on = false;
 
 	time(&now);
-	localtime_r(&now, &timeinfo);
-	strftime(timestr, sizeof(timestr), "%c", &timeinfo);
+	if (schedule_unpack(&schedule, sched_blob, sched_blob_len, now) >= 0)
+	{
+		for (unsigned int slot = 0; slot < MAX_EVENTS && legacy < LEGACY_EVENTS; slot++)
+		{
+			const water_event *event = schedule_get(&schedule, slot);
+			if (event && event->zone == 0 && !legacy_equal(&legacy_schedule[legacy++], event))
+				legacy_changed = true;
+		}
+		while (legacy < LEGACY_EVENTS)
+		{
+			if (legacy_schedule[legacy++].enabled)
+				legacy_changed = true;
+		}
+		if (!legacy_changed)
+			return;
+
+		// older firmware only knows the first zone - keep the others
+		ESP_LOGI(TAG, "Schedule was changed by an older firmware");
+		for (unsigned int slot = 0; slot < MAX_EVENTS; slot++)
+		{
+			const water_event *event = schedule_get(&schedule, slot);
+			if (event && event->zone == 0)
+				schedule_del(&schedule, slot);
+		}
+	}
+	else
+	{
+		ESP_LOGI(TAG, "Converting schedule from legacy keys");
+		schedule_init(&schedule);
+	}
 
+	for (legacy = 0; legacy < LEGACY_EVENTS; legacy++)
+	{
+		const legacy_event *old = &legacy_schedule[legacy];
+		water_event event;
+
+		if (!old->enabled)
+			continue;
+		event.enabled = true;
+		event.zone = 0;
+		event.hour = old->hour;
+		event.minute = old->minute;
+		event.skip = old->skip;
+		event.days = old->days;
+		event.duration = old->duration;
+		schedule_add(&schedule, &event, now);
+	}
+	schedule_save();
+}
 
-	// record the duration the water was on
-	state.last_duration = now - state.last_watering;
+/*
+	The settings went back to older values (see api_batch()) - use them
+	again, and the schedule they have
+*/
+static void settings_reload(void)
+{
+	time_t now = 0;
 
-	ESP_LOGI(TAG, "Water off at %s", timestr);
+	time(&now);
+	xSemaphoreTake(schedule_lock, portMAX_DELAY);
+	if (schedule_unpack(&schedule, sched_blob, sched_blob_len, now) < 0)
+		schedule_init(&schedule);
+	xSemaphoreGive(schedule_lock);
+	push_notify(PUSH_SCHEDULE);
+
+	set_hostname(hostname);
+	set_timezone(tz_name);		// and works out the times of the events
 }
 
+/*
+	Returns the slot of the new event, -1 if the schedule is full
+*/
 int add_water_event(water_event *new_event)
 {
-	nvs_handle nvs;
+	time_t now = 0;
+	int slot;
 
-	for (uint8_t evt = 0; evt < MAX_EVENTS; evt++)
-	{
-		if (!state.schedule[evt].enabled)
-		{
-			ESP_LOGI(TAG, "Adding event[%u] @%02u:%02u skip=%u days=%u duration=%u", evt,
-				new_event->hour, new_event->minute, new_event->skip, new_event->days, new_event->duration);
-			memcpy(&state.schedule[evt], new_event, sizeof(water_event));
-			state.schedule[evt].enabled = true;
+	time(&now);
+	xSemaphoreTake(schedule_lock, portMAX_DELAY);
+	slot = schedule_add(&schedule, new_event, now);
+	if (slot >= 0)
+		schedule_save();
+	xSemaphoreGive(schedule_lock);
 
-			// save it in NVS
-			if (nvs_open(nvs_namespace, NVS_READWRITE, &nvs) == ESP_OK)
-			{
-				char event_name[10];
-				sprintf(event_name, "evt%02u", evt);
-				nvs_set_blob(nvs, event_name, &state.schedule[evt], sizeof(water_event));
-				nvs_close(nvs);
-			}
+	// no empty slots
+	if (slot < 0)
+		return -1;
 
-			return 0;
-		}
-	}
+	ESP_LOGI(TAG, "Adding event[%u] @%02u:%02u skip=%u days=%u duration=%u", slot,
+		new_event->hour, new_event->minute, new_event->skip, new_event->days, new_event->duration);
+	schedule_arm(now);
+	return slot;
+}
 
-	// no empty slots
-	return -1;
+int del_water_event(unsigned int slot)
+{
+	time_t now = 0;
+	bool deleted;
+
+	xSemaphoreTake(schedule_lock, portMAX_DELAY);
+	deleted = schedule_del(&schedule, slot);
+	if (deleted)
+		schedule_save();
+	xSemaphoreGive(schedule_lock);
+
+	if (!deleted)
+		return -1;
+
+	time(&now);
+	schedule_arm(now);
+	return 0;
 }
 
-int del_water_event(uint8_t evt)
+/*
+	Read the zone parameter - zone 0 if there isn't one
+*/
+static esp_err_t query_zone(const query_index *q, unsigned int *zone)
 {
-	nvs_handle nvs;
+	const char *value = query_get(q, "zone");
 
-	if (evt < MAX_EVENTS)
-	{
-		state.schedule[evt].enabled = false;
+	*zone = 0;
+	if (!value)
+		return ESP_ERR_NOT_FOUND;
 
-		// save it in NVS
-		if (nvs_open(nvs_namespace, NVS_READWRITE, &nvs) == ESP_OK)
-		{
-			char event_name[10];
-			sprintf(event_name, "evt%02u", evt);
-			nvs_set_blob(nvs, event_name, &state.schedule[evt], sizeof(water_event));
-			nvs_close(nvs);
-		}
-		return 0;
+	*zone = atoi(value);
+	if (*zone >= zone_count())
+	{
+		ESP_LOGI(TAG, "No zone %u", *zone);
+		return ESP_ERR_INVALID_ARG;
 	}
-
-	return -1;
+	return ESP_OK;
 }
 
-esp_err_t action_handler_water_on(const char *query)
+esp_err_t action_handler_water_on(const query_index *q)
 {
-	turn_water_on();
+	unsigned int zone;
+
+	if (query_zone(q, &zone) == ESP_ERR_INVALID_ARG)
+		return ESP_FAIL;
+	zone_switch(ZONE_BIT(zone), 0, ZONE_MANUAL);
 	return ESP_OK;
 }
 
-esp_err_t action_handler_water_off(const char *query)
+esp_err_t action_handler_water_off(const query_index *q)
 {
-	turn_water_off();
+	unsigned int zone;
+	esp_err_t err = query_zone(q, &zone);
+
+	// without a zone, everything goes off
+	if (err == ESP_ERR_INVALID_ARG)
+		return ESP_FAIL;
+	zone_switch(0, err == ESP_OK ? ZONE_BIT(zone) : ZONE_ALL, ZONE_MANUAL);
 	return ESP_OK;
 }
 
-esp_err_t action_handler_add_event(const char *query)
+esp_err_t action_handler_add_event(const query_index *q)
 {
 	water_event event;
-	char value[64];
+	unsigned int zone;
+	const char *value;
 
 	memset(&event, 0, sizeof(water_event));
 
-	if (httpd_query_key_value(query, "time", value, 8) == ESP_OK)
+	if (query_zone(q, &zone) == ESP_ERR_INVALID_ARG)
+		return ESP_FAIL;
+	event.zone = zone;
+
+	if ((value = query_get(q, "time")) && strlen(value) >= 5)
 	{
-		char time[8];
-		urldecode2(time, value);
-		event.hour = atoi(time);
-		event.minute = atoi(time+3);
+		event.hour = atoi(value);
+		event.minute = atoi(value+3);
 	}
 
-	if (httpd_query_key_value(query, "skip", value, 4) == ESP_OK)
+	if ((value = query_get(q, "skip")))
 		event.skip = atoi(value);
 
-	if (httpd_query_key_value(query, "d0", value, 3) == ESP_OK && strcmp(value, "on") == 0)
-		event.days |= 1 << 0;
-	if (httpd_query_key_value(query, "d1", value, 3) == ESP_OK && strcmp(value, "on") == 0)
-		event.days |= 1 << 1;
-	if (httpd_query_key_value(query, "d2", value, 3) == ESP_OK && strcmp(value, "on") == 0)
-		event.days |= 1 << 2;
-	if (httpd_query_key_value(query, "d3", value, 3) == ESP_OK && strcmp(value, "on") == 0)
-		event.days |= 1 << 3;
-	if (httpd_query_key_value(query, "d4", value, 3) == ESP_OK && strcmp(value, "on") == 0)
-		event.days |= 1 << 4;
-	if (httpd_query_key_value(query, "d5", value, 3) == ESP_OK && strcmp(value, "on") == 0)
-		event.days |= 1 << 5;
-	if (httpd_query_key_value(query, "d6", value, 3) == ESP_OK && strcmp(value, "on") == 0)
-		event.days |= 1 << 6;
+	// the day checkboxes d0..d6 are only sent when they are ticked
+	for (unsigned int i = 0; i < q->count; i++)
+	{
+		const query_param *param = &q->params[i];
+
+		if (param->key[0] == 'd' && param->key[1] >= '0' && param->key[1] <= '6' && param->key[2] == '\0'
+			&& strcmp(param->value, "on") == 0)
+			event.days |= 1 << (param->key[1] - '0');
+	}
 
 	// special case - every day
 	if (event.days == 0x7F)
 		event.days = 0;
 
-	if (httpd_query_key_value(query, "duration", value, 8) == ESP_OK)
+	if ((value = query_get(q, "duration")))
 	{
 		uint32_t duration = atoi(value);
 		if (duration <= MAX_DURATION)
@@ -480,52 +742,41 @@ esp_err_t action_handler_add_event(const char *query)
 	}
 
 	// add the event
-	if (add_water_event(&event) == 0)
+	if (add_water_event(&event) >= 0)
 		return ESP_OK;
 
 	return ESP_FAIL;
 }
 
-esp_err_t action_handler_del_event(const char *query)
+esp_err_t action_handler_del_event(const query_index *q)
 {
-	char value[10];
-	uint8_t index;
+	const char *value = query_get(q, "index");
 
 	ESP_LOGI(TAG, "Delete event");
-	if (httpd_query_key_value(query, "index", value, 3) == ESP_OK)
+	if (!value)
+		return ESP_ERR_INVALID_ARG;
+	if (del_water_event(atoi(value)) < 0)
 	{
-		index = atoi(value);
-		if (index < MAX_EVENTS)
-			del_water_event(index);
+		ESP_LOGI(TAG, "No event[%s]", value);
+		return ESP_ERR_NOT_FOUND;
 	}
-
 	return ESP_OK;
 }
 
-esp_err_t action_handler_set_hostname(const char *query)
+esp_err_t action_handler_set_hostname(const query_index *q)
 {
-	char value[MAX_HOSTNAME];
-	nvs_handle nvs;
-	esp_err_t err;
+	const char *value = query_get(q, "host");
 
 	ESP_LOGI(TAG, "Set hostname");
 
-	err = httpd_query_key_value(query, "host", value, MAX_HOSTNAME);
-	if ((err == ESP_OK) && (nvs_open(nvs_namespace, NVS_READWRITE, &nvs) == ESP_OK))
+	if (!value)
+		return ESP_OK;
+	if (strlen(value) < MAX_HOSTNAME)
 	{
-		size_t length;
-		char old_value[MAX_HOSTNAME];
-
-		// check if the value has changed
-		length = MAX_HOSTNAME;
-		if (nvs_get_str(nvs, "host", old_value, &length) != ESP_OK || strcmp(old_value, value) != 0)
-		{
-			nvs_set_str(nvs, "host", value);
-			set_hostname(value);
-		}
-		nvs_close(nvs);
+		config_set("host", value);
+		set_hostname(hostname);
 	}
-	else if (err == ESP_ERR_HTTPD_RESULT_TRUNC)
+	else
 	{
 		ESP_LOGE(TAG, "name too long (max %u)", MAX_HOSTNAME-1);
 		return ESP_ERR_HTTPD_RESP_HDR;
@@ -534,54 +785,38 @@ esp_err_t action_handler_set_hostname(const char *query)
 	return ESP_OK;
 }
 
-esp_err_t action_handler_set_ntp(const char *query)
+esp_err_t action_handler_set_ntp(const query_index *q)
 {
-	char value[64];
-	nvs_handle nvs;
+	const char *value = query_get(q, "server");
 
 	ESP_LOGI(TAG, "Set NTP host");
-	if ((httpd_query_key_value(query, "server", value, 64) == ESP_OK)
-		&& (nvs_open(nvs_namespace, NVS_READWRITE, &nvs) == ESP_OK))
-	{
-		size_t length;
-		char old_value[64];
-
-		// check if the value has changed
-		length = 64;
-		if (nvs_get_str(nvs, "ntp0", old_value, &length) != ESP_OK || strcmp(old_value, value) != 0)
-		{
-			nvs_set_str(nvs, "ntp0", value);
-			strcpy(ntp_server, value);
-		}
-		nvs_close(nvs);
-	}
+	if (value)
+		config_set("ntp0", value);
 
 	return ESP_OK;
 }
 
-esp_err_t action_handler_set_time(const char *query)
+esp_err_t action_handler_set_time(const query_index *q)
 {
-	char value[64];
-	char time_buf[64];
+	const char *value = query_get(q, "time");
 	struct tm timeinfo = { 0 };
 	struct timeval newtime;
 
-	if (httpd_query_key_value(query, "time", value, 20) == ESP_OK)
-	{
-		urldecode2(time_buf, value);
-		strptime(time_buf, "%Y-%m-%dT%R", &timeinfo);
-	}
+	if (value)
+		strptime(value, "%Y-%m-%dT%R", &timeinfo);
 
 	newtime.tv_usec = 0;
 	newtime.tv_sec = mktime(&timeinfo);
 	settimeofday(&newtime, NULL);
 
+	schedule_update();
+
 	return ESP_OK;
 }
 
-esp_err_t action_handler_set_wifi(const char *query)
+esp_err_t action_handler_set_wifi(const query_index *q)
 {
-	char value[64];
+	const char *value;
 	bool new_ssid = false;
 	bool new_pw = false;
 	wifi_config_t curr_config, new_config;
@@ -590,18 +825,18 @@ esp_err_t action_handler_set_wifi(const char *query)
 	memcpy(&new_config, &curr_config, sizeof(wifi_config_t));
 
 	// parse the parameters to find the new ssid name
-	if (httpd_query_key_value(query, "ssid", value, MAX_SSID) == ESP_OK)
+	if ((value = query_get(q, "ssid")) && strlen(value) < MAX_SSID)
 	{
-		urldecode2((char*)new_config.sta.ssid, value);
+		strcpy((char*)new_config.sta.ssid, value);
 		if (memcmp(new_config.sta.ssid, curr_config.sta.ssid, MAX_SSID) != 0)
 		{
 			new_ssid = true;
 			ESP_LOGI(TAG, "ssid: %s", (char*)new_config.sta.ssid);
 		}
 	}
-	if (httpd_query_key_value(query, "pw", value, MAX_PW) == ESP_OK)
+	if ((value = query_get(q, "pw")) && strlen(value) < MAX_PW)
 	{
-		urldecode2((char*)new_config.sta.password, value);
+		strcpy((char*)new_config.sta.password, value);
 		if (memcmp(new_config.sta.password, curr_config.sta.password, MAX_PW) != 0)
 		{
 			new_pw = true;
@@ -623,153 +858,80 @@ esp_err_t action_handler_set_wifi(const char *query)
 	return ESP_OK;
 }
 
-esp_err_t action_handler_set_upgrade_url(const char *query)
+esp_err_t action_handler_set_upgrade_url(const query_index *q)
 {
-	// add a few extra bytes to account for url encoding
-	char value[MAX_UPGRADE_URL+16];
-	nvs_handle nvs;
+	const char *value = query_get(q, "url");
 
 	ESP_LOGI(TAG, "Set Upgrade URL");
-	if ((httpd_query_key_value(query, "url", value, MAX_UPGRADE_URL+16) == ESP_OK)
-		&& (nvs_open(nvs_namespace, NVS_READWRITE, &nvs) == ESP_OK))
-	{
-		size_t length;
-		char new_value[MAX_UPGRADE_URL];
-		char old_value[MAX_UPGRADE_URL];
-
-		// decode and check final length
-		urldecode2(new_value, value);
-		if (strlen(new_value) >= MAX_UPGRADE_URL)
-			return ESP_FAIL;
-
-		// check if the value has changed
-		length = MAX_UPGRADE_URL;
-		if (nvs_get_str(nvs, "upgrade", old_value, &length) != ESP_OK || strcmp(old_value, new_value) != 0)
-		{
-			nvs_set_str(nvs, "upgrade", new_value);
-			strcpy(upgrade_url, new_value);
-		}
-		nvs_close(nvs);
-	}
 
-	return ESP_OK;
-}
+	// the store checks the length
+	if (value && config_set("upgrade", value) != ESP_OK)
+		return ESP_FAIL;
 
-esp_err_t http_client_event_handler(esp_http_client_event_t *evt)
-{
-	// don't really need to handle any events yet
 	return ESP_OK;
 }
 
-esp_err_t action_handler_update_fw(const char *query)
+/*
+	Called from the update task when the new firmware is in place
+*/
+static void update_fw_done(esp_err_t err)
 {
-	const esp_partition_t *update_partition = NULL;
-	esp_ota_handle_t update_handle = 0;
-	char *upgrade_data_buf;
-	int binary_file_len = 0;
-	esp_http_client_handle_t client;
-	esp_http_client_config_t config =
-	{
-		.url = upgrade_url,
-		.event_handler = http_client_event_handler,
-	};
-
-
-	client = esp_http_client_init(&config);
-	if (!client)
-	{
-		ESP_LOGE(TAG, "Error initializing http client");
-		return ESP_FAIL;
-	}
-
-	if (esp_http_client_open(client, 0) != ESP_OK)
-	{
-		ESP_LOGE(TAG, "Error opening http client");
-		esp_http_client_cleanup(client);
-		return ESP_FAIL;
-	}
-
-	esp_http_client_fetch_headers(client);
-
-	update_partition = esp_ota_get_next_update_partition(NULL);
-	if (!update_partition)
+	update_done(err);
+	if (err != ESP_OK)
 	{
-		ESP_LOGE(TAG, "Can't find partition for update");
-		esp_http_client_cleanup(client);
-		return ESP_FAIL;
+		ESP_LOGE(TAG, "Update failed (%d)", err);
+		return;
 	}
 
-	ESP_LOGI(TAG, "Writing to partition type %i at offset 0x%x",
-		update_partition->subtype, update_partition->address);
+	// schedule reboot to occur after we make sure it's safe
+	ESP_LOGI(TAG, "Update done - rebooting");
+	esp_timer_start_once(reboot_timer, 1000000);
+}
 
-	if (esp_ota_begin(update_partition, OTA_SIZE_UNKNOWN, &update_handle) != ESP_OK)
-	{
-		ESP_LOGE(TAG, "Can't start upgrade");
-		esp_http_client_cleanup(client);
-		return ESP_FAIL;
-	}
+/*
+	The download runs in the background - progress is on /ota/status
+*/
+esp_err_t action_handler_update_fw(const query_index *q)
+{
+	esp_err_t err = ota_start(upgrade_url, NULL, update_fw_done);
 
-	ESP_LOGI(TAG, "allocating %u bytes", OTA_BUF_SIZE);
-	upgrade_data_buf = (char*)malloc(OTA_BUF_SIZE);
-	if (!upgrade_data_buf)
-	{
-		ESP_LOGE(TAG, "Can't allocate memory");
-		esp_http_client_cleanup(client);
-		return ESP_FAIL;
-	}
+	if (err == ESP_ERR_INVALID_STATE)
+		ESP_LOGW(TAG, "Update already running");
+	else if (err != ESP_OK)
+		ESP_LOGE(TAG, "Can't start update (%d)", err);
+	return err == ESP_ERR_INVALID_STATE ? ESP_OK : err;
+}
 
-	ESP_LOGI(TAG, "Updating");
-	binary_file_len = 0;
-	while (1)
+/*
+	The version manifest has something newer. A reboot in the middle of
+	a watering would cut it short, so that waits for the next check.
+*/
+static esp_err_t update_available(const char *url, const char *sha256)
+{
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
 	{
-		int data_read = esp_http_client_read(client, upgrade_data_buf, OTA_BUF_SIZE);
-		if (data_read == 0)
-			break;
-
-		if (data_read < 0)
-		{
-			ESP_LOGE(TAG, "Error reading socket");
-			free(upgrade_data_buf);
-			esp_http_client_cleanup(client);
-			return ESP_FAIL;
-		}
+		zone_status zs;
 
-		if (esp_ota_write(update_handle, upgrade_data_buf, data_read) != ESP_OK)
+		zone_get_status(zone, &zs);
+		if (zs.on)
 		{
-			ESP_LOGE(TAG, "Error writing fw");
-			free(upgrade_data_buf);
-			esp_http_client_cleanup(client);
-			return ESP_FAIL;
+			ESP_LOGI(TAG, "Watering - the update waits");
+			return ESP_ERR_INVALID_STATE;
 		}
-		binary_file_len += data_read;
-	}
-	free(upgrade_data_buf);
-	esp_http_client_cleanup(client);
-
-	if (esp_ota_end(update_handle) != ESP_OK)
-	{
-		ESP_LOGE(TAG, "Upgrade failed");
-		return ESP_FAIL;
 	}
-
-	if (esp_ota_set_boot_partition(update_partition) != ESP_OK)
-	{
-		ESP_LOGE(TAG, "Can't set boot partition");
-		return ESP_FAIL;
-	}
-
-	// schedule reboot to occur after we make sure it's safe
-	ESP_LOGI(TAG, "Update done - rebooting");
-	esp_timer_start_once(reboot_timer, 1000000);
-	return ESP_OK;
+	return ota_start(url, sha256, update_fw_done);
 }
 
 /*
-	Time to turn off the water
+	Look at the version manifest now rather than at the next check
 */
-void water_callback(void *arg)
+esp_err_t action_handler_check_update(const query_index *q)
 {
-	turn_water_off();
+	esp_err_t err = update_check();
+
+	if (err == ESP_ERR_INVALID_STATE)
+		ESP_LOGW(TAG, "Already checking");
+	return err == ESP_ERR_INVALID_STATE ? ESP_OK : err;
 }
 
 /*
@@ -778,7 +940,9 @@ void water_callback(void *arg)
 void reboot_callback(void *arg)
 {
 	ESP_LOGI(TAG, "Rebooting");
-	turn_water_off();
+	zone_switch(0, ZONE_ALL, ZONE_REBOOT);
+	history_flush();
+	config_flush();
 	esp_restart();
 }
 
@@ -794,57 +958,118 @@ static void obtain_time(void)
 }
 
 /*
-	Call this periodically to perform various tasks
-	(turn on the water, update the date/time, etc.)
+	Wait for the NTP server without holding up the event loop
 */
-void scheduler(void *arg)
+static void sntp_poll(void *arg)
 {
-	time_t now = 0;
-	struct tm timeinfo = { 0 };
-	uint8_t evt;
-
-	time(&now);
-	localtime_r(&now, &timeinfo);
+	check_internet();
+	if (state.internet || ++sntp_polls >= SNTP_POLL_TRIES)
+		esp_timer_stop(sntp_timer);
+}
 
-	// set the state of the Internet connection
+/*
+	Update the state of the Internet connection. When it comes up, SNTP has
+	just set the clock so the schedule has to be recalculated.
+*/
+static void check_internet(void)
+{
 	if (sntp_getreachability(0) == 0 && state.internet == true)
 	{
 		ESP_LOGI(TAG, "Internet is down");
 		state.internet = false;
+		if (net_get_state() == NET_ONLINE)
+			net_set_state(NET_SNTP);
+		push_notify(PUSH_INTERNET);
 	}
 	else if (sntp_getreachability(0) != 0 && state.internet != true)
 	{
 		ESP_LOGI(TAG, "Internet is up");
 		state.internet = true;
+		if (net_get_state() == NET_SNTP)
+			net_set_state(NET_ONLINE);
+		push_notify(PUSH_INTERNET);
+		schedule_update();
 	}
+}
 
-	// iterate through all events
-	for (evt = 0; evt < MAX_EVENTS; evt++)
-	{
-		water_event *event = &state.schedule[evt];
-		if (event->enabled)
-		{
-			if (event->skip > 0)
-			{
-				if (now % event->skip == 0)
-				{
-					turn_water_on();
-					esp_timer_start_once(water_timer, event->duration * 1000000);
-				}
-			}
-			else
-			{
-				if (event->days == 0 || event->days & (1 << timeinfo.tm_wday))
-				{
-					if (timeinfo.tm_hour == event->hour && timeinfo.tm_min == event->minute)
-					{
-						turn_water_on();
-						esp_timer_start_once(water_timer, event->duration * 1000000);
-					}
-				}
-			}
-		}
+/*
+	Arm the schedule timer for the first event. It never sleeps longer than
+	SCHEDULE_MAX_SLEEP so that drift between the timer and the wall clock
+	can't build up.
+*/
+static void schedule_arm(time_t now)
+{
+	time_t delay;
+
+	xSemaphoreTake(schedule_lock, portMAX_DELAY);
+	next_fire = schedule_peek(&schedule, NULL);
+	xSemaphoreGive(schedule_lock);
+
+	esp_timer_stop(schedule_timer);
+	if (next_fire == SCHEDULE_NEVER)
+		delay = SCHEDULE_MAX_SLEEP;
+	else if (next_fire <= now)
+		delay = 0;
+	else
+		delay = MIN(next_fire - now, SCHEDULE_MAX_SLEEP);
+
+	esp_timer_start_once(schedule_timer, (uint64_t)delay * 1000000);
+}
+
+/*
+	Work out when each event fires next. Call this whenever the clock or
+	the timezone changes.
+*/
+static void schedule_update(void)
+{
+	time_t now = 0;
+
+	time(&now);
+	xSemaphoreTake(schedule_lock, portMAX_DELAY);
+	schedule_rebuild(&schedule, now);
+	xSemaphoreGive(schedule_lock);
+	schedule_arm(now);
+}
+
+/*
+	Called by the schedule timer when the next event is due
+	(or SCHEDULE_MAX_SLEEP has passed)
+*/
+void scheduler(void *arg)
+{
+	time_t now = 0;
+	time_t due;
+	unsigned int slot;
+	uint32_t zones = 0;
+
+	time(&now);
+	check_internet();
+
+	xSemaphoreTake(schedule_lock, portMAX_DELAY);
+
+	// if the clock jumped forward, don't run everything we skipped over
+	due = schedule_peek(&schedule, NULL);
+	if (due != SCHEDULE_NEVER && now - due > SCHEDULE_LATE_LIMIT)
+	{
+		ESP_LOGI(TAG, "Clock moved - skipping missed events");
+		schedule_rebuild(&schedule, now - SCHEDULE_LATE_LIMIT);
+	}
+
+	// start all events that are due, and open their valves together
+	while ((due = schedule_peek(&schedule, &slot)) != SCHEDULE_NEVER && due <= now)
+	{
+		const water_event *event = schedule_get(&schedule, slot);
+
+		ESP_LOGI(TAG, "Starting event[%u] in %s", slot, zone_name(event->zone));
+		zones |= ZONE_BIT(event->zone);
+		zone_arm(event->zone, event->duration, slot);
+		schedule_fired(&schedule);
 	}
+
+	xSemaphoreGive(schedule_lock);
+	if (zones)
+		zone_switch(zones, 0, ZONE_SCHEDULE);
+	schedule_arm(now);
 }
 
 void no_connect_callback(void *arg)
@@ -860,69 +1085,89 @@ void no_connect_callback(void *arg)
 
 esp_err_t handler_help(httpd_req_t *req)
 {
-	char line[MAX_LINE_LENGTH+1];
-	char resp_str[MAX_RESPONSE];
-	resp_str[0] = 0;
+	const page_help_args args =
+	{
+		.major = VER_MAJOR,
+		.minor = VER_MINOR,
+		.max_hostname = MAX_HOSTNAME,
+	};
+	resp_writer w;
+
+	writer_init(&w, req);
+	page_help(&w, &args);
+	return writer_finish(&w);
+}
+
+/*
+	The index in actions[] of an action name, -1 if there is no such action.
+	The table comes from tools/gen_action_hash.py - run it again after
+	changing actions[].
+*/
+static int find_action(const char *name)
+{
+	uint8_t idx = action_hash[ACTION_HASH_BUCKET(query_hash(name, ACTION_HASH_SEED))];
+
+	if (idx == ACTION_HASH_EMPTY || strcmp(name, actions[idx].name) != 0)
+		return -1;
+	return idx;
+}
 
-	strcat(resp_str, "<html><title>Watering System - Help</title>\n<body>\n");
-	snprintf(line, MAX_LINE_LENGTH, "<h1>Joel's Watering System v%u.%u</h1>\n", VER_MAJOR, VER_MINOR);
-	strcat(resp_str, line);
-	strcat(resp_str, "<h2>Command Help</h2><table><tr><td>Action<td>Parameters<td>Description<td>Example</tr>\n");
-	strcat(resp_str, "<tr><td>water_on<td><td>Turn water on now<td>http://192.168.1.1/?action=water_on</tr>\n");
-	strcat(resp_str, "<tr><td>water_off<td><td>Turn water off now<td>http://192.168.1.1/?action=water_off</tr>\n");
-	strcat(resp_str, "<tr><td>add_event<td>time=[hh:mm], d0..d6=[on|off], duration=[secs]<td>Schedule a new watering event<td>http://192.168.1.1/?action=add_event&time=14%0e30&d1=on&d3=on&duration=60</tr>\n");
-	strcat(resp_str, "<tr><td><td>time=[hh:mm], skip=[secs], duration=[secs]<td>Schedule a new watering event, repeating every N seconds<td>http://192.168.1.1/?action=add_event&time=14%0e30&skip=3600&duration=15</tr>\n");
-	strcat(resp_str, "<tr><td>del_event<td>index=&lt;event&gt;<td>Delete an existing event<td></tr>\n");
-	snprintf(line, 100, "<tr><td>set_hostname<td>host=&lt;name&gt;<td>Set a new hostname (max %u chars)<td></tr>\n", MAX_HOSTNAME);
-	strcat(resp_str, line);
-	strcat(resp_str, "</table><br><br>\n");
-	strcat(resp_str, "<a href=\"/\">Return to main page</a>\n");
-	strcat(resp_str, "</body></html>");
+static esp_err_t run_action(int idx, const query_index *q)
+{
+	int64_t start = esp_timer_get_time();
+	esp_err_t err;
 
-	return httpd_resp_send(req, resp_str, strlen(resp_str));
+	ESP_LOGI(TAG, "action: %s", actions[idx].name);
+	err = actions[idx].handler(q);
+	metrics_observe(&action_latency[idx], esp_timer_get_time() - start);
+	return err;
 }
 
 /*
 	The main HTML page
 */
-esp_err_t handler_index(httpd_req_t *req)
+static esp_err_t index_page(httpd_req_t *req)
 {
 	time_t now = 0;
 	struct tm timeinfo = { 0 };
 	wifi_config_t wifi_config;
 	char line[110];
-	char resp_str[MAX_RESPONSE];
 	char query[256];
-	uint8_t num_events = 0;
-	uint8_t evt;
+	query_index q;
+	const char *action;
+	resp_writer w;
+	unsigned int num_events = 0;
+	unsigned int evt;
 	uint8_t mac[7];
 	wifi_ap_record_t ap_info;
+	ota_status_t ota;
 	esp_err_t err = ESP_OK;
 	bool command = false;
-	uint8_t action_idx;
+	int action_idx = -1;
+	const bundle_file *ui;
+
+	// the UI from flash replaces this page, which is still at /index.html and for clients that can't take it
+	if (strcmp(req->uri, "/") == 0 && (ui = bundle_find("/ui/index.html")) && bundle_acceptable(req, ui))
+		return bundle_send(req, ui);
+
+	check_internet();
 
 	// find out what the user wants to do
 	if (httpd_req_get_url_query_str(req, query, 256) == ESP_OK)
 	{
 		ESP_LOGI(TAG, "Query: %s", query);
-		if (httpd_query_key_value(query, "action", line, sizeof(line)) == ESP_OK)
+		query_parse(&q, query);
+		if ((action = query_get(&q, "action")))
 		{
-			for (action_idx = 0; action_idx < MAX_ACTIONS; action_idx++)
-			{
-				if (strcmp(line, actions[action_idx].name) == 0)
-				{
-					ESP_LOGI(TAG, "action: %s", actions[action_idx].name);
-					err = actions[action_idx].handler(query);
-					command = true;
-					break;
-				}
-			}
-
-			if (action_idx == MAX_ACTIONS)
+			action_idx = find_action(action);
+			if (action_idx < 0)
 			{
 				// user needs help
 				return handler_help(req);
 			}
+
+			err = run_action(action_idx, &q);
+			command = true;
 		}
 	}
 
@@ -935,67 +1180,76 @@ esp_err_t handler_index(httpd_req_t *req)
 	localtime_r(&now, &timeinfo);
 	strftime(line, sizeof(line), "%c", &timeinfo);
 
-	resp_str[0] = 0;
-	strcat(resp_str, "<html><head><meta http-equiv=\"refresh\" content=\"" PAGE_AUTO_REFRESH ";url=/\"><title>Watering System</title></head>\n<body>\n");
-	snprintf(line, MAX_LINE_LENGTH, "<h1>Joel's Watering System v%u.%u</h1>\n", VER_MAJOR, VER_MINOR);
-	strcat(resp_str, line);
-	strcat(resp_str, "<h2>Status</h2><table><tr><td>Time<td>\n");
+	writer_init(&w, req);
+	writer_puts(&w, "<html><head><noscript><meta http-equiv=\"refresh\" content=\"" PAGE_AUTO_REFRESH ";url=/\"></noscript><title>Watering System</title></head>\n<body>\n");
+	writer_printf(&w, "<h1>Joel's Watering System v%u.%u</h1>\n", VER_MAJOR, VER_MINOR);
+	writer_puts(&w, "<h2>Status</h2><table><tr><td>Time<td>\n");
 	strftime(line, sizeof(line), "%c <a href=/time>[*]</a></tr>", &timeinfo);
-	strcat(resp_str, line);
-
-	snprintf(line, MAX_LINE_LENGTH, "<td>Water<td>%s</tr>\n", state.water_on ? "On" : "Off");
-	strcat(resp_str, line);
+	writer_puts(&w, line);
 
-	if (state.last_watering)
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
 	{
-		snprintf(line, MAX_LINE_LENGTH, "<td>Last watering at<td>%s for %i minute%s %i second%s</tr>\n",
-			ctime(&state.last_watering), state.last_duration / 60,
-			(state.last_duration / 60 == 1) ? "" : "s",
-			state.last_duration % 60,
-			(state.last_duration % 60 == 1) ? "" : "s");
-		strcat(resp_str, line);
+		zone_status zs;
+
+		zone_get_status(zone, &zs);
+		writer_printf(&w, "<tr><td>%s<td id=z%u>%s</tr>\n", zone_name(zone), zone, zs.on ? "On" : "Off");
+		writer_printf(&w, "<tr><td><td id=l%u>", zone);
+		if (zs.last_watering && !zs.on)
+		{
+			writer_printf(&w, "Last watering at %s for %i minute%s %i second%s",
+				ctime(&zs.last_watering), zs.last_duration / 60,
+				(zs.last_duration / 60 == 1) ? "" : "s",
+				zs.last_duration % 60,
+				(zs.last_duration % 60 == 1) ? "" : "s");
+		}
+		writer_puts(&w, "</tr>\n");
 	}
 
 	// print the status if we executed a command
 	if (command)
 	{
 		if (err == ESP_OK)
-			snprintf(line, 100, "<tr><td><td>%s command ok</tr>\n", actions[action_idx].name);
+			writer_printf(&w, "<tr><td><td>%s command ok</tr>\n", actions[action_idx].name);
 		else
-			snprintf(line, 100, "<tr><td><td>%s command failed: %u</tr>\n", actions[action_idx].name, err);
-		strcat(resp_str, line);
+			writer_printf(&w, "<tr><td><td>%s command failed: %u</tr>\n", actions[action_idx].name, err);
 	}
-	strcat(resp_str, "</table>\n");
+	writer_puts(&w, "</table>\n");
 
-	strcat(resp_str, "<h2>Schedule</h2>\n");
+	writer_puts(&w, "<h2>Schedule</h2>\n");
 	for (evt = 0; evt < MAX_EVENTS; evt++)
 	{
 		bool first_day = true;
-		water_event *event = &state.schedule[evt];
-
-		if (event->enabled)
+		const water_event *found;
+		water_event copy;
+		const water_event *event = &copy;
+
+		// copy the event so the lock isn't held while the page is sent
+		xSemaphoreTake(schedule_lock, portMAX_DELAY);
+		found = schedule_get(&schedule, evt);
+		if (found)
+			copy = *found;
+		xSemaphoreGive(schedule_lock);
+
+		if (found)
 		{
-			snprintf(line, 100, "[%u] ", evt);
-			strcat(resp_str, line);
+			writer_printf(&w, "[%u] %s: ", evt, zone_name(event->zone));
 
 			num_events++;
 			if (event->skip)
 			{
-				snprintf(line, 100, "Every %u seconds at %02u:%02u for %u seconds",
+				writer_printf(&w, "Every %u seconds at %02u:%02u for %u seconds",
 					event->skip+1, event->hour, event->minute, event->duration);
-				strcat(resp_str, line);
 			}
 			else
 			{
 				if (event->days == 0)
 				{
-					snprintf(line, 100, "Every day at %02u:%02u for %u seconds",
+					writer_printf(&w, "Every day at %02u:%02u for %u seconds",
 						event->hour, event->minute, event->duration);
-					strcat(resp_str, line);
 				}
 				else
 				{
-					strcat(resp_str, "Every week on ");
+					writer_puts(&w, "Every week on ");
 					for (uint8_t day = 0; day < 7; day++)
 					{
 						if (event->days & (1 << day))
@@ -1003,211 +1257,1098 @@ esp_err_t handler_index(httpd_req_t *req)
 							if (first_day)
 								first_day = false;
 							else
-								strcat(resp_str, ", ");
-							strcat(resp_str, day_str[day]);
+								writer_puts(&w, ", ");
+							writer_puts(&w, day_str[day]);
 						}
 					}
-					snprintf(line, 100, " at %02u:%02u for %u seconds",
+					writer_printf(&w, " at %02u:%02u for %u seconds",
 						event->hour, event->minute, event->duration);
-					strcat(resp_str, line);
 				}
 			}
 
 			// add link for removing the event
-			snprintf(line, 100, " <a href=/?action=del_event&index=%u>[-]</a><br>\n", evt);
-			strcat(resp_str, line);
+			writer_printf(&w, " <a href=/?action=del_event&index=%u>[-]</a><br>\n", evt);
 		}
 	}
 
 	if (num_events == 0)
-		strcat(resp_str, "No scheduled events<br>");
+		writer_puts(&w, "No scheduled events<br>");
 	if (num_events < MAX_EVENTS)
-		strcat(resp_str, "<a href=/add_event>[+] Add event</a><br>\n");
-
-	strcat(resp_str, "<h2>Networking</h2>\n<table>");
-	snprintf(line, 100, "<tr><td>Access Point<td>%s <a href=/wifi>[*]</a></tr>\n", wifi_config.sta.ssid);
-	strcat(resp_str, line);
-	snprintf(line, 128, "<tr><td>NTP Server<td>%s <a href=/ntp>[*]</a></tr>\n", ntp_server);
-	strcat(resp_str, line);
-	snprintf(line, 128, "<tr><td>Upgrade URL<td>%s <a href=/upgrade>[*]</a></tr>\n", upgrade_url);
-	strcat(resp_str, line);
-	snprintf(line, 100, "<tr><td>Hostname<td>%s <a href=/hostname>[*]</a></tr>\n", hostname);
-	strcat(resp_str, line);
-	snprintf(line, 100, "<tr><td>MAC<td>%02x:%02x:%02x:%02x:%02x:%02x</tr>\n",
+		writer_puts(&w, "<a href=/add_event>[+] Add event</a><br>\n");
+
+	writer_puts(&w, "<h2>Networking</h2>\n<table>");
+	writer_puts(&w, "<tr><td>Access Point<td>");
+	writer_escape(&w, (const char *)wifi_config.sta.ssid, MAX_SSID, WRITER_HTML);
+	writer_puts(&w, " <a href=/wifi>[*]</a></tr>\n<tr><td>NTP Server<td>");
+	writer_escape(&w, ntp_server, sizeof(ntp_server), WRITER_HTML);
+	writer_puts(&w, " <a href=/ntp>[*]</a></tr>\n<tr><td>Upgrade URL<td>");
+	writer_escape(&w, upgrade_url, sizeof(upgrade_url), WRITER_HTML);
+	writer_puts(&w, " <a href=/upgrade>[*]</a></tr>\n<tr><td>Hostname<td>");
+	writer_escape(&w, hostname, sizeof(hostname), WRITER_HTML);
+	writer_puts(&w, " <a href=/hostname>[*]</a></tr>\n");
+	writer_printf(&w, "<tr><td>MAC<td>%02x:%02x:%02x:%02x:%02x:%02x</tr>\n",
 		mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-	strcat(resp_str, line);
-	snprintf(line, 100, "<tr><td>Signal strength<td>%i dBm</tr>", ap_info.rssi);
-	strcat(resp_str, line);
-	snprintf(line, 100, "<tr><td>Internet<td>%s</tr>\n", state.internet ? "connected" : "disconnected");
-	strcat(resp_str, line);
-	strcat(resp_str, "</table>\n");
-
-	strcat(resp_str, "<h2>Control</h2>\n");
-	if (state.water_on)
-		snprintf(line, 100, "<a href=\"/?action=water_off\">Water Off</a><br>\n");
+	writer_printf(&w, "<tr><td>Signal strength<td>%i dBm</tr>", ap_info.rssi);
+	writer_printf(&w, "<tr><td>Internet<td id=net>%s</tr>\n", state.internet ? "connected" : "disconnected");
+	writer_puts(&w, "</table>\n");
+
+	writer_puts(&w, "<h2>Control</h2>\n");
+	ota_get_status(&ota);
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
+	{
+		zone_status zs;
+
+		zone_get_status(zone, &zs);
+		writer_printf(&w, "<a href=\"/?action=water_%s&zone=%u\">%s %s</a><br>\n",
+			zs.on ? "off" : "on", zone, zone_name(zone), zs.on ? "Off" : "On");
+	}
+	if (ota.state == OTA_CONNECTING || ota.state == OTA_DOWNLOADING)
+	{
+		writer_printf(&w, "Updating firmware: %u", (unsigned int)ota.bytes_written);
+		if (ota.bytes_total)
+			writer_printf(&w, " of %u", (unsigned int)ota.bytes_total);
+		writer_puts(&w, " bytes<br>\n");
+	}
 	else
-		snprintf(line, 100, "<a href=\"/?action=water_on\">Water On</a><br>\n");
-	strcat(resp_str, line);
-	strcat(resp_str, "<a href=\"/?action=update_fw\">Update Firmware</a><br>\n");
-	strcat(resp_str, "<a href=\"/?action=help\">Help</a><br>\n");
-	strcat(resp_str, "</body></html>");
+	{
+		if (ota.state == OTA_FAILED)
+			writer_puts(&w, "Firmware update failed<br>\n");
+		writer_puts(&w, "<a href=\"/?action=update_fw\">Update Firmware</a><br>\n");
+	}
+	writer_puts(&w, "<a href=\"/?action=help\">Help</a><br>\n");
+	writer_puts(&w, page_script);
+	writer_puts(&w, "</body></html>");
+
+	return writer_finish(&w);
+}
+
+// counts the cycles of the page and any action, including handing the page to lwIP
+esp_err_t handler_index(httpd_req_t *req)
+{
+	uint32_t start = bench_start();
+	esp_err_t err = index_page(req);
 
-	httpd_resp_send(req, resp_str, strlen(resp_str));
+	bench_end(&bench_index, start);
+	return err;
+}
 
-	return ESP_OK;
+/*
+	The forms are only sent again when what they show has changed: the
+	template (main/templates), the limits it is given and 'value'. The
+	header points to 'etag' until the response is sent.
+*/
+static bool form_not_modified(httpd_req_t *req, char *etag, const template_page *page, const char *value)
+{
+	const char *values[] = { page->hash, FORM_LIMITS, value };
+
+	asset_etag(etag, values, value ? 3 : 2);
+	return asset_not_modified(req, etag, "no-cache");
 }
 
 esp_err_t form_hostname(httpd_req_t *req)
 {
-	char line[110];
-	char resp_str[MAX_RESPONSE];
-	resp_str[0] = 0;
+	const page_form_hostname_args args =
+	{
+		.hostname = hostname,
+		.max_hostname = MAX_HOSTNAME,
+	};
+	char etag[ASSET_ETAG_SIZE];
+	resp_writer w;
 
-	strcat(resp_str, "<html><title>Watering System</title>\n<body>\n");
-	strcat(resp_str, "<h1>Set Hostname</h1>\n<form action=\"/\" method=\"PUT\">\n");
-	strcat(resp_str, "<br><input type=\"hidden\" name=\"action\" value=\"set_hostname\">\n");
-	snprintf(line, 110, "New host name: <input type=\"text\" name=\"host\" value=\"%s\" maxwidth=%u><br>", hostname, MAX_HOSTNAME);
-	strcat(resp_str, line);
-	strcat(resp_str, "<br><input type=\"submit\" value=\"Update\">\n");
-	strcat(resp_str, "</form></body></html>");
+	if (form_not_modified(req, etag, &page_form_hostname_template, hostname))
+		return ESP_OK;
+	writer_init(&w, req);
+	page_form_hostname(&w, &args);
+	return writer_finish(&w);
+}
 
-	return httpd_resp_send(req, resp_str, strlen(resp_str));
+// the <option>s of the zone <select> in form_add_event.html
+static void zone_options(resp_writer *w)
+{
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
+		writer_printf(w, "<option value=\"%u\">%s</option>", zone, zone_name(zone));
 }
 
 esp_err_t form_add_event(httpd_req_t *req)
 {
-	char resp_str[MAX_RESPONSE+1];
-	char line[MAX_LINE_LENGTH+1];
+	const page_form_add_event_args args =
+	{
+		.zones = zone_options,
+		.max_duration = MAX_DURATION,
+	};
+	const char *names[ZONE_MAX];
+	char zones[ASSET_ETAG_SIZE];
+	char etag[ASSET_ETAG_SIZE];
+	resp_writer w;
+
+	// the zones are fixed when the firmware is built, but can change with it
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
+		names[zone] = zone_name(zone);
+	asset_etag(zones, names, zone_count());
+	if (form_not_modified(req, etag, &page_form_add_event_template, zones))
+		return ESP_OK;
+	writer_init(&w, req);
+	page_form_add_event(&w, &args);
+	return writer_finish(&w);
+}
+
+/*
+	HTML form to set the NTP server name
+*/
+esp_err_t form_set_ntp(httpd_req_t *req)
+{
+	const page_form_set_ntp_args args = { .server = ntp_server };
+	char etag[ASSET_ETAG_SIZE];
+	resp_writer w;
+
+	if (form_not_modified(req, etag, &page_form_set_ntp_template, ntp_server))
+		return ESP_OK;
+	writer_init(&w, req);
+	page_form_set_ntp(&w, &args);
+	return writer_finish(&w);
+}
 
-	strcpy(resp_str, "<html><title>Watering System</title>\n<body>\n");
-	strcat(resp_str, "<h1>Add Event</h1>\n<form action=\"/\" method=\"PUT\">\n");
-	strcat(resp_str, "<br><input type=\"hidden\" name=\"action\" value=\"add_event\">\n");
-	strcat(resp_str, "<table><tr><td>Turn on at<td><input type=\"time\" name=\"time\"></tr>\n");
-	//strcat(resp_str, "<tr><td>Every<td><input type=\"number\" name=\"skip\" width=5>seconds</tr>\n");
-	strcat(resp_str, "<tr><td>On these days<td><input type=\"checkbox\" name=\"d0\">Sunday</tr>\n");
-	strcat(resp_str, "<tr><td><td><input type=\"checkbox\" name=\"d1\">Monday</tr>\n");
-	strcat(resp_str, "<tr><td><td><input type=\"checkbox\" name=\"d2\">Tuesday</tr>\n");
-	strcat(resp_str, "<tr><td><td><input type=\"checkbox\" name=\"d3\">Wednesday</tr>\n");
-	strcat(resp_str, "<tr><td><td><input type=\"checkbox\" name=\"d4\">Thursday</tr>\n");
-	strcat(resp_str, "<tr><td><td><input type=\"checkbox\" name=\"d5\">Friday</tr>\n");
-	strcat(resp_str, "<tr><td><td><input type=\"checkbox\" name=\"d6\">Saturday</tr>\n");
-	sprintf(line, "<tr><td>For<td><input type=\"number\" name=\"duration\" maxlength=5 min=1 max=%u> seconds</tr>", MAX_DURATION);
-	strcat(resp_str, line);
-	strncat(resp_str, "</table>\n", MAX_RESPONSE);
-	strcat(resp_str, "<input type=\"submit\" value=\"Add\">\n");
-	strcat(resp_str, "</form></body></html>");
+/*
+	HTML form to set the wifi SSID and password
+*/
+esp_err_t form_set_wifi(httpd_req_t *req)
+{
+	wifi_config_t wifi_config;
+	page_form_set_wifi_args args;
+	char ssid[MAX_SSID + 1];
+	char password[MAX_PW + 1];
+	resp_writer w;
+
+	// it has the password in it
+	httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+	writer_init(&w, req);
+	esp_wifi_get_config(ESP_IF_WIFI_STA, &wifi_config);
 
-	return httpd_resp_send(req, resp_str, strlen(resp_str));
+	// neither is terminated when it fills its field
+	memcpy(ssid, wifi_config.sta.ssid, MAX_SSID);
+	ssid[MAX_SSID] = '\0';
+	memcpy(password, wifi_config.sta.password, MAX_PW);
+	password[MAX_PW] = '\0';
+	args.ssid = ssid;
+	args.password = password;
+	page_form_set_wifi(&w, &args);
+	return writer_finish(&w);
 }
 
-esp_err_t form_set_time(httpd_req_t *req)
+/*
+	HTML form to change the upgrade URL
+*/
+esp_err_t form_set_upgrade(httpd_req_t *req)
 {
-	char resp_str[MAX_RESPONSE];
-	resp_str[0] = 0;
+	const page_form_set_upgrade_args args =
+	{
+		.url = upgrade_url,
+		.max_length = MAX_UPGRADE_URL - 1,
+	};
+	char etag[ASSET_ETAG_SIZE];
+	resp_writer w;
+
+	if (form_not_modified(req, etag, &page_form_set_upgrade_template, upgrade_url))
+		return ESP_OK;
+	writer_init(&w, req);
+	page_form_set_upgrade(&w, &args);
+	return writer_finish(&w);
+}
 
-	strcat(resp_str, "<html><title>Watering System</title>\n<body>\n");
-	strcat(resp_str, "<h1>Set Date and Time</h1>\n<form action=\"/\" method=\"PUT\">\n");
-	strcat(resp_str, "<br><input type=\"hidden\" name=\"action\" value=\"set_time\">\n");
-	strcat(resp_str, "<input type=\"datetime-local\" name=\"time\"><br>\n");
-	strcat(resp_str, "<input type=\"submit\" value=\"Set\">\n");
-	strcat(resp_str, "</form></body></html>");
+/*
+	Progress of the firmware update, for scripts
+*/
+esp_err_t ota_status(httpd_req_t *req)
+{
+	resp_writer w;
+	ota_status_t ota;
+	update_status update;
+	int64_t elapsed_ms = 0;
+	int64_t now = esp_timer_get_time();
+	unsigned int rate = 0;
+
+	ota_get_status(&ota);
+	update_get_status(&update);
+	if (ota.state != OTA_IDLE)
+	{
+		elapsed_ms = ((ota.end_time ? ota.end_time : now) - ota.start_time) / 1000;
+		if (elapsed_ms > 0)
+			rate = (uint64_t)(ota.bytes_written - ota.resumed_from) * 1000 / elapsed_ms;
+	}
 
-	return httpd_resp_send(req, resp_str, strlen(resp_str));
+	httpd_resp_set_type(req, "application/json");
+	writer_init(&w, req);
+	writer_printf(&w, "{\"state\":\"%s\",\"written\":%u,\"total\":%u,"
+		"\"elapsed_ms\":%u,\"bytes_per_sec\":%u,\"resumes\":%u,\"resumed_from\":%u,\"verified\":%s,\"error\":%d,",
+		ota_state_name(ota.state), (unsigned int)ota.bytes_written, (unsigned int)ota.bytes_total,
+		(unsigned int)elapsed_ms, rate, ota.resumes, (unsigned int)ota.resumed_from,
+		ota.verified ? "true" : "false", ota.err);
+	writer_printf(&w, "\"update\":{\"latest\":\"%s\",\"checks\":%u,\"last_check_s\":%d,\"next_check_s\":%d,\"error\":%d}}\n",
+		update.latest, update.checks,
+		update.last_check ? (int)((now - update.last_check) / 1000000) : -1,
+		update.next_check ? (int)((update.next_check - now) / 1000000) : -1, update.err);
+	return writer_finish(&w);
 }
 
 /*
-	HTML form to set the NTP server name
+	JSON API for machine clients. The responses are streamed with the JSON
+	writer and request bodies are flat JSON objects.
 */
-esp_err_t form_set_ntp(httpd_req_t *req)
+static esp_err_t api_error(httpd_req_t *req, const char *status, const char *message)
+{
+	resp_writer w;
+	json_writer j;
+
+	httpd_resp_set_status(req, status);
+	httpd_resp_set_type(req, HTTPD_TYPE_JSON);
+	writer_init(&w, req);
+	json_init(&j, &w);
+	json_object(&j, NULL);
+	json_str(&j, "error", message);
+	json_object_end(&j);
+	return writer_finish(&w);
+}
+
+// read the whole body into 'buf' and terminate it
+static esp_err_t api_recv_body(httpd_req_t *req, char *buf, size_t size)
 {
-	char line[128];
-	char resp_str[MAX_RESPONSE];
-	resp_str[0] = 0;
+	size_t len = 0;
+
+	if (req->content_len >= size)
+		return ESP_ERR_INVALID_SIZE;
 
-	strcat(resp_str, "<html><title>Watering System</title>\n<body>\n");
-	strcat(resp_str, "<h1>Set NTP Server</h1>\n<form action=\"/\" method=\"PUT\">\n");
-	strcat(resp_str, "<br><input type=\"hidden\" name=\"action\" value=\"set_ntp\">\n");
-	snprintf(line, 128, "<input type=\"text\" name=\"server\" value=\"%s\"><br>\n", ntp_server);
-	strcat(resp_str, line);
-	strcat(resp_str, "<input type=\"submit\" value=\"Set\">\n");
-	strcat(resp_str, "</form></body></html>");
+	while (len < req->content_len)
+	{
+		int n = httpd_req_recv(req, buf + len, req->content_len - len);
 
-	return httpd_resp_send(req, resp_str, strlen(resp_str));
+		if (n == HTTPD_SOCK_ERR_TIMEOUT)
+			continue;
+		if (n <= 0)
+			return ESP_FAIL;
+		len += n;
+	}
+	buf[len] = '\0';
+	return ESP_OK;
 }
 
 /*
-	HTML form to set the wifi SSID and password
+	Read the whole body into 'buf' and parse it - the parameters point into 'buf'
 */
-esp_err_t form_set_wifi(httpd_req_t *req)
+static esp_err_t api_read_body(httpd_req_t *req, char *buf, size_t size, query_index *q)
+{
+	esp_err_t err = api_recv_body(req, buf, size);
+
+	if (err != ESP_OK)
+		return err;
+	return json_parse_flat(buf, q) < 0 ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+
+static void api_write_event(json_writer *j, unsigned int slot, const water_event *event, time_t next)
+{
+	json_object(j, NULL);
+	json_uint(j, "index", slot);
+	json_uint(j, "zone", event->zone);
+	json_uint(j, "hour", event->hour);
+	json_uint(j, "minute", event->minute);
+	json_uint(j, "skip", event->skip);
+	json_uint(j, "days", event->days);
+	json_uint(j, "duration", event->duration);
+	if (next == SCHEDULE_NEVER)
+		json_null(j, "next");
+	else
+		json_int(j, "next", next);
+	json_object_end(j);
+}
+
+esp_err_t api_status(httpd_req_t *req)
+{
+	resp_writer w;
+	json_writer j;
+	ota_status_t ota;
+	net_status_t net;
+	char version[8];
+	time_t now;
+
+	check_internet();
+	ota_get_status(&ota);
+	net_get_status(&net);
+	time(&now);
+	snprintf(version, sizeof(version), "%u.%u", VER_MAJOR, VER_MINOR);
+
+	httpd_resp_set_type(req, HTTPD_TYPE_JSON);
+	writer_init(&w, req);
+	json_init(&j, &w);
+	json_object(&j, NULL);
+	json_str(&j, "version", version);
+	json_str(&j, "hostname", hostname);
+	json_int(&j, "time", now);
+	json_uint(&j, "uptime", esp_timer_get_time() / 1000000);
+	json_bool(&j, "internet", state.internet);
+	if (next_fire == SCHEDULE_NEVER)
+		json_null(&j, "next_event");
+	else
+		json_int(&j, "next_event", next_fire);
+	json_str(&j, "ota", ota_state_name(ota.state));
+
+	// when each step of the network bring-up was reached, in ms since boot
+	json_object(&j, "network");
+	json_str(&j, "state", net_state_name(net.state));
+	for (net_state_t s = NET_ASSOCIATED; s < NET_STATES; s++)
+	{
+		if (net.time[s])
+			json_uint(&j, net_state_name(s), net.time[s] / 1000);
+		else
+			json_null(&j, net_state_name(s));
+	}
+	json_object_end(&j);
+
+	json_array(&j, "zones");
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
+	{
+		zone_status zs;
+
+		zone_get_status(zone, &zs);
+		json_object(&j, NULL);
+		json_str(&j, "name", zone_name(zone));
+		json_bool(&j, "on", zs.on);
+		json_int(&j, "last_watering", zs.last_watering);
+		json_uint(&j, "last_duration", zs.last_duration);
+		json_object_end(&j);
+	}
+	json_array_end(&j);
+
+	json_object_end(&j);
+	return writer_finish(&w);
+}
+
+esp_err_t api_events(httpd_req_t *req)
+{
+	resp_writer w;
+	json_writer j;
+
+	httpd_resp_set_type(req, HTTPD_TYPE_JSON);
+	writer_init(&w, req);
+	json_init(&j, &w);
+	json_object(&j, NULL);
+	json_array(&j, "events");
+	for (unsigned int slot = 0; slot < MAX_EVENTS; slot++)
+	{
+		const water_event *found;
+		water_event event;
+		time_t next = SCHEDULE_NEVER;
+
+		// copy the event so the lock isn't held while the response is sent
+		xSemaphoreTake(schedule_lock, portMAX_DELAY);
+		found = schedule_get(&schedule, slot);
+		if (found)
+		{
+			event = *found;
+			next = schedule.next[slot];
+		}
+		xSemaphoreGive(schedule_lock);
+
+		if (found)
+			api_write_event(&j, slot, &event, next);
+	}
+	json_array_end(&j);
+	json_object_end(&j);
+	return writer_finish(&w);
+}
+
+/*
+	Read a number member of a request into 'value', which keeps what it
+	had if there is none. False if it isn't a number from 0 to 'max'.
+*/
+static bool api_uint(const query_index *q, const char *key, unsigned long max, unsigned long *value)
+{
+	const char *text = query_get(q, key);
+	unsigned long n;
+	char *end;
+
+	if (!text)
+		return true;
+	// no sign or space, and a number too large for strtoul() is ULONG_MAX
+	if (*text < '0' || *text > '9')
+		return false;
+	n = strtoul(text, &end, 10);
+	if (*end || n > max)
+		return false;
+	*value = n;
+	return true;
+}
+
+/*
+	Add an event from {"zone":0,"hour":7,"minute":30,"days":42,"skip":0,"duration":60}.
+	'days' is the bitmap of water_event, every member is optional.
+*/
+esp_err_t api_events_add(httpd_req_t *req)
+{
+	char body[256];
+	query_index q;
+	resp_writer w;
+	json_writer j;
+	water_event event;
+	unsigned long zone = 0;
+	unsigned long hour = 0, minute = 0, days = 0, skip = 0;
+	unsigned long duration = 0;
+	int slot;
+
+	if (api_read_body(req, body, sizeof(body), &q) != ESP_OK)
+		return api_error(req, HTTPD_400, "expected a flat JSON object");
+
+	// checked before they go in the 8 bit fields of the event
+	if (!api_uint(&q, "zone", zone_count() - 1, &zone))
+		return api_error(req, HTTPD_400, "no such zone");
+	if (!api_uint(&q, "hour", 23, &hour) || !api_uint(&q, "minute", 59, &minute)
+		|| !api_uint(&q, "days", 0x7F, &days) || !api_uint(&q, "skip", UINT8_MAX, &skip))
+		return api_error(req, HTTPD_400, "bad time");
+	if (!api_uint(&q, "duration", MAX_DURATION, &duration))
+		return api_error(req, HTTPD_400, "duration too long");
+
+	memset(&event, 0, sizeof(event));
+	event.zone = zone;
+	event.hour = hour;
+	event.minute = minute;
+	event.days = days;
+	event.skip = skip;
+	event.duration = duration;
+
+	// special case - every day
+	if (event.days == 0x7F)
+		event.days = 0;
+
+	slot = add_water_event(&event);
+	if (slot < 0)
+		return api_error(req, HTTPD_500, "schedule is full");
+
+	httpd_resp_set_status(req, "201 Created");
+	httpd_resp_set_type(req, HTTPD_TYPE_JSON);
+	writer_init(&w, req);
+	json_init(&j, &w);
+	json_object(&j, NULL);
+	json_int(&j, "index", slot);
+	json_object_end(&j);
+	return writer_finish(&w);
+}
+
+/*
+	DELETE /api/events?index=<n>
+*/
+esp_err_t api_events_del(httpd_req_t *req)
+{
+	char query[32];
+	query_index q;
+	const char *value = NULL;
+
+	if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
+	{
+		query_parse(&q, query);
+		value = query_get(&q, "index");
+	}
+	if (!value)
+		return api_error(req, HTTPD_400, "index missing");
+	if (del_water_event(strtoul(value, NULL, 10)) != 0)
+		return api_error(req, HTTPD_404, "no such event");
+
+	httpd_resp_set_status(req, HTTPD_204);
+	return httpd_resp_send(req, NULL, 0);
+}
+
+esp_err_t api_config(httpd_req_t *req)
 {
-	char line[200];
-	char resp_str[MAX_RESPONSE];
+	resp_writer w;
+	json_writer j;
 	wifi_config_t wifi_config;
+	char ssid[MAX_SSID + 1];
 
-	resp_str[0] = 0;
 	esp_wifi_get_config(ESP_IF_WIFI_STA, &wifi_config);
+	memcpy(ssid, wifi_config.sta.ssid, MAX_SSID);
+	ssid[MAX_SSID] = '\0';
+
+	httpd_resp_set_type(req, HTTPD_TYPE_JSON);
+	writer_init(&w, req);
+	json_init(&j, &w);
+	json_object(&j, NULL);
+	json_str(&j, "hostname", hostname);
+	json_str(&j, "ntp_server", ntp_server);
+	json_str(&j, "timezone", tz_name);
+	json_str(&j, "upgrade_url", upgrade_url);
+	json_str(&j, "ssid", ssid);
+	json_object_end(&j);
+	return writer_finish(&w);
+}
 
-	strcat(resp_str, "<html><title>Watering System</title>\n<body>\n");
-	strcat(resp_str, "<h1>Set Wifi Access Point</h1>\n<form action=\"/\" method=\"PUT\">\n");
-	strcat(resp_str, "<input type=\"hidden\" name=\"action\" value=\"set_wifi\">\n<table>");
-	snprintf(line, 128, "<tr><td>SSID<td><input type=\"text\" name=\"ssid\" value=\"%s\"></tr>\n", wifi_config.sta.ssid);
-	strcat(resp_str, line);
-	snprintf(line, 200, "<tr><td>Password<td><input type=\"password\" name=\"password\" value=\"%s\"></tr>\n", wifi_config.sta.password);
-	strcat(resp_str, line);
-	strcat(resp_str, "</table>\n<input type=\"submit\" value=\"Set\">\n");
-	strcat(resp_str, "</form></body></html>");
+/*
+	Change any of hostname, ntp_server, timezone and upgrade_url. Nothing
+	is changed if one of the members is wrong.
+*/
+esp_err_t api_config_set(httpd_req_t *req)
+{
+	static const struct
+	{
+		const char *name;
+		const char *key;		// in config_items
+		size_t size;
+	} members[] =
+	{
+		{ "hostname", "host", MAX_HOSTNAME },
+		{ "ntp_server", "ntp0", sizeof(ntp_server) },
+		{ "timezone", "timezone", MAX_TIMEZONE },
+		{ "upgrade_url", "upgrade", MAX_UPGRADE_URL },
+	};
+	char body[256];
+	query_index q;
+	unsigned int i, m;
+
+	if (api_read_body(req, body, sizeof(body), &q) != ESP_OK)
+		return api_error(req, HTTPD_400, "expected a flat JSON object");
+
+	for (i = 0; i < q.count; i++)
+	{
+		for (m = 0; m < sizeof(members) / sizeof(members[0]); m++)
+		{
+			if (strcmp(q.params[i].key, members[m].name) == 0)
+				break;
+		}
+		if (m == sizeof(members) / sizeof(members[0]))
+			return api_error(req, HTTPD_400, "unknown setting");
+		if (strlen(q.params[i].value) >= members[m].size)
+			return api_error(req, HTTPD_400, "value too long");
+	}
+
+	for (i = 0; i < q.count; i++)
+	{
+		for (m = 0; strcmp(q.params[i].key, members[m].name) != 0; m++)
+			;
+		config_set(members[m].key, q.params[i].value);
+	}
+
+	if (query_get(&q, "hostname"))
+		set_hostname(hostname);
+	if (query_get(&q, "timezone"))
+		set_timezone(tz_name);
 
-	return httpd_resp_send(req, resp_str, strlen(resp_str));
+	return api_config(req);
 }
 
 /*
-	HTML form to change the upgrade URL
+	POST /api/batch with one action per line, written as the query of
+	"/?action=..." would be:
+		action=set_hostname&host=shed
+		action=add_event&zone=1&time=06%3A30&duration=600
+	Nothing runs unless every line names an action. They then run in
+	order until one fails. The settings and the schedule are only written,
+	in one commit, if they all succeed - otherwise they go back to what
+	they were. What the actions did to the valves, the clock or the network
+	can't be taken back. 'results' has the error of each action, null for
+	those that didn't run.
 */
-esp_err_t form_set_upgrade(httpd_req_t *req)
+esp_err_t api_batch(httpd_req_t *req)
+{
+	struct batch
+	{
+		char body[BATCH_MAX_BODY];
+		query_index q[BATCH_MAX_ACTIONS];
+		int action[BATCH_MAX_ACTIONS];
+		esp_err_t err[BATCH_MAX_ACTIONS];
+	} *b;
+	unsigned int count = 0;
+	unsigned int done;
+	bool ok = true;
+	const char *error = NULL;
+	char *line;
+	esp_err_t err;
+	esp_err_t commit_err;
+	resp_writer w;
+	json_writer j;
+
+	b = malloc(sizeof(*b));
+	if (!b)
+		return api_error(req, HTTPD_500, "out of memory");
+	if ((err = api_recv_body(req, b->body, sizeof(b->body))) != ESP_OK)
+	{
+		free(b);
+		return api_error(req, HTTPD_400, err == ESP_ERR_INVALID_SIZE ? "too long" : "can't read the body");
+	}
+
+	for (line = b->body; *line && !error; )
+	{
+		char *end = line + strcspn(line, "\r\n");
+		const char *action;
+		char *next = end + strspn(end, "\r\n");
+
+		*end = '\0';
+		if (*line)
+		{
+			if (count == BATCH_MAX_ACTIONS)
+				error = "too many actions";
+			else if (query_parse(&b->q[count], line) == 0 || !(action = query_get(&b->q[count], "action")))
+				error = "a line has no action";
+			else if ((b->action[count] = find_action(action)) < 0)
+				error = "unknown action";
+			else
+				count++;
+		}
+		line = next;
+	}
+	if (error || count == 0)
+	{
+		free(b);
+		return api_error(req, HTTPD_400, error ? error : "no actions");
+	}
+
+	if ((err = config_hold()) != ESP_OK)
+	{
+		free(b);
+		return api_error(req, HTTPD_500, err == ESP_ERR_NO_MEM ? "out of memory" : "busy");
+	}
+	for (done = 0; done < count && ok; done++)
+	{
+		b->err[done] = run_action(b->action[done], &b->q[done]);
+		ok = b->err[done] == ESP_OK;
+	}
+	config_release(ok);
+	if (ok)
+		commit_err = config_flush();
+	else
+	{
+		commit_err = ESP_OK;
+		settings_reload();
+	}
+
+	httpd_resp_set_type(req, HTTPD_TYPE_JSON);
+	writer_init(&w, req);
+	json_init(&j, &w);
+	json_object(&j, NULL);
+	json_bool(&j, "ok", ok && commit_err == ESP_OK);
+	json_int(&j, "commit", commit_err);
+	json_array(&j, "results");
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (i < done)
+			json_int(&j, NULL, b->err[i]);
+		else
+			json_null(&j, NULL);
+	}
+	json_array_end(&j);
+	json_object_end(&j);
+	free(b);
+	return writer_finish(&w);
+}
+
+/*
+	GET /api/history?before=<seq>&limit=<n>&zone=<n>
+	The newest records first, read from flash a few at a time. 'next' is
+	the 'before' of the following page, null at the start of the log.
+*/
+esp_err_t api_history(httpd_req_t *req)
 {
-	char line[136];
-	char resp_str[MAX_RESPONSE];
-	resp_str[0] = 0;
+	history_record records[8];
+	char query[64];
+	query_index q;
+	const char *value;
+	uint32_t before = HISTORY_LATEST;
+	unsigned int limit = HISTORY_PAGE;
+	unsigned int sent = 0;
+	int zone = -1;
+	bool end = false;
+	resp_writer w;
+	json_writer j;
+
+	if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
+	{
+		query_parse(&q, query);
+		if ((value = query_get(&q, "before")))
+			before = strtoul(value, NULL, 10);
+		if ((value = query_get(&q, "limit")))
+			limit = MIN(strtoul(value, NULL, 10), HISTORY_PAGE_MAX);
+		if ((value = query_get(&q, "zone")))
+			zone = atoi(value);
+	}
 
-	strcat(resp_str, "<html><title>Watering System</title>\n<body>\n");
-	strcat(resp_str, "<h1>Set Upgrade URL</h1>\n<form action=\"/\" method=\"PUT\">\n");
-	strcat(resp_str, "<br><input type=\"hidden\" name=\"action\" value=\"set_upgrade\">\n");
-	snprintf(line, 136, "URL <input type=\"text\" name=\"url\" value=\"%s\" size=64 maxlength=%u><br>\n", upgrade_url, MAX_UPGRADE_URL-1);
-	strcat(resp_str, line);
-	strcat(resp_str, "<input type=\"submit\" value=\"Set\">\n");
-	strcat(resp_str, "</form></body></html>");
+	httpd_resp_set_type(req, HTTPD_TYPE_JSON);
+	writer_init(&w, req);
+	json_init(&j, &w);
+	json_object(&j, NULL);
+	json_array(&j, "records");
+	while (sent < limit && !end)
+	{
+		unsigned int want = sizeof(records) / sizeof(records[0]);
+		unsigned int count = history_read(before, records, want);
+
+		end = count < want;
+		for (unsigned int i = 0; i < count && sent < limit; i++)
+		{
+			const history_record *r = &records[i];
+
+			before = r->seq;
+			if (zone >= 0 && r->zone != zone)
+				continue;
+
+			json_object(&j, NULL);
+			json_uint(&j, "seq", r->seq);
+			if (r->time)
+				json_int(&j, "time", r->time);
+			else
+				json_null(&j, "time");
+			json_uint(&j, "zone", r->zone);
+			json_bool(&j, "on", r->on);
+			json_str(&j, "cause", zone_cause_name(r->cause));
+			if (r->event >= 0)
+				json_int(&j, "event", r->event);
+			else
+				json_null(&j, "event");
+			if (!r->on)
+				json_uint(&j, "duration", r->duration);
+			json_object_end(&j);
+			sent++;
+		}
+	}
+	json_array_end(&j);
+	if (sent == limit && before > 0)
+		json_uint(&j, "next", before);
+	else
+		json_null(&j, "next");
+	json_object_end(&j);
+	return writer_finish(&w);
+}
+
+/*
+	The spans recorded since boot (or the newest PROF_MAX_SPANS of them),
+	times in us since boot - tools/boot_timeline.py draws them
+*/
+esp_err_t debug_boot(httpd_req_t *req)
+{
+	prof_span spans[PROF_MAX_SPANS];
+	unsigned int count = prof_get(spans, PROF_MAX_SPANS);
+	resp_writer w;
+	json_writer j;
+
+	httpd_resp_set_type(req, HTTPD_TYPE_JSON);
+	writer_init(&w, req);
+	json_init(&j, &w);
+	json_object(&j, NULL);
+	json_uint64(&j, "now", esp_timer_get_time());
+	json_array(&j, "spans");
+	for (unsigned int i = 0; i < count; i++)
+	{
+		json_object(&j, NULL);
+		json_str(&j, "name", spans[i].name);
+		json_uint64(&j, "start", spans[i].start);
+		if (spans[i].end)
+			json_uint64(&j, "end", spans[i].end);
+		else
+			json_null(&j, "end");
+		json_uint(&j, "depth", spans[i].depth);
+		json_object_end(&j);
+	}
+	json_array_end(&j);
+	json_object_end(&j);
+	return writer_finish(&w);
+}
 
-	return httpd_resp_send(req, resp_str, strlen(resp_str));
+static void bench_json(json_writer *j, const bench_counter *c)
+{
+	json_object(j, NULL);
+	json_str(j, "name", c->name);
+	json_uint(j, "calls", c->calls);
+	json_uint(j, "min", c->calls ? c->min : 0);
+	json_uint(j, "mean", c->calls ? (unsigned long)(c->total / c->calls) : 0);
+	json_uint(j, "max", c->max);
+	json_object_end(j);
 }
 
 /*
-	Send the icon that the browser displays for this page
+	Cycle counts of the hot paths. handler_index() is counted as it runs;
+	url_decode() is run here on typical parameters, and the work scheduler()
+	does on the schedule for each run - finding the events that are due and
+	moving them on - on a copy of it, so nothing is started or rearmed.
+	"?reset" starts the counts of handler_index() again.
 */
-esp_err_t favicon(httpd_req_t *req)
+esp_err_t debug_bench(httpd_req_t *req)
+{
+	static const char *const params[] =
+	{
+		"Back+Garden",
+		"14%3A30",
+		"http%3A%2F%2F192.168.20.30%2Fwater.bin",
+		"My%20Home%20Network%20%F0%9F%8C%B1",
+	};
+	bench_counter decode = BENCH_COUNTER("url_decode");
+	bench_counter wakeup = BENCH_COUNTER("schedule_wakeup");
+	schedule_store *copy;
+	char query[16];
+	char buf[64];
+	resp_writer w;
+	json_writer j;
+
+	if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK && strcmp(query, "reset") == 0)
+		bench_reset(&bench_index);
+
+	for (unsigned int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		for (unsigned int i = 0; i < sizeof(params) / sizeof(params[0]); i++)
+		{
+			size_t len = strlen(params[i]);
+			uint32_t start;
+
+			memcpy(buf, params[i], len);
+			start = bench_start();
+			url_decode(buf, sizeof(buf), buf, len);
+			bench_end(&decode, start);
+		}
+	}
+
+	// too large for the stack of the server task
+	copy = malloc(sizeof(*copy));
+	if (copy)
+	{
+		xSemaphoreTake(schedule_lock, portMAX_DELAY);
+		*copy = schedule;
+		xSemaphoreGive(schedule_lock);
+
+		for (unsigned int round = 0; round < BENCH_ROUNDS; round++)
+		{
+			uint32_t start = bench_start();
+			time_t now = schedule_peek(copy, NULL);
+			time_t due;
+
+			while ((due = schedule_peek(copy, NULL)) != SCHEDULE_NEVER && due <= now)
+				schedule_fired(copy);
+			bench_end(&wakeup, start);
+		}
+		free(copy);
+	}
+
+	httpd_resp_set_type(req, HTTPD_TYPE_JSON);
+	writer_init(&w, req);
+	json_init(&j, &w);
+	json_object(&j, NULL);
+	json_uint(&j, "cpu_mhz", CONFIG_ESP8266_DEFAULT_CPU_FREQ_MHZ);
+	json_str(&j, "profile", BUILD_PROFILE);
+#ifdef CONFIG_WATER_HOT_IRAM
+	json_bool(&j, "hot_iram", true);
+#else
+	json_bool(&j, "hot_iram", false);
+#endif
+	json_array(&j, "functions");
+	bench_json(&j, &bench_index);
+	bench_json(&j, &wakeup);
+	bench_json(&j, &decode);
+	json_array_end(&j);
+	json_object_end(&j);
+	return writer_finish(&w);
+}
+
+static const char *method_name(int method)
 {
-	int length = favicon_png_end - favicon_png_start;
-	return httpd_resp_send(req, (char*)favicon_png_start, length);
+	switch (method)
+	{
+	case HTTP_GET: return "GET";
+	case HTTP_POST: return "POST";
+	case HTTP_PUT: return "PUT";
+	case HTTP_DELETE: return "DELETE";
+	default: return "OTHER";
+	}
+}
+
+/*
+	Counters and latency histograms in the Prometheus text format. The
+	numbers are since boot, so a reboot shows up as a counter reset.
+*/
+esp_err_t handler_metrics(httpd_req_t *req)
+{
+	// the longest URIs are the bundle's /ui/<name> paths
+	char labels[MAX(sizeof("uri=\"\",method=\"DELETE\"") + BUNDLE_PATH,
+		sizeof("action=\"\"") + sizeof(actions[0].name))];
+	wifi_ap_record_t ap_info;
+	resp_writer w;
+
+	httpd_resp_set_type(req, "text/plain; version=0.0.4");
+	writer_init(&w, req);
+
+	metrics_write_help(&w, "water_http_request_duration_seconds", "histogram", "Time spent in the handler of a URI");
+	for (unsigned int i = 0; i < timed_count; i++)
+	{
+		const httpd_uri_t *uri = &uri_timings[i].uri;
+
+		snprintf(labels, sizeof(labels), "uri=\"%s\",method=\"%s\"", uri->uri, method_name(uri->method));
+		metrics_write_hist(&w, "water_http_request_duration_seconds", labels, &uri_timings[i].latency);
+	}
+	metrics_write_help(&w, "water_http_request_errors_total", "counter", "Handlers that returned an error");
+	for (unsigned int i = 0; i < timed_count; i++)
+	{
+		const httpd_uri_t *uri = &uri_timings[i].uri;
+
+		writer_printf(&w, "water_http_request_errors_total{uri=\"%s\",method=\"%s\"} %u\n",
+			uri->uri, method_name(uri->method), uri_timings[i].errors);
+	}
+
+	metrics_write_help(&w, "water_action_duration_seconds", "histogram", "Time spent running an action");
+	for (unsigned int i = 0; i < MAX_ACTIONS; i++)
+	{
+		snprintf(labels, sizeof(labels), "action=\"%.*s\"", (int)sizeof(actions[i].name), actions[i].name);
+		metrics_write_hist(&w, "water_action_duration_seconds", labels, &action_latency[i]);
+	}
+
+	metrics_write_help(&w, "water_zone_on", "gauge", "Whether the valve of a zone is open");
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
+	{
+		zone_status zs;
+
+		zone_get_status(zone, &zs);
+		writer_printf(&w, "water_zone_on{zone=\"%u\"} %u\n", zone, zs.on);
+	}
+	metrics_write_help(&w, "water_zone_waterings_total", "counter", "Waterings that have finished");
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
+	{
+		zone_status zs;
+
+		zone_get_status(zone, &zs);
+		writer_printf(&w, "water_zone_waterings_total{zone=\"%u\"} %u\n", zone, zs.waterings);
+	}
+	metrics_write_help(&w, "water_zone_seconds_total", "counter", "Time the valve was open in finished waterings");
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
+	{
+		zone_status zs;
+
+		zone_get_status(zone, &zs);
+		writer_printf(&w, "water_zone_seconds_total{zone=\"%u\"} %u\n", zone, zs.total_seconds);
+	}
+
+	metrics_write_help(&w, "water_heap_free_bytes", "gauge", "Free heap");
+	writer_printf(&w, "water_heap_free_bytes %u\n", esp_get_free_heap_size());
+	metrics_write_help(&w, "water_heap_min_free_bytes", "gauge", "Lowest free heap since boot");
+	writer_printf(&w, "water_heap_min_free_bytes %u\n", esp_get_minimum_free_heap_size());
+
+	// not there at all while the station isn't connected
+	if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK)
+	{
+		metrics_write_help(&w, "water_wifi_rssi_dbm", "gauge", "Signal strength of the access point");
+		writer_printf(&w, "water_wifi_rssi_dbm %i\n", ap_info.rssi);
+	}
+
+	metrics_write_help(&w, "water_uptime_seconds", "counter", "Time since boot");
+	writer_printf(&w, "water_uptime_seconds %u\n", (unsigned int)(esp_timer_get_time() / 1000000));
+
+	return writer_finish(&w);
+}
+
+/*
+	A zone was switched - runs in the task that switched it
+*/
+static void zones_changed(uint32_t zones)
+{
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
+	{
+		zone_status zs;
+
+		if (!(zones & ZONE_BIT(zone)))
+			continue;
+		zone_get_status(zone, &zs);
+		history_log(zone, &zs);
+	}
+	push_notify(zones);
+}
+
+/*
+	Send what changed to the open pages - runs in the web server task
+*/
+static void push_render(uint32_t changes)
+{
+	char data[128];
+
+	// the clock and the Internet connection aren't followed without someone watching
+	if (changes & PUSH_HEARTBEAT)
+		check_internet();
+
+	for (unsigned int zone = 0; zone < zone_count(); zone++)
+	{
+		zone_status zs;
+
+		if (!(changes & ZONE_BIT(zone)))
+			continue;
+		zone_get_status(zone, &zs);
+		snprintf(data, sizeof(data), "{\"zone\":%u,\"on\":%s,\"last_watering\":%ld,\"last_duration\":%d}",
+			zone, zs.on ? "true" : "false", (long)zs.last_watering, zs.last_duration);
+		push_send("zone", data);
+	}
+
+	if (changes & PUSH_INTERNET)
+		push_send("internet", state.internet ? "{\"internet\":true}" : "{\"internet\":false}");
+
+	if (changes & PUSH_SCHEDULE)
+	{
+		snprintf(data, sizeof(data), "{\"count\":%u}", schedule.count);
+		push_send("schedule", data);
+	}
+}
+
+static esp_err_t timed_handler(httpd_req_t *req)
+{
+	uri_timing *timing = req->user_ctx;
+	int64_t start = esp_timer_get_time();
+	esp_err_t err;
+
+	// the handler sees the context it was declared with
+	req->user_ctx = timing->uri.user_ctx;
+	err = timing->uri.handler(req);
+	if (err != ESP_OK)
+		timing->errors++;
+	metrics_observe(&timing->latency, esp_timer_get_time() - start);
+	return err;
+}
+
+/*
+	A restarted server registers the same uris in the same order, so each
+	keeps its numbers
+*/
+static void register_timed(httpd_handle_t server, const httpd_uri_t *uri)
+{
+	uri_timing *timing = &uri_timings[timed_count];
+	httpd_uri_t timed = *uri;
+
+	ESP_LOGI(TAG, "Registering URI handler %s", uri->uri);
+	timing->uri = *uri;
+	timed.handler = timed_handler;
+	timed.user_ctx = timing;
+	if (httpd_register_uri_handler(server, &timed) == ESP_OK)
+		timed_count++;
 }
 
 httpd_handle_t start_webserver(void)
 {
 	httpd_handle_t server = NULL;
 	httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+	int span = prof_begin("httpd_start");
 
 	// Start the httpd server
 	ESP_LOGI(TAG, "Starting web server on port: '%d'", config.server_port);
 	config.max_uri_handlers = MAX_URI_HANDLERS;
 	if (httpd_start(&server, &config) == ESP_OK)
 	{
-		// Set URI handlers
-		for (int i=0; i < sizeof(uris)/sizeof(httpd_uri_t); i++)
+		// Set URI handlers - the files of the UI bundle come after the built in ones
+		timed_count = 0;
+		for (int i=0; i < URI_COUNT; i++)
+			register_timed(server, &uris[i]);
+		for (unsigned int i = 0; bundle_get(i); i++)
 		{
-			ESP_LOGI(TAG, "Registering URI handler %s", uris[i].uri);
-			httpd_register_uri_handler(server, &uris[i]);
+			const bundle_file *file = bundle_get(i);
+			const httpd_uri_t uri = {
+				.uri = file->path,
+				.method = HTTP_GET,
+				.handler = bundle_handler,
+				.user_ctx = (void*)file
+			};
+
+			register_timed(server, &uri);
 		}
+		push_start(server);
+		prof_end(span);
 		return server;
 	}
 
+	prof_end(span);
 	ESP_LOGI(TAG, "Error starting server!");
 	return NULL;
 }
@@ -1221,11 +2362,22 @@ static void on_wifi_disconnect(void* arg, esp_event_base_t event_base,
 	system_event_sta_disconnected_t *event = (system_event_sta_disconnected_t *)event_data;
 
 	ESP_LOGI(TAG, "on_wifi_disconnect reason: %u", event->reason);
+	net_set_state(NET_DOWN);
+	esp_timer_stop(sntp_timer);
+
+	// so check_internet() sees it come back and moves on from NET_SNTP
+	if (state.internet)
+	{
+		ESP_LOGI(TAG, "Internet is down");
+		state.internet = false;
+		push_notify(PUSH_INTERNET);
+	}
 
 	if (*server)
 	{
 		ESP_LOGI(TAG, "Stopping webserver");
 		httpd_stop(server);
+		push_stop();
 		*server = NULL;
 	}
 
@@ -1252,6 +2404,7 @@ static void on_ip_connect(void* arg, esp_event_base_t event_base,
     httpd_handle_t* server = (httpd_handle_t*) arg;
 
     ESP_LOGI(TAG, "got ip: %s", ip4addr_ntoa(&event->ip_info.ip));
+	net_set_state(NET_GOT_IP);
 
 	// stop blinking - we are connected
 	blink_stop();
@@ -1268,20 +2421,14 @@ static void on_ip_connect(void* arg, esp_event_base_t event_base,
 		mdns_service_add(NULL, "_http", "_tcp", 80, NULL, 0);
 	}
 
-	// start NTP client
-	obtain_time();
+	net_set_state(NET_SERVING);
 
-	uint8_t retries = 10;
-	while (--retries)
-	{
-		if (sntp_getreachability(0) != 0)
-		{
-			ESP_LOGI(TAG, "Internet is up");
-			state.internet = true;
-			break;
-		}
-		sleep(1);
-	}
+	// start NTP client - sntp_poll() follows it from the timer task
+	obtain_time();
+	net_set_state(NET_SNTP);
+	sntp_polls = 0;
+	esp_timer_stop(sntp_timer);
+	esp_timer_start_periodic(sntp_timer, SNTP_POLL_PERIOD);
 }
 
 static void on_ip_disconnect(void* arg, esp_event_base_t event_base, 
@@ -1319,6 +2466,7 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
 
 	case WIFI_EVENT_STA_CONNECTED:
 		esp_timer_stop(connect_timer);
+		net_set_state(NET_ASSOCIATED);
 		ESP_LOGI(TAG, "WIFI connected to %s", wifi_config.sta.ssid);
 		break;
 
@@ -1366,7 +2514,6 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
 void app_main()
 {
 	uint8_t mac[7];
-	nvs_handle nvs;
 	wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
 
 	const esp_timer_create_args_t blink_timer_args = {
@@ -1390,45 +2537,65 @@ void app_main()
 		.name = ""
 	};
 
-	const esp_timer_create_args_t water_timer_args = {
-		.callback = water_callback,
-		.arg = &water_timer,
+	const esp_timer_create_args_t reboot_timer_args = {
+		.callback = reboot_callback,
+		.arg = &reboot_timer,
 		.dispatch_method = ESP_TIMER_TASK,
 		.name = ""
 	};
 
-	const esp_timer_create_args_t reboot_timer_args = {
-		.callback = reboot_callback,
-		.arg = &reboot_timer,
+	const esp_timer_create_args_t sntp_timer_args = {
+		.callback = sntp_poll,
+		.arg = &sntp_timer,
 		.dispatch_method = ESP_TIMER_TASK,
 		.name = ""
 	};
 
+	int boot, span;
+
 	// we are alive
+	prof_init();
+	boot = prof_begin("app_main");
 	ESP_LOGI(TAG, "Watering System v%u.%u", VER_MAJOR, VER_MINOR);
 
 	// make sure all events are off until they are programmed
-	for (uint8_t evt = 0; evt < MAX_EVENTS; evt++)
-		state.schedule[evt].enabled = false;
+	schedule_init(&schedule);
+	schedule_lock = xSemaphoreCreateMutex();
 
 	// set up wifi configuration
 
-   ESP_ERROR_CHECK(nvs_flash_init());
-   ESP_ERROR_CHECK(esp_event_loop_create_default());
+	span = prof_begin("nvs_flash_init");
+	ESP_ERROR_CHECK(nvs_flash_init());
+	prof_end(span);
+	span = prof_begin("event_loop");
+	ESP_ERROR_CHECK(esp_event_loop_create_default());
+	prof_end(span);
 
 	// gpios
+	span = prof_begin("zones");
 	gpio_set_direction(GPIO_NUM_2, GPIO_MODE_OUTPUT);
-	gpio_set_direction(WATER_PIN, GPIO_MODE_OUTPUT);
-	gpio_set_level(WATER_PIN, 0);
+	net_init();
+	push_init(push_render);
+	zone_init(zones_changed);
+	prof_end(span);
+	span = prof_begin("history");
+	history_init();
+	prof_end(span);
+	span = prof_begin("bundle");
+	bundle_init();
+	prof_end(span);
 
 	// set up timers
+	span = prof_begin("timers");
 	esp_timer_create(&blink_timer_args, &blink_timer);
 	esp_timer_create(&connect_timer_args, &connect_timer);
 	esp_timer_create(&schedule_timer_args, &schedule_timer);
-	esp_timer_create(&water_timer_args, &water_timer);
 	esp_timer_create(&reboot_timer_args, &reboot_timer);
+	esp_timer_create(&sntp_timer_args, &sntp_timer);
+	prof_end(span);
 
 	// set up networking
+	span = prof_begin("wifi_init");
 	if (esp_base_mac_addr_get(mac) == ESP_ERR_INVALID_MAC)
 	{
 		esp_efuse_mac_get_default(mac);
@@ -1442,57 +2609,25 @@ void app_main()
 
 	// set to 'station' mode (client)
 	ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
+	prof_end(span);
 
 	// read the stored variables from flash
-	if (nvs_open(nvs_namespace, NVS_READONLY, &nvs) == ESP_OK)
-	{
-		char value[64];
-		size_t length;
-
-		// NTP server name
-		length = 64;
-		if (nvs_get_str(nvs, "ntp0", value, &length) == ESP_OK)
-		{
-			strncpy(ntp_server, value, 64);
-		}
-
-		// host name
-		length = 32;
-		if (nvs_get_str(nvs, "host", value, &length) == ESP_OK)
-		{
-			set_hostname(value);
-		}
-
-		// host name
-		length = 8;
-		if (nvs_get_str(nvs, "timezone", value, &length) == ESP_OK)
-		{
-			set_timezone(value);
-		}
-
-		length = 64;
-		if (nvs_get_str(nvs, "upgrade", value, &length) == ESP_OK)
-		{
-			strncpy(upgrade_url, value, 64);
-		}
-
-		// scheduled events
-		for (uint8_t evt = 0; evt < MAX_EVENTS; evt++)
-		{
-			char event_name[10];
-			sprintf(event_name, "evt%02u", evt);
-			length = sizeof(water_event);
-			nvs_get_blob(nvs, event_name, &state.schedule[evt], &length);
-		}
-
-		nvs_close(nvs);
-	}
-
+	span = prof_begin("config_load");
+	config_init(nvs_namespace, config_items, sizeof(config_items)/sizeof(config_item));
+	schedule_load();
+	set_hostname(hostname);
+	if (tz_name[0])
+		set_timezone(tz_name);
+	prof_end(span);
+	update_init("upgrade", VER_MAJOR, VER_MINOR, update_available);
+
+	span = prof_begin("wifi_start");
 	ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &on_ip_connect, &server));
 	ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, IP_EVENT_STA_LOST_IP, &on_ip_disconnect, &server));
 	ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, &server));
 	ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &on_wifi_disconnect, &server));
 	ESP_ERROR_CHECK(esp_wifi_start());
+	prof_end(span);
 
 	//ESP_ERROR_CHECK(mdns_init());
 
@@ -1500,8 +2635,9 @@ void app_main()
 	set_timezone("PDT+7");
 	ESP_LOGI(TAG, "Using NTP server %s", ntp_server);
 	ESP_LOGI(TAG, "Using hostname %s", hostname);
-	ESP_LOGI(TAG, "Using timezone %s", timezone);
+	ESP_LOGI(TAG, "Using timezone %s", tz_name);
 
 	// start the scheduler
-	esp_timer_start_periodic(schedule_timer, 1000000 * 60); // wake up once per minute
+	schedule_update();
+	prof_end(boot);
 }
@@ -0,0 +1,46 @@
+#include "metrics.h"
+
+// the bucket bounds and how Prometheus wants them written, in seconds
+static const uint32_t bucket_us[METRICS_BUCKETS] =
+{
+	1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 2000000, 5000000
+};
+static const char *bucket_le[METRICS_BUCKETS] =
+{
+	"0.001", "0.002", "0.005", "0.01", "0.02", "0.05", "0.1", "0.2", "0.5", "1", "2", "5"
+};
+
+void metrics_observe(metrics_hist *h, int64_t us)
+{
+	unsigned int b = 0;
+
+	if (us < 0)
+		us = 0;
+	while (b < METRICS_BUCKETS && us > bucket_us[b])
+		b++;
+	h->buckets[b]++;
+	h->count++;
+	h->sum_us += us;
+}
+
+void metrics_write_help(resp_writer *w, const char *name, const char *type, const char *help)
+{
+	writer_printf(w, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void metrics_write_hist(resp_writer *w, const char *name, const char *labels, const metrics_hist *h)
+{
+	uint32_t total = 0;
+
+	for (unsigned int b = 0; b < METRICS_BUCKETS; b++)
+	{
+		total += h->buckets[b];
+		writer_printf(w, "%s_bucket{%s,le=\"%s\"} %u\n", name, labels, bucket_le[b], total);
+	}
+	writer_printf(w, "%s_bucket{%s,le=\"+Inf\"} %u\n", name, labels, h->count);
+
+	// no floating point in printf - write the seconds as two integers
+	writer_printf(w, "%s_sum{%s} %u.%06u\n", name, labels,
+		(unsigned int)(h->sum_us / 1000000), (unsigned int)(h->sum_us % 1000000));
+	writer_printf(w, "%s_count{%s} %u\n", name, labels, h->count);
+}
@@ -0,0 +1,31 @@
+#ifndef _METRICS_H
+#define _METRICS_H
+
+#include <stdint.h>
+#include "writer.h"
+
+#define METRICS_BUCKETS 12			// upper bounds from 1 ms to 5 s, then +Inf
+
+/*
+	A latency histogram with fixed buckets - recording a sample is a few
+	compares and adds, and nothing is allocated. A histogram is not
+	locked, so each one must only be updated from one task; the HTTP ones
+	are all in the web server task.
+*/
+typedef struct metrics_hist
+{
+	uint32_t count;
+	uint64_t sum_us;
+	uint32_t buckets[METRICS_BUCKETS + 1];	// not cumulative, the last is +Inf
+} metrics_hist;
+
+void metrics_observe(metrics_hist *h, int64_t us);
+
+/*
+	Prometheus text format. 'labels' goes inside the braces of every line
+	of the histogram, like uri="/",method="GET".
+*/
+void metrics_write_help(resp_writer *w, const char *name, const char *type, const char *help);
+void metrics_write_hist(resp_writer *w, const char *name, const char *labels, const metrics_hist *h);
+
+#endif // _METRICS_H
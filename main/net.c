@@ -0,0 +1,67 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "net.h"
+#include "prof.h"
+
+static const char *TAG="NET";
+static const char *state_names[NET_STATES] =
+{
+	"down",
+	"associated",
+	"got_ip",
+	"serving",
+	"sntp",
+	"online",
+};
+static SemaphoreHandle_t lock;
+static net_status_t status;
+
+void net_init(void)
+{
+	lock = xSemaphoreCreateMutex();
+}
+
+void net_set_state(net_state_t state)
+{
+	int64_t now = esp_timer_get_time();
+	net_state_t old;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	old = status.state;
+	status.state = state;
+	status.time[state] = now;
+	for (unsigned int later = state + 1; later < NET_STATES; later++)
+		status.time[later] = 0;
+	xSemaphoreGive(lock);
+
+	prof_mark(state_names[state]);
+	if (old != state)
+		ESP_LOGI(TAG, "%s -> %s at %u ms", state_names[old], state_names[state], (unsigned int)(now / 1000));
+}
+
+net_state_t net_get_state(void)
+{
+	net_state_t state;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	state = status.state;
+	xSemaphoreGive(lock);
+	return state;
+}
+
+void net_get_status(net_status_t *out)
+{
+	xSemaphoreTake(lock, portMAX_DELAY);
+	*out = status;
+	xSemaphoreGive(lock);
+}
+
+const char *net_state_name(net_state_t state)
+{
+	if (state >= NET_STATES)
+		return "unknown";
+	return state_names[state];
+}
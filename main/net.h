@@ -0,0 +1,35 @@
+#ifndef _NET_H
+#define _NET_H
+
+#include <stdint.h>
+
+typedef enum
+{
+	NET_DOWN,			// not associated with an access point
+	NET_ASSOCIATED,	// associated, waiting for an address
+	NET_GOT_IP,			// have an address
+	NET_SERVING,		// the web server and mDNS are up
+	NET_SNTP,			// waiting for the NTP server to answer
+	NET_ONLINE,			// the NTP server answered - the Internet is up
+	NET_STATES
+} net_state_t;
+
+typedef struct net_status
+{
+	net_state_t state;
+	int64_t time[NET_STATES];	// esp_timer_get_time() when each state was entered, 0 if it hasn't been
+} net_status_t;
+
+/*
+	Network bring-up goes through the states in order, driven by the
+	wifi and IP events and the SNTP poll. Going back to an earlier state
+	forgets the times of the later ones, so the times always describe the
+	current connection.
+*/
+void net_init(void);
+void net_set_state(net_state_t state);
+net_state_t net_get_state(void);
+void net_get_status(net_status_t *status);
+const char *net_state_name(net_state_t state);
+
+#endif // _NET_H
@@ -0,0 +1,891 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/param.h>
+#include <string.h>
+#include <strings.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "esp_http_client.h"
+#include "nvs.h"
+#include "mbedtls/sha256.h"
+#include "sdkconfig.h"
+#include "ota.h"
+#include "patch.h"
+
+#define OTA_BUF_SIZE CONFIG_WATER_OTA_BUF_SIZE
+#define OTA_BUFFERS 2
+#define OTA_URL_SIZE 128
+#define OTA_STACK_SIZE 3072
+#define OTA_TIMEOUT 10000			// ms without data before the connection counts as lost
+#define OTA_RETRIES 5				// reconnects in a row that get no data
+#define OTA_RETRY_DELAY 1000		// ms before the first reconnect, doubled for each after it
+#define OTA_ETAG_SIZE 64
+#define OTA_DIGEST 32				// SHA-256
+#define MANIFEST_SUFFIX ".sha256"
+#define VERIFY_CHUNK 256			// bytes of the new image hashed at once
+#define OTA_SECTOR 4096				// flash is erased in sectors of this size
+#define OTA_SAVE_EVERY (64 * 1024)	// bytes written between saves of the progress
+#define OTA_NVS "ota"					// NVS namespace and key of the progress
+#define OTA_NVS_KEY "progress"
+#define IMAGE_MAGIC 0xE9			// the first byte of an app image
+
+// a filled buffer on its way to flash - a length of 0 ends the update
+typedef struct ota_block
+{
+	char *buf;
+	int len;
+} ota_block;
+
+/*
+	The file being downloaded. When the connection drops it is opened
+	again with a Range request for the rest, so the bytes that already
+	arrived - and the state of the patch decoder - are kept.
+*/
+typedef struct ota_source
+{
+	esp_http_client_handle_t client;
+	size_t offset;					// bytes of the file received
+	size_t total;					// size of the file, 0 if not known
+	size_t range_start;			// from the Content-Range of the response
+	int code;						// HTTP status of the response
+	int retries;					// reconnects left
+	bool restart;					// a 200 to this resume means the file changed - start again
+	char etag[OTA_ETAG_SIZE];	// of the first response, so a resume gets the same file
+	char sent_etag[OTA_ETAG_SIZE];	// of the latest response
+} ota_source;
+
+/*
+	How far a download got, kept in NVS so the next attempt - or the one
+	after a reboot - asks for the rest of the same file with If-Range
+	rather than starting again. Only plain images are resumed this way,
+	the state of the patch decoder is only in RAM.
+*/
+typedef struct ota_progress
+{
+	char url[OTA_URL_SIZE];
+	char etag[OTA_ETAG_SIZE];
+	uint32_t partition;			// address of the partition being written
+	uint32_t written;				// bytes of the file in flash
+	uint32_t total;				// size of the file
+} ota_progress;
+
+static const char *TAG="OTA";
+static SemaphoreHandle_t status_lock;
+static ota_status_t status;
+static char ota_url[OTA_URL_SIZE];
+static uint8_t ota_digest[OTA_DIGEST];	// given to ota_start()
+static bool ota_has_digest;
+static void (*ota_done)(esp_err_t err);
+
+// empty buffers go from the writer back to the reader on 'free_q'
+static QueueHandle_t free_q;
+static QueueHandle_t full_q;
+static SemaphoreHandle_t writer_done;
+static esp_err_t writer_err;
+
+// owned by the writer while a download runs
+static const esp_partition_t *update_partition;
+static size_t write_offset;		// bytes of the image in flash
+static size_t erased;				// bytes from the start of the partition that are erased
+static ota_progress progress;
+static bool save_progress;
+
+static const char *state_names[] =
+{
+	[OTA_IDLE] = "idle",
+	[OTA_CONNECTING] = "connecting",
+	[OTA_DOWNLOADING] = "downloading",
+	[OTA_DONE] = "done",
+	[OTA_FAILED] = "failed",
+};
+
+const char *ota_state_name(ota_state_t state)
+{
+	if (state > OTA_FAILED)
+		return "unknown";
+	return state_names[state];
+}
+
+static void set_state(ota_state_t state, esp_err_t err)
+{
+	xSemaphoreTake(status_lock, portMAX_DELAY);
+	status.state = state;
+	status.err = err;
+	if (state == OTA_DONE || state == OTA_FAILED)
+		status.end_time = esp_timer_get_time();
+	xSemaphoreGive(status_lock);
+}
+
+void ota_get_status(ota_status_t *out)
+{
+	if (!status_lock)
+	{
+		memset(out, 0, sizeof(*out));
+		return;
+	}
+	xSemaphoreTake(status_lock, portMAX_DELAY);
+	*out = status;
+	xSemaphoreGive(status_lock);
+}
+
+static bool progress_load(ota_progress *p)
+{
+	nvs_handle nvs;
+	size_t length = sizeof(*p);
+	esp_err_t err;
+
+	if (nvs_open(OTA_NVS, NVS_READONLY, &nvs) != ESP_OK)
+		return false;
+	err = nvs_get_blob(nvs, OTA_NVS_KEY, p, &length);
+	nvs_close(nvs);
+	if (err != ESP_OK || length != sizeof(*p))
+		return false;
+	p->url[sizeof(p->url) - 1] = '\0';
+	p->etag[sizeof(p->etag) - 1] = '\0';
+	return true;
+}
+
+static void progress_save(const ota_progress *p)
+{
+	nvs_handle nvs;
+	esp_err_t err = nvs_open(OTA_NVS, NVS_READWRITE, &nvs);
+
+	if (err == ESP_OK)
+	{
+		err = nvs_set_blob(nvs, OTA_NVS_KEY, p, sizeof(*p));
+		if (err == ESP_OK)
+			err = nvs_commit(nvs);
+		nvs_close(nvs);
+	}
+	if (err != ESP_OK)
+		ESP_LOGW(TAG, "Can't save the progress of the download (%d)", err);
+}
+
+static void progress_clear(void)
+{
+	nvs_handle nvs;
+
+	if (nvs_open(OTA_NVS, NVS_READWRITE, &nvs) != ESP_OK)
+		return;
+	if (nvs_erase_key(nvs, OTA_NVS_KEY) == ESP_OK)
+		nvs_commit(nvs);
+	nvs_close(nvs);
+}
+
+/*
+	Writes the next bytes of the image, erasing the sectors ahead of them
+	first. A resumed download goes on after what is already in flash -
+	bytes written after the last save of the progress are written again,
+	which leaves them as they were since the file is the same.
+*/
+static esp_err_t flash_write(const char *data, size_t len)
+{
+	esp_err_t err;
+
+	if (write_offset == 0 && len && (uint8_t)data[0] != IMAGE_MAGIC)
+	{
+		ESP_LOGE(TAG, "Not an app image (first byte 0x%02x)", (uint8_t)data[0]);
+		return ESP_ERR_OTA_VALIDATE_FAILED;
+	}
+	if (write_offset + len > update_partition->size)
+	{
+		ESP_LOGE(TAG, "Image is larger than the partition");
+		return ESP_ERR_INVALID_SIZE;
+	}
+
+	if (write_offset + len > erased)
+	{
+		size_t end = (write_offset + len + OTA_SECTOR - 1) / OTA_SECTOR * OTA_SECTOR;
+
+		err = esp_partition_erase_range(update_partition, erased, end - erased);
+		if (err != ESP_OK)
+			return err;
+		erased = end;
+	}
+
+	err = esp_partition_write(update_partition, write_offset, data, len);
+	if (err == ESP_OK)
+		write_offset += len;
+	return err;
+}
+
+/*
+	Takes filled buffers off the queue and writes them to flash. After a
+	write error the remaining buffers are still drained so the reader
+	never blocks waiting for one.
+*/
+static void ota_writer_task(void *arg)
+{
+	ota_block block;
+
+	while (xQueueReceive(full_q, &block, portMAX_DELAY) == pdPASS && block.len)
+	{
+		if (writer_err == ESP_OK)
+		{
+			writer_err = flash_write(block.buf, block.len);
+			if (writer_err == ESP_OK)
+			{
+				xSemaphoreTake(status_lock, portMAX_DELAY);
+				status.bytes_written += block.len;
+				xSemaphoreGive(status_lock);
+				if (save_progress && write_offset - progress.written >= OTA_SAVE_EVERY)
+				{
+					progress.written = write_offset;
+					progress_save(&progress);
+				}
+			}
+			else
+				ESP_LOGE(TAG, "Error writing fw (%d)", writer_err);
+		}
+		xQueueSend(free_q, &block.buf, portMAX_DELAY);
+	}
+
+	xSemaphoreGive(writer_done);
+	vTaskDelete(NULL);
+}
+
+static esp_err_t ota_event(esp_http_client_event_t *evt)
+{
+	ota_source *src = evt->user_data;
+
+	if (evt->event_id != HTTP_EVENT_ON_HEADER)
+		return ESP_OK;
+
+	if (strcasecmp(evt->header_key, "Content-Range") == 0)
+		src->range_start = strtoul(evt->header_value + strcspn(evt->header_value, "0123456789"), NULL, 10);
+	else if (strcasecmp(evt->header_key, "ETag") == 0
+		&& strlen(evt->header_value) < sizeof(src->sent_etag))
+		strcpy(src->sent_etag, evt->header_value);
+	return ESP_OK;
+}
+
+/*
+	Sends the request for the file, or for the rest of it. The server has
+	to answer a resume with the bytes that are missing - if the file
+	changed or the server ignores Range, the update can't go on. Only the
+	resume of an earlier attempt may get the whole file again, as nothing
+	of it has been read yet.
+*/
+static esp_err_t ota_open(ota_source *src)
+{
+	char range[24];
+	int len;
+
+	if (src->offset)
+	{
+		snprintf(range, sizeof(range), "bytes=%u-", (unsigned int)src->offset);
+		esp_http_client_set_header(src->client, "Range", range);
+		if (src->etag[0])
+			esp_http_client_set_header(src->client, "If-Range", src->etag);
+	}
+	src->range_start = 0;
+	src->sent_etag[0] = '\0';
+
+	if (esp_http_client_open(src->client, 0) != ESP_OK)
+	{
+		ESP_LOGE(TAG, "Error opening http client");
+		return ESP_FAIL;
+	}
+	len = esp_http_client_fetch_headers(src->client);
+	src->code = esp_http_client_get_status_code(src->client);
+	if (len < 0)
+	{
+		ESP_LOGE(TAG, "No response from server");
+		return ESP_FAIL;
+	}
+
+	if (src->code == 200 && (src->offset == 0 || src->restart))
+	{
+		if (src->offset)
+			ESP_LOGW(TAG, "The file has changed since - starting again");
+		src->offset = 0;
+		src->total = len;
+		strcpy(src->etag, src->sent_etag);
+		return ESP_OK;
+	}
+	if (src->offset && src->code == 206 && src->range_start == src->offset)
+		return ESP_OK;
+
+	ESP_LOGE(TAG, "Bad response from server (%d)", src->code);
+	return ESP_ERR_INVALID_RESPONSE;
+}
+
+/*
+	The connection dropped - wait a little longer each time and ask for
+	the rest of the file
+*/
+static esp_err_t ota_resume(ota_source *src)
+{
+	esp_http_client_close(src->client);
+	if (!src->total)
+	{
+		ESP_LOGE(TAG, "Connection lost - the size of the file isn't known, so it can't be resumed");
+		return ESP_FAIL;
+	}
+
+	while (src->retries > 0)
+	{
+		int delay = OTA_RETRY_DELAY << (OTA_RETRIES - src->retries);
+		esp_err_t err;
+
+		src->retries--;
+		ESP_LOGW(TAG, "Connection lost at %u of %u bytes - resuming in %d ms",
+			(unsigned int)src->offset, (unsigned int)src->total, delay);
+		vTaskDelay(delay / portTICK_PERIOD_MS);
+
+		err = ota_open(src);
+		if (err == ESP_OK)
+		{
+			xSemaphoreTake(status_lock, portMAX_DELAY);
+			status.resumes++;
+			xSemaphoreGive(status_lock);
+			return ESP_OK;
+		}
+		esp_http_client_close(src->client);
+		if (err == ESP_ERR_INVALID_RESPONSE)
+			return err;
+	}
+
+	ESP_LOGE(TAG, "Giving up after %d attempts", OTA_RETRIES);
+	return ESP_FAIL;
+}
+
+/*
+	Fill a whole buffer if the server sends that much, so flash is written
+	in large blocks. Returns the number of bytes read, or -1 on error.
+*/
+static int ota_read_block(ota_source *src, char *buf, int size)
+{
+	int len = 0;
+
+	while (len < size)
+	{
+		int n = esp_http_client_read(src->client, buf + len, size - len);
+
+		if (n > 0)
+		{
+			len += n;
+			src->offset += n;
+			src->retries = OTA_RETRIES;
+			continue;
+		}
+		// the end of the file - a short one is a dropped connection
+		if (n == 0 && (!src->total || src->offset >= src->total))
+			break;
+		if (ota_resume(src) != ESP_OK)
+			return -1;
+	}
+	return len;
+}
+
+/*
+	An image is written as it arrives. 'head' is what has been read of
+	it already.
+*/
+static esp_err_t ota_copy(ota_source *src, const char *head, int head_len)
+{
+	ota_block block;
+	int start = head_len;
+
+	while (1)
+	{
+		int n;
+
+		xQueueReceive(free_q, &block.buf, portMAX_DELAY);
+
+		// the writer won't see this block, stop reading
+		if (writer_err != ESP_OK)
+			return writer_err;
+
+		memcpy(block.buf, head, start);
+		n = ota_read_block(src, block.buf + start, OTA_BUF_SIZE - start);
+		if (n < 0)
+		{
+			ESP_LOGE(TAG, "Error reading socket");
+			return ESP_FAIL;
+		}
+		block.len = start + n;
+		start = 0;
+		if (block.len == 0)
+			return ESP_OK;
+		xQueueSend(full_q, &block, portMAX_DELAY);
+	}
+}
+
+static esp_err_t read_running(void *ctx, size_t offset, void *buf, size_t len)
+{
+	return esp_partition_read(ctx, offset, buf, len);
+}
+
+/*
+	A patch is read into a buffer of its own and the image it makes goes
+	to the writer in the usual blocks. On top of those the patch needs
+	one more buffer and its window.
+*/
+static esp_err_t ota_patch(ota_source *src, const char *head, int head_len)
+{
+	patch_state *p = malloc(sizeof(patch_state));
+	char *in = malloc(OTA_BUF_SIZE);
+	ota_block block;
+	int in_len = head_len;
+	int out_len = 0;
+	esp_err_t err = ESP_OK;
+
+	if (!p || !in)
+	{
+		free(in);
+		free(p);
+		return ESP_ERR_NO_MEM;
+	}
+
+	patch_init(p, read_running, (void*)esp_ota_get_running_partition());
+	memcpy(in, head, head_len);
+	xQueueReceive(free_q, &block.buf, portMAX_DELAY);
+	while (err == ESP_OK)
+	{
+		int n = ota_read_block(src, in + in_len, OTA_BUF_SIZE - in_len);
+		size_t pos = 0;
+		bool full;
+
+		if (n < 0)
+		{
+			ESP_LOGE(TAG, "Error reading socket");
+			err = ESP_FAIL;
+			break;
+		}
+		in_len += n;
+		if (in_len == 0)
+			break;
+
+		// a copy can go on after the input is used up, for as long as it fills blocks
+		do
+		{
+			size_t used;
+
+			n = patch_run(p, (const uint8_t*)in + pos, in_len - pos, &used,
+				(uint8_t*)block.buf + out_len, OTA_BUF_SIZE - out_len);
+			if (n < 0)
+			{
+				err = p->err;
+				break;
+			}
+			pos += used;
+			out_len += n;
+			full = out_len == OTA_BUF_SIZE;
+			if (full)
+			{
+				block.len = out_len;
+				xQueueSend(full_q, &block, portMAX_DELAY);
+				xQueueReceive(free_q, &block.buf, portMAX_DELAY);
+				out_len = 0;
+				if (writer_err != ESP_OK)
+					err = writer_err;
+			}
+		} while (err == ESP_OK && (pos < in_len || full));
+
+		// the size of the image is known once the header is in
+		xSemaphoreTake(status_lock, portMAX_DELAY);
+		status.bytes_total = p->header.size;
+		xSemaphoreGive(status_lock);
+		in_len = 0;
+	}
+
+	if (err == ESP_OK && out_len)
+	{
+		block.len = out_len;
+		xQueueSend(full_q, &block, portMAX_DELAY);
+	}
+	if (err == ESP_OK)
+		err = patch_finish(p);
+
+	free(in);
+	free(p);
+	return err;
+}
+
+/*
+	Writes the file to 'partition', after the 'src->offset' bytes of it
+	that an earlier attempt left there
+*/
+static esp_err_t ota_download(ota_source *src, const esp_partition_t *partition)
+{
+	esp_err_t err = ESP_OK;
+	ota_block block;
+	TaskHandle_t writer;
+	char head[PATCH_HEADER];
+	int head_len;
+
+	update_partition = partition;
+	write_offset = src->offset;
+	erased = (src->offset + OTA_SECTOR - 1) / OTA_SECTOR * OTA_SECTOR;
+	save_progress = false;
+
+	writer_err = ESP_OK;
+	if (xTaskCreate(ota_writer_task, "ota_write", OTA_STACK_SIZE, NULL, tskIDLE_PRIORITY + 2, &writer) != pdPASS)
+	{
+		ESP_LOGE(TAG, "Can't start flash writer");
+		return ESP_ERR_NO_MEM;
+	}
+	set_state(OTA_DOWNLOADING, ESP_OK);
+
+	// only a plain image is resumed from flash
+	if (src->offset)
+	{
+		save_progress = true;
+		err = ota_copy(src, head, 0);
+	}
+	else
+	{
+		// the first bytes say if this is an image or a patch
+		head_len = ota_read_block(src, head, sizeof(head));
+		if (head_len < 0)
+		{
+			ESP_LOGE(TAG, "Error reading socket");
+			err = ESP_FAIL;
+		}
+		else if (patch_detect(head, head_len))
+			err = ota_patch(src, head, head_len);
+		else
+		{
+			save_progress = src->etag[0] && src->total;
+			err = ota_copy(src, head, head_len);
+		}
+	}
+
+	// the empty block tells the writer to finish
+	block.len = 0;
+	xQueueSend(full_q, &block, portMAX_DELAY);
+	xSemaphoreTake(writer_done, portMAX_DELAY);
+	if (err == ESP_OK)
+		err = writer_err;
+	if (err == ESP_OK && write_offset == 0)
+	{
+		ESP_LOGE(TAG, "The image is empty");
+		err = ESP_ERR_OTA_VALIDATE_FAILED;
+	}
+
+	// a download the network cut short goes on from here next time
+	if (err == ESP_FAIL && save_progress)
+	{
+		progress.written = write_offset;
+		progress_save(&progress);
+		ESP_LOGI(TAG, "Kept %u bytes for the next attempt", (unsigned int)write_offset);
+	}
+	else
+		progress_clear();
+	return err;
+}
+
+static int hex_value(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+// 64 hex digits
+static bool parse_digest(const char *text, uint8_t *digest)
+{
+	for (int i = 0; i < OTA_DIGEST; i++)
+	{
+		int high = hex_value(text[i * 2]);
+		int low = high < 0 ? -1 : hex_value(text[i * 2 + 1]);
+
+		if (low < 0)
+			return false;
+		digest[i] = high << 4 | low;
+	}
+	return true;
+}
+
+/*
+	The SHA-256 of the image is in a manifest next to it, '<url>.sha256',
+	in the format of sha256sum - tools/mkdelta.py writes one with each
+	patch. Returns ESP_ERR_NOT_FOUND if the server has none.
+*/
+static esp_err_t ota_get_manifest(uint8_t *digest)
+{
+	char url[OTA_URL_SIZE + sizeof(MANIFEST_SUFFIX)];
+	char text[OTA_DIGEST * 2];
+	ota_source src = { .retries = OTA_RETRIES };
+	esp_http_client_config_t config =
+	{
+		.url = url,
+		.timeout_ms = OTA_TIMEOUT,
+		.event_handler = ota_event,
+		.user_data = &src,
+	};
+	esp_err_t err;
+
+	snprintf(url, sizeof(url), "%s" MANIFEST_SUFFIX, ota_url);
+	src.client = esp_http_client_init(&config);
+	if (!src.client)
+		return ESP_ERR_NO_MEM;
+
+	err = ota_open(&src);
+	if (err == ESP_OK && ota_read_block(&src, text, sizeof(text)) != sizeof(text))
+	{
+		ESP_LOGE(TAG, "Manifest is too short");
+		err = ESP_ERR_INVALID_SIZE;
+	}
+	else if (err == ESP_ERR_INVALID_RESPONSE && src.code == 404)
+		err = ESP_ERR_NOT_FOUND;
+	esp_http_client_cleanup(src.client);
+
+	if (err == ESP_OK && !parse_digest(text, digest))
+	{
+		ESP_LOGE(TAG, "Manifest doesn't start with a SHA-256");
+		err = ESP_ERR_INVALID_ARG;
+	}
+	return err;
+}
+
+/*
+	Hash the image as it is in flash, so whatever went wrong on the way -
+	the network, the patch or the flash - it isn't booted
+*/
+static esp_err_t ota_verify(const esp_partition_t *partition, size_t size, const uint8_t *digest)
+{
+	mbedtls_sha256_context ctx;
+	uint8_t buf[VERIFY_CHUNK];
+	uint8_t hash[OTA_DIGEST];
+	esp_err_t err = ESP_OK;
+
+	mbedtls_sha256_init(&ctx);
+	mbedtls_sha256_starts_ret(&ctx, 0);
+	for (size_t offset = 0; offset < size && err == ESP_OK; offset += sizeof(buf))
+	{
+		size_t len = MIN(sizeof(buf), size - offset);
+
+		err = esp_partition_read(partition, offset, buf, len);
+		if (err == ESP_OK)
+			mbedtls_sha256_update_ret(&ctx, buf, len);
+	}
+	mbedtls_sha256_finish_ret(&ctx, hash);
+	mbedtls_sha256_free(&ctx);
+
+	if (err != ESP_OK)
+	{
+		ESP_LOGE(TAG, "Can't read the new image (%d)", err);
+		return err;
+	}
+	if (memcmp(hash, digest, sizeof(hash)) != 0)
+	{
+		ESP_LOGE(TAG, "Image doesn't match its manifest");
+		return ESP_ERR_INVALID_CRC;
+	}
+	ESP_LOGI(TAG, "Image matches its manifest");
+	return ESP_OK;
+}
+
+static esp_err_t ota_run(void)
+{
+	const esp_partition_t *partition;
+	ota_source src = { .retries = OTA_RETRIES };
+	ota_progress saved;
+	uint8_t digest[OTA_DIGEST];
+	bool checked;
+	esp_err_t err;
+	esp_http_client_config_t config =
+	{
+		.url = ota_url,
+		.timeout_ms = OTA_TIMEOUT,
+		.event_handler = ota_event,
+		.user_data = &src,
+	};
+
+	memcpy(digest, ota_digest, sizeof(digest));
+	err = ota_has_digest ? ESP_OK : ota_get_manifest(digest);
+#ifdef CONFIG_WATER_OTA_UNCHECKED
+	if (err != ESP_OK && err != ESP_ERR_NOT_FOUND)
+		return err;
+	checked = err == ESP_OK;
+	if (!checked)
+		ESP_LOGW(TAG, "No manifest - the image is only checked by its format");
+#else
+	if (err == ESP_ERR_NOT_FOUND)
+		ESP_LOGE(TAG, "No manifest - not installing an image that can't be checked");
+	if (err != ESP_OK)
+		return err;
+	checked = true;
+#endif
+
+	partition = esp_ota_get_next_update_partition(NULL);
+	if (!partition)
+	{
+		ESP_LOGE(TAG, "Can't find partition for update");
+		return ESP_ERR_NOT_FOUND;
+	}
+
+	// the rest of the same file, if an earlier attempt got part of it
+	if (progress_load(&saved) && strcmp(saved.url, ota_url) == 0 && saved.partition == partition->address
+		&& saved.etag[0] && saved.written > 0 && saved.written < saved.total)
+	{
+		src.offset = saved.written;
+		src.total = saved.total;
+		src.restart = true;
+		strcpy(src.etag, saved.etag);
+	}
+
+	src.client = esp_http_client_init(&config);
+	if (!src.client)
+	{
+		ESP_LOGE(TAG, "Error initializing http client");
+		return ESP_FAIL;
+	}
+
+	err = ota_open(&src);
+	src.restart = false;
+	if (err != ESP_OK)
+	{
+		// a server error may pass, anything else won't give the rest of that file
+		if (src.offset && err == ESP_ERR_INVALID_RESPONSE && src.code < 500)
+			progress_clear();
+		esp_http_client_cleanup(src.client);
+		return err;
+	}
+
+	if (src.offset)
+		ESP_LOGI(TAG, "Resuming at %u of %u bytes", (unsigned int)src.offset, (unsigned int)src.total);
+	xSemaphoreTake(status_lock, portMAX_DELAY);
+	status.bytes_total = src.total;
+	status.bytes_written = src.offset;
+	status.resumed_from = src.offset;
+	xSemaphoreGive(status_lock);
+
+	strcpy(progress.url, ota_url);
+	strcpy(progress.etag, src.etag);
+	progress.partition = partition->address;
+	progress.written = src.offset;
+	progress.total = src.total;
+
+	ESP_LOGI(TAG, "Writing to partition type %i at offset 0x%x",
+		partition->subtype, partition->address);
+
+	err = ota_download(&src, partition);
+	esp_http_client_cleanup(src.client);
+	if (err != ESP_OK)
+		return err;
+
+	if (checked)
+	{
+		ota_status_t s;
+
+		ota_get_status(&s);
+		err = ota_verify(partition, s.bytes_written, digest);
+		if (err != ESP_OK)
+			return err;
+		xSemaphoreTake(status_lock, portMAX_DELAY);
+		status.verified = true;
+		xSemaphoreGive(status_lock);
+	}
+
+	if (esp_ota_set_boot_partition(partition) != ESP_OK)
+	{
+		ESP_LOGE(TAG, "Can't set boot partition");
+		return ESP_FAIL;
+	}
+	return ESP_OK;
+}
+
+static void ota_task(void *arg)
+{
+	char *bufs[OTA_BUFFERS] = { NULL };
+	esp_err_t err = ESP_ERR_NO_MEM;
+	bool allocated;
+	int i;
+
+	ESP_LOGI(TAG, "allocating %u bytes", OTA_BUFFERS * OTA_BUF_SIZE);
+	free_q = xQueueCreate(OTA_BUFFERS, sizeof(char *));
+	full_q = xQueueCreate(OTA_BUFFERS + 1, sizeof(ota_block));
+	writer_done = xSemaphoreCreateBinary();
+	allocated = free_q && full_q && writer_done;
+	for (i = 0; i < OTA_BUFFERS; i++)
+	{
+		bufs[i] = malloc(OTA_BUF_SIZE);
+		allocated = allocated && bufs[i];
+	}
+
+	if (allocated)
+	{
+		for (i = 0; i < OTA_BUFFERS; i++)
+			xQueueSend(free_q, &bufs[i], 0);
+		err = ota_run();
+	}
+	else
+		ESP_LOGE(TAG, "Can't allocate memory");
+
+	for (i = 0; i < OTA_BUFFERS; i++)
+		free(bufs[i]);
+	if (writer_done)
+		vSemaphoreDelete(writer_done);
+	if (full_q)
+		vQueueDelete(full_q);
+	if (free_q)
+		vQueueDelete(free_q);
+
+	if (err == ESP_OK)
+	{
+		ota_status_t s;
+
+		ota_get_status(&s);
+		ESP_LOGI(TAG, "Update done - %u bytes", (unsigned int)s.bytes_written);
+	}
+	set_state(err == ESP_OK ? OTA_DONE : OTA_FAILED, err);
+
+	if (ota_done)
+		ota_done(err);
+	vTaskDelete(NULL);
+}
+
+esp_err_t ota_start(const char *url, const char *sha256, void (*done)(esp_err_t err))
+{
+	uint8_t digest[OTA_DIGEST];
+
+	if (strlen(url) >= sizeof(ota_url))
+		return ESP_ERR_INVALID_ARG;
+	if (sha256 && (strlen(sha256) != OTA_DIGEST * 2 || !parse_digest(sha256, digest)))
+		return ESP_ERR_INVALID_ARG;
+
+	if (!status_lock)
+	{
+		status_lock = xSemaphoreCreateMutex();
+		if (!status_lock)
+			return ESP_ERR_NO_MEM;
+	}
+
+	xSemaphoreTake(status_lock, portMAX_DELAY);
+	if (status.state == OTA_CONNECTING || status.state == OTA_DOWNLOADING)
+	{
+		xSemaphoreGive(status_lock);
+		return ESP_ERR_INVALID_STATE;
+	}
+	memset(&status, 0, sizeof(status));
+	status.state = OTA_CONNECTING;
+	status.start_time = esp_timer_get_time();
+	xSemaphoreGive(status_lock);
+
+	strcpy(ota_url, url);
+	ota_has_digest = sha256 != NULL;
+	if (sha256)
+		memcpy(ota_digest, digest, sizeof(digest));
+	ota_done = done;
+	if (xTaskCreate(ota_task, "ota", OTA_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL) != pdPASS)
+	{
+		set_state(OTA_FAILED, ESP_ERR_NO_MEM);
+		return ESP_ERR_NO_MEM;
+	}
+
+	ESP_LOGI(TAG, "Update started from %s", url);
+	return ESP_OK;
+}
@@ -0,0 +1,53 @@
+#ifndef _OTA_H
+#define _OTA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum
+{
+	OTA_IDLE,			// no update has been started since boot
+	OTA_CONNECTING,	// waiting for the server to answer
+	OTA_DOWNLOADING,	// copying the image to flash
+	OTA_DONE,			// the new image is marked for the next boot
+	OTA_FAILED,
+} ota_state_t;
+
+typedef struct ota_status
+{
+	ota_state_t state;
+	size_t bytes_written;	// bytes of the image in flash so far
+	size_t bytes_total;		// content length of the image, 0 if unknown
+	size_t resumed_from;		// bytes an earlier attempt left in flash
+	unsigned int resumes;	// times the download went on after the connection dropped
+	bool verified;				// the image matched the SHA-256 in its manifest
+	int64_t start_time;		// esp_timer_get_time() when the update started
+	int64_t end_time;			// and when it finished (0 while running)
+	esp_err_t err;				// reason for OTA_FAILED
+} ota_status_t;
+
+/*
+	Firmware updates run in a task of their own so the web server stays
+	responsive. Data is read from the network into one buffer while the
+	other is written to flash. A dropped connection is resumed with a
+	Range request. How far a plain image got is kept in NVS, so the next
+	attempt with the same URL - after a reboot too - asks for the rest
+	with If-Range and only starts again if the file has changed. The
+	image in flash has to match 'sha256' (64 hex digits) before it is
+	booted - if that is NULL, it is fetched from '<url>.sha256', and if
+	the server has none the update fails with ESP_ERR_NOT_FOUND (unless
+	CONFIG_WATER_OTA_UNCHECKED is set, when the image is only checked by
+	its format).
+	'done' is called from the update task when the update has finished,
+	successfully or not.
+*/
+esp_err_t ota_start(const char *url, const char *sha256, void (*done)(esp_err_t err));
+
+// a snapshot of the progress of the current (or last) update
+void ota_get_status(ota_status_t *status);
+
+const char *ota_state_name(ota_state_t state);
+
+#endif // _OTA_H
@@ -0,0 +1,287 @@
+#include <string.h>
+#include "esp_log.h"
+#include "crc.h"
+#include "patch.h"
+
+#define OP_LITERAL 0
+#define OP_REPEAT 1
+#define OP_BASE 2
+#define LONG_LENGTH 63		// the length goes on in a varint
+#define BASE_CHUNK 256		// bytes of the base read at once for its CRC
+
+enum
+{
+	PHASE_HEADER,
+	PHASE_TAG,
+	PHASE_LENGTH,
+	PHASE_ARG,
+	PHASE_LITERAL,
+	PHASE_COPY,
+	PHASE_ERROR,
+};
+
+static const char *TAG="PATCH";
+static const uint8_t magic[4] = { 'W', 'P', 'T', '1' };
+
+static uint32_t get32(const uint8_t *p)
+{
+	return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+bool patch_detect(const void *data, size_t len)
+{
+	return len >= sizeof(magic) && memcmp(data, magic, sizeof(magic)) == 0;
+}
+
+void patch_init(patch_state *p, patch_read_fn read_base, void *ctx)
+{
+	memset(p, 0, sizeof(*p));
+	p->read_base = read_base;
+	p->ctx = ctx;
+	p->phase = PHASE_HEADER;
+}
+
+static int fail(patch_state *p, esp_err_t err, const char *why)
+{
+	ESP_LOGE(TAG, "%s at byte %u of the image", why, p->written);
+	p->err = err;
+	p->phase = PHASE_ERROR;
+	return -1;
+}
+
+/*
+	A delta only works against the image it was made from
+*/
+static esp_err_t check_base(patch_state *p)
+{
+	uint8_t buf[BASE_CHUNK];
+	uint32_t crc = 0;
+
+	for (uint32_t pos = 0; pos < p->header.base_size; pos += sizeof(buf))
+	{
+		size_t len = p->header.base_size - pos < sizeof(buf) ? p->header.base_size - pos : sizeof(buf);
+		esp_err_t err = p->read_base(p->ctx, pos, buf, len);
+
+		if (err != ESP_OK)
+			return err;
+		crc = crc32(crc, buf, len);
+	}
+	return crc == p->header.base_crc ? ESP_OK : ESP_ERR_INVALID_VERSION;
+}
+
+static int parse_header(patch_state *p)
+{
+	const uint8_t *h = p->head;
+
+	if (!patch_detect(h, PATCH_HEADER))
+		return fail(p, ESP_ERR_INVALID_ARG, "Not a patch");
+
+	p->header.type = h[4];
+	p->header.size = get32(&h[8]);
+	p->header.crc = get32(&h[12]);
+	p->header.base_size = get32(&h[16]);
+	p->header.base_crc = get32(&h[20]);
+	if (p->header.type > PATCH_DELTA)
+		return fail(p, ESP_ERR_NOT_SUPPORTED, "Unknown patch type");
+
+	if (p->header.type == PATCH_DELTA)
+	{
+		esp_err_t err = p->read_base ? check_base(p) : ESP_ERR_NOT_SUPPORTED;
+
+		if (err != ESP_OK)
+			return fail(p, err, "Patch is for another image");
+	}
+
+	ESP_LOGI(TAG, "%s of %u bytes", p->header.type == PATCH_DELTA ? "Delta" : "Compressed image", p->header.size);
+	p->phase = PHASE_TAG;
+	return 0;
+}
+
+// 'out' has been filled with 'n' more bytes of the image
+static void produced(patch_state *p, const uint8_t *out, size_t n)
+{
+	p->crc = crc32(p->crc, out, n);
+	for (size_t i = 0; i < n; i++)
+		p->window[(p->written + i) % PATCH_WINDOW] = out[i];
+	p->written += n;
+}
+
+/*
+	The command is complete - check that it stays inside the image, the
+	window and the base
+*/
+static int start_command(patch_state *p)
+{
+	if (p->len == 0 || p->len > p->header.size - p->written)
+		return fail(p, ESP_ERR_INVALID_SIZE, "Bad length");
+
+	switch (p->op)
+	{
+	case OP_LITERAL:
+		p->phase = PHASE_LITERAL;
+		return 0;
+
+	case OP_REPEAT:
+		if (p->varint == 0 || p->varint > PATCH_WINDOW || p->varint > p->written)
+			return fail(p, ESP_ERR_INVALID_SIZE, "Bad distance");
+		p->from = p->varint;
+		break;
+
+	case OP_BASE:
+		// zigzag: the low bit is the sign
+		p->from = p->base_pos + ((p->varint >> 1) ^ -(p->varint & 1));
+		if (p->header.type != PATCH_DELTA || p->from > p->header.base_size
+			|| p->len > p->header.base_size - p->from)
+			return fail(p, ESP_ERR_INVALID_SIZE, "Bad base copy");
+		p->base_pos = p->from + p->len;
+		break;
+
+	default:
+		return fail(p, ESP_ERR_INVALID_ARG, "Bad command");
+	}
+
+	p->phase = PHASE_COPY;
+	return 0;
+}
+
+// the next byte of a varint - true when it is complete
+static bool varint_byte(patch_state *p, uint8_t b)
+{
+	p->varint |= (uint32_t)(b & 0x7F) << p->shift;
+	p->shift += 7;
+	return !(b & 0x80);
+}
+
+int patch_run(patch_state *p, const uint8_t *in, size_t in_len, size_t *used, uint8_t *out, size_t out_size)
+{
+	size_t i = 0;
+	size_t o = 0;
+
+	while (p->phase != PHASE_ERROR && o < out_size && (i < in_len || p->phase == PHASE_COPY))
+	{
+		uint8_t b;
+		size_t n;
+
+		switch (p->phase)
+		{
+		case PHASE_HEADER:
+			n = PATCH_HEADER - p->len;
+			if (n > in_len - i)
+				n = in_len - i;
+			memcpy(&p->head[p->len], &in[i], n);
+			p->len += n;
+			i += n;
+			if (p->len == PATCH_HEADER)
+			{
+				p->len = 0;
+				parse_header(p);
+			}
+			break;
+
+		case PHASE_TAG:
+			b = in[i++];
+			p->op = b >> 6;
+			p->len = b & LONG_LENGTH;
+			p->varint = 0;
+			p->shift = 0;
+			if (p->len == LONG_LENGTH)
+				p->phase = PHASE_LENGTH;
+			else if (p->op == OP_LITERAL)
+				start_command(p);
+			else
+				p->phase = PHASE_ARG;
+			break;
+
+		case PHASE_LENGTH:
+			if (p->shift > 28)
+			{
+				fail(p, ESP_ERR_INVALID_SIZE, "Bad length");
+				break;
+			}
+			if (!varint_byte(p, in[i++]))
+				break;
+			p->len = LONG_LENGTH + p->varint;
+			p->varint = 0;
+			p->shift = 0;
+			if (p->len < LONG_LENGTH)
+				fail(p, ESP_ERR_INVALID_SIZE, "Bad length");
+			else if (p->op == OP_LITERAL)
+				start_command(p);
+			else
+				p->phase = PHASE_ARG;
+			break;
+
+		case PHASE_ARG:
+			if (p->shift > 28)
+			{
+				fail(p, ESP_ERR_INVALID_SIZE, "Bad argument");
+				break;
+			}
+			if (varint_byte(p, in[i++]))
+				start_command(p);
+			break;
+
+		case PHASE_LITERAL:
+			n = p->len;
+			if (n > in_len - i)
+				n = in_len - i;
+			if (n > out_size - o)
+				n = out_size - o;
+			memcpy(&out[o], &in[i], n);
+			produced(p, &out[o], n);
+			i += n;
+			o += n;
+			p->len -= n;
+			if (p->len == 0)
+				p->phase = PHASE_TAG;
+			break;
+
+		case PHASE_COPY:
+			n = p->len;
+			if (n > out_size - o)
+				n = out_size - o;
+			if (p->op == OP_BASE)
+			{
+				esp_err_t err = p->read_base(p->ctx, p->from, &out[o], n);
+
+				if (err != ESP_OK)
+				{
+					fail(p, err, "Can't read the base");
+					break;
+				}
+				p->from += n;
+				produced(p, &out[o], n);
+			}
+			else
+			{
+				// byte by byte, so a copy may overlap what it is writing
+				for (size_t k = 0; k < n; k++)
+				{
+					out[o + k] = p->window[(p->written - p->from) % PATCH_WINDOW];
+					p->window[p->written % PATCH_WINDOW] = out[o + k];
+					p->written++;
+				}
+				p->crc = crc32(p->crc, &out[o], n);
+			}
+			o += n;
+			p->len -= n;
+			if (p->len == 0)
+				p->phase = PHASE_TAG;
+			break;
+		}
+	}
+
+	*used = i;
+	return p->phase == PHASE_ERROR ? -1 : o;
+}
+
+esp_err_t patch_finish(patch_state *p)
+{
+	if (p->phase == PHASE_ERROR)
+		return p->err;
+	if (p->phase != PHASE_TAG || p->written != p->header.size)
+		return fail(p, ESP_ERR_INVALID_SIZE, "Patch ended early");
+	if (p->crc != p->header.crc)
+		return fail(p, ESP_ERR_INVALID_CRC, "Image CRC doesn't match");
+	return ESP_OK;
+}
@@ -0,0 +1,76 @@
+#ifndef _PATCH_H
+#define _PATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define PATCH_HEADER 24
+#define PATCH_WINDOW 4096			// how far back a copy from the output reaches
+#define PATCH_FULL 0					// a compressed image
+#define PATCH_DELTA 1				// also copies from the running image
+
+/*
+	A compressed firmware image, or the difference from the running one,
+	made by tools/mkdelta.py. The header is
+		"WPT1", type (1), reserved (3), image size (4), image CRC-32 (4),
+		base size (4), base CRC-32 (4)
+	and is followed by commands. Each starts with a byte of op << 6 |
+	length, where a length of 63 means 63 plus a varint:
+		0 literal: 'length' bytes that are copied to the image
+		1 repeat: a varint distance back into the image written so far
+		2 base: a zigzag varint offset into the running image, counted from
+		  the end of the last base copy
+	Varints are LEB128. The image CRC is checked at the end, and the base
+	CRC before anything is written, so a delta made against another image
+	is refused.
+*/
+typedef struct patch_header
+{
+	uint8_t type;
+	uint32_t size;
+	uint32_t crc;
+	uint32_t base_size;
+	uint32_t base_crc;
+} patch_header;
+
+// reads from the image the delta was made against
+typedef esp_err_t (*patch_read_fn)(void *ctx, size_t offset, void *buf, size_t len);
+
+typedef struct patch_state
+{
+	patch_header header;
+	patch_read_fn read_base;
+	void *ctx;
+	uint8_t head[PATCH_HEADER];	// the header as it arrives
+	uint8_t phase;
+	uint8_t op;
+	uint8_t shift;					// of the next 7 bits of a varint
+	uint32_t varint;
+	uint32_t len;					// of the command, then what is left of it
+	uint32_t base_pos;			// where the next base copy is counted from
+	uint32_t from;					// source of the copy that is running
+	uint32_t written;				// bytes of the image produced
+	uint32_t crc;
+	esp_err_t err;
+	uint8_t window[PATCH_WINDOW];	// the last bytes of the image
+} patch_state;
+
+// is this the start of a patch rather than an image?
+bool patch_detect(const void *data, size_t len);
+
+void patch_init(patch_state *p, patch_read_fn read_base, void *ctx);
+
+/*
+	Runs the patch over 'in' and writes the image to 'out'. Returns the
+	number of bytes written to 'out', which stops at 'out_size' - call
+	again with the rest of 'in' (the number used is in 'used') and a new
+	'out' until both are done. Returns -1 on an error.
+*/
+int patch_run(patch_state *p, const uint8_t *in, size_t in_len, size_t *used, uint8_t *out, size_t out_size);
+
+// at the end of the patch - ESP_OK if the whole image was made and its CRC matches
+esp_err_t patch_finish(patch_state *p);
+
+#endif // _PATCH_H
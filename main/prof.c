@@ -0,0 +1,77 @@
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "prof.h"
+
+static SemaphoreHandle_t lock;
+static prof_span ring[PROF_MAX_SPANS];
+static unsigned int total;			// spans ever started - the next id
+static uint8_t open_spans;
+
+void prof_init(void)
+{
+	lock = xSemaphoreCreateMutex();
+}
+
+static int record(const char *name, int64_t now, bool open)
+{
+	prof_span *span;
+	int id;
+
+	if (!lock)
+		return -1;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	id = total++;
+	span = &ring[id % PROF_MAX_SPANS];
+	span->name = name;
+	span->start = now;
+	span->end = open ? 0 : now;
+	span->depth = open_spans;
+	if (open)
+		open_spans++;
+	xSemaphoreGive(lock);
+	return id;
+}
+
+int prof_begin(const char *name)
+{
+	return record(name, esp_timer_get_time(), true);
+}
+
+void prof_end(int id)
+{
+	int64_t now = esp_timer_get_time();
+
+	if (id < 0)
+		return;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	open_spans--;
+
+	// the ring may have moved on since
+	if (total - id <= PROF_MAX_SPANS)
+		ring[id % PROF_MAX_SPANS].end = now;
+	xSemaphoreGive(lock);
+}
+
+void prof_mark(const char *name)
+{
+	record(name, esp_timer_get_time(), false);
+}
+
+unsigned int prof_get(prof_span *spans, unsigned int max)
+{
+	unsigned int first, count = 0;
+
+	if (!lock)
+		return 0;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	first = total > PROF_MAX_SPANS ? total - PROF_MAX_SPANS : 0;
+	for (unsigned int id = first; id < total && count < max; id++)
+		spans[count++] = ring[id % PROF_MAX_SPANS];
+	xSemaphoreGive(lock);
+	return count;
+}
@@ -0,0 +1,33 @@
+#ifndef _PROF_H
+#define _PROF_H
+
+#include <stdint.h>
+
+#define PROF_MAX_SPANS 32			// the newest spans are kept
+
+typedef struct prof_span
+{
+	const char *name;				// must stay valid - normally a string literal
+	int64_t start;					// esp_timer_get_time()
+	int64_t end;					// 0 while the span is open
+	uint8_t depth;					// spans open (in any task) when it started
+} prof_span;
+
+/*
+	Named spans of time, for finding out where start up goes. A span is
+	a few words in a fixed ring, so they can be left in. Call prof_init()
+	first thing - spans before that are not recorded.
+*/
+void prof_init(void);
+
+// returns the id to end the span with
+int prof_begin(const char *name);
+void prof_end(int id);
+
+// a span with no length
+void prof_mark(const char *name);
+
+// copies the spans, oldest first, and returns how many there were
+unsigned int prof_get(prof_span *spans, unsigned int max);
+
+#endif // _PROF_H
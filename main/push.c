@@ -0,0 +1,189 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "push.h"
+
+#define MAX_EVENT 256		// longest event that is sent
+
+typedef struct push_client
+{
+	bool used;
+	int fd;
+} push_client;
+
+static const char *TAG="PUSH";
+static const char stream_start[] =
+	"HTTP/1.1 200 OK\r\n"
+	"Content-Type: text/event-stream\r\n"
+	"Cache-Control: no-cache\r\n"
+	"\r\n"
+	"retry: 5000\n\n";
+
+// the clients are only used in the web server task
+static push_client clients[PUSH_MAX_CLIENTS];
+static unsigned int num_clients;
+static httpd_handle_t server;
+static push_render_fn render;
+static esp_timer_handle_t keepalive_timer;
+
+// shared with the other tasks
+static SemaphoreHandle_t lock;
+static uint32_t pending;
+static bool queued;
+
+static void keepalive_callback(void *arg)
+{
+	push_notify(PUSH_HEARTBEAT);
+}
+
+void push_init(push_render_fn fn)
+{
+	const esp_timer_create_args_t keepalive_timer_args = {
+		.callback = keepalive_callback,
+		.dispatch_method = ESP_TIMER_TASK,
+		.name = "push"
+	};
+
+	render = fn;
+	lock = xSemaphoreCreateMutex();
+	esp_timer_create(&keepalive_timer_args, &keepalive_timer);
+}
+
+void push_start(httpd_handle_t handle)
+{
+	server = handle;
+}
+
+/*
+	The sessions have been closed along with the server
+*/
+void push_stop(void)
+{
+	xSemaphoreTake(lock, portMAX_DELAY);
+	server = NULL;
+	pending = 0;
+	xSemaphoreGive(lock);
+
+	esp_timer_stop(keepalive_timer);
+	memset(clients, 0, sizeof(clients));
+	num_clients = 0;
+}
+
+/*
+	Called by the web server when the session of a client closes
+*/
+static void client_gone(void *ctx)
+{
+	push_client *client = ctx;
+
+	if (!client->used)
+		return;
+	client->used = false;
+	if (--num_clients == 0)
+		esp_timer_stop(keepalive_timer);
+	ESP_LOGI(TAG, "Client %d gone, %u left", client->fd, num_clients);
+}
+
+static void send_all(const char *data, size_t len)
+{
+	for (unsigned int i = 0; i < PUSH_MAX_CLIENTS; i++)
+	{
+		push_client *client = &clients[i];
+
+		if (!client->used)
+			continue;
+
+		// a client that can't keep up is dropped - it reconnects and reloads
+		if (httpd_socket_send(server, client->fd, data, len, 0) != len)
+		{
+			ESP_LOGW(TAG, "Client %d not taking events", client->fd);
+			httpd_sess_trigger_close(server, client->fd);
+		}
+	}
+}
+
+void push_send(const char *event, const char *data)
+{
+	char buf[MAX_EVENT];
+	int len = snprintf(buf, sizeof(buf), "event: %s\ndata: %s\n\n", event, data);
+
+	if (len >= sizeof(buf))
+	{
+		ESP_LOGE(TAG, "%s event too long", event);
+		return;
+	}
+	send_all(buf, len);
+}
+
+static void push_work(void *arg)
+{
+	uint32_t changes;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	changes = pending;
+	pending = 0;
+	queued = false;
+	xSemaphoreGive(lock);
+
+	if (!num_clients || !changes)
+		return;
+
+	render(changes);
+	if (changes & PUSH_HEARTBEAT)
+		send_all(":\n\n", 3);
+}
+
+void push_notify(uint32_t changes)
+{
+	bool queue;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	pending |= changes;
+	queue = server && !queued;
+	if (queue)
+		queued = true;
+	xSemaphoreGive(lock);
+
+	// one piece of work carries everything that changes until it runs
+	if (queue && httpd_queue_work(server, push_work, NULL) != ESP_OK)
+	{
+		xSemaphoreTake(lock, portMAX_DELAY);
+		queued = false;
+		xSemaphoreGive(lock);
+	}
+}
+
+esp_err_t push_handler(httpd_req_t *req)
+{
+	push_client *client = NULL;
+	int fd = httpd_req_to_sockfd(req);
+
+	for (unsigned int i = 0; i < PUSH_MAX_CLIENTS && !client; i++)
+	{
+		if (!clients[i].used)
+			client = &clients[i];
+	}
+	if (!client)
+	{
+		httpd_resp_set_status(req, "503 Service Unavailable");
+		httpd_resp_set_hdr(req, "Retry-After", "60");
+		return httpd_resp_send(req, NULL, 0);
+	}
+
+	// the response never ends, so it is written straight to the socket
+	if (httpd_socket_send(req->handle, fd, stream_start, sizeof(stream_start) - 1, 0) != sizeof(stream_start) - 1)
+		return ESP_FAIL;
+
+	client->used = true;
+	client->fd = fd;
+	req->sess_ctx = client;
+	req->free_ctx = client_gone;
+	if (num_clients++ == 0)
+		esp_timer_start_periodic(keepalive_timer, PUSH_KEEPALIVE * 1000000ULL);
+	ESP_LOGI(TAG, "Client %d listening", fd);
+	return ESP_OK;
+}
@@ -0,0 +1,34 @@
+#ifndef _PUSH_H
+#define _PUSH_H
+
+#include <stdint.h>
+#include <esp_http_server.h>
+
+#define PUSH_MAX_CLIENTS 3			// open event streams - each one keeps a socket
+#define PUSH_KEEPALIVE 30			// seconds between comments on an idle stream
+#define PUSH_HEARTBEAT (1U << 31)	// passed to the render function with each keepalive
+
+/*
+	Server-Sent Events on GET /events. Anything that changes state calls
+	push_notify() with a bit for what changed, from any task. The bits
+	collect until the web server task gets to them, then the render
+	function is called there with all of them and sends one event per
+	change with push_send(). Nothing runs while no one is listening.
+*/
+typedef void (*push_render_fn)(uint32_t changes);
+
+void push_init(push_render_fn render);
+
+// the web server has started or stopped
+void push_start(httpd_handle_t server);
+void push_stop(void);
+
+// URI handler that turns the request into an event stream
+esp_err_t push_handler(httpd_req_t *req);
+
+void push_notify(uint32_t changes);
+
+// only from the render function - 'data' is one line
+void push_send(const char *event, const char *data);
+
+#endif // _PUSH_H
@@ -0,0 +1,172 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "bench.h"
+#include "query.h"
+
+unsigned int BENCH_HOT query_parse(query_index *q, char *query)
+{
+	char *p = query;
+
+	q->count = 0;
+	while (*p && q->count < QUERY_MAX_PARAMS)
+	{
+		query_param *param = &q->params[q->count];
+		char *value = NULL;
+		char *end;
+
+		param->key = p;
+		while (*p && *p != '&')
+		{
+			if (*p == '=' && !value)
+			{
+				*p = '\0';
+				value = p + 1;
+			}
+			p++;
+		}
+		end = p;
+		if (*p)
+			*p++ = '\0';
+
+		// "&&" and "&=x" don't name anything
+		if (param->key[0] == '\0')
+			continue;
+
+		// never longer than it was
+		if (value)
+			url_decode(value, end - value + 1, value, end - value);
+		param->value = value ? value : "";
+		q->count++;
+	}
+
+	return q->count;
+}
+
+const char *query_get(const query_index *q, const char *key)
+{
+	for (unsigned int i = 0; i < q->count; i++)
+	{
+		if (strcmp(q->params[i].key, key) == 0)
+			return q->params[i].value;
+	}
+	return NULL;
+}
+
+uint32_t BENCH_HOT query_hash(const char *str, uint32_t seed)
+{
+	uint32_t hash = seed;
+
+	while (*str)
+	{
+		hash ^= (uint8_t)*str++;
+		hash *= 16777619;
+	}
+	return hash;
+}
+
+#define ONES 0x01010101u
+#define HIGHS 0x80808080u
+
+// some byte of 'v' is 0
+#define HAS_ZERO(v) (((v) - ONES) & ~(v) & HIGHS)
+
+static int hex_value(unsigned char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	c |= 0x20;
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	return -1;
+}
+
+/*
+	The length of the run at 's' with no '%' or '+' in it, at most 'len'.
+	Aligned words are tested four bytes at a time.
+*/
+static size_t BENCH_HOT clean_run(const char *s, size_t len)
+{
+	const char *p = s;
+	const char *end = s + len;
+
+	while (p < end && ((uintptr_t)p & 3))
+	{
+		if (*p == '%' || *p == '+')
+			return p - s;
+		p++;
+	}
+	while (end - p >= 4)
+	{
+		uint32_t v;
+
+		memcpy(&v, __builtin_assume_aligned(p, 4), 4);
+		if (HAS_ZERO(v ^ (ONES * '%')) | HAS_ZERO(v ^ (ONES * '+')))
+			break;
+		p += 4;
+	}
+	while (p < end && *p != '%' && *p != '+')
+		p++;
+	return p - s;
+}
+
+int BENCH_HOT url_decode(char *dst, size_t size, const char *src, size_t len)
+{
+	size_t out = 0;
+
+	if (size == 0)
+		return -1;
+
+	while (len)
+	{
+		size_t n;
+		int hi, lo;
+
+		if (out == size - 1)
+		{
+			dst[out] = '\0';
+			return -1;
+		}
+
+		if (*src == '+')
+		{
+			dst[out++] = ' ';
+			src++;
+			len--;
+			continue;
+		}
+		if (*src == '%')
+		{
+			if (len >= 3 && (hi = hex_value(src[1])) >= 0 && (lo = hex_value(src[2])) >= 0)
+			{
+				dst[out++] = hi << 4 | lo;
+				src += 3;
+				len -= 3;
+			}
+			else
+			{
+				// not an escape, so it is kept as it is
+				dst[out++] = '%';
+				src++;
+				len--;
+			}
+			continue;
+		}
+
+		n = clean_run(src, len);
+		if (n > size - 1 - out)
+		{
+			memmove(dst + out, src, size - 1 - out);
+			dst[size - 1] = '\0';
+			return -1;
+		}
+		// in place, nothing moves until the first escape
+		if (dst + out != src)
+			memmove(dst + out, src, n);
+		out += n;
+		src += n;
+		len -= n;
+	}
+	dst[out] = '\0';
+	return out;
+}
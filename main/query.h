@@ -0,0 +1,44 @@
+#ifndef _QUERY_H
+#define _QUERY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define QUERY_MAX_PARAMS 16		// parameters kept from one query, the rest are ignored
+
+typedef struct query_param
+{
+	const char *key;
+	const char *value;			// url decoded, "" if there was no '='
+} query_param;
+
+/*
+	The parameters of a query string, found in one pass over it. The keys
+	and values point into the query, which is split and decoded in place,
+	so it has to outlive the index.
+*/
+typedef struct query_index
+{
+	unsigned int count;
+	query_param params[QUERY_MAX_PARAMS];
+} query_index;
+
+// returns the number of parameters found
+unsigned int query_parse(query_index *q, char *query);
+
+// the value of the first parameter called 'key', NULL if there isn't one
+const char *query_get(const query_index *q, const char *key);
+
+// FNV-1a with 'seed' as the offset basis - tools/gen_action_hash.py must match
+uint32_t query_hash(const char *str, uint32_t seed);
+
+/*
+	Decodes the 'len' bytes at 'src', with %XX for a byte and '+' for a
+	space, into 'dst', which is always terminated. A '%' that doesn't
+	start an escape is kept. 'dst' may be the same as 'src'. Returns the
+	decoded length, or -1 if it didn't fit in 'size' bytes - 'dst' then
+	has as much as fitted.
+*/
+int url_decode(char *dst, size_t size, const char *src, size_t len);
+
+#endif // _QUERY_H
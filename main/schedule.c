@@ -0,0 +1,307 @@
+#include <string.h>
+#include "bench.h"
+#include "schedule.h"
+
+time_t schedule_event_next(const water_event *event, time_t now)
+{
+	struct tm timeinfo = { 0 };
+	uint8_t first;
+
+	if (!event->enabled)
+		return SCHEDULE_NEVER;
+
+	if (event->skip > 0)
+		return (now / event->skip + 1) * event->skip;
+
+	localtime_r(&now, &timeinfo);
+
+	// past on the wall clock - when it goes back an hour, today's time comes round again
+	first = timeinfo.tm_hour > event->hour || (timeinfo.tm_hour == event->hour && timeinfo.tm_min >= event->minute);
+
+	timeinfo.tm_hour = event->hour;
+	timeinfo.tm_min = event->minute;
+	timeinfo.tm_sec = 0;
+
+	// today may already be over, so look one day past a full week
+	for (uint8_t day = first; day < 8; day++)
+	{
+		struct tm candidate = timeinfo;
+		time_t t;
+
+		// let mktime() normalize the day and work out DST and the weekday
+		candidate.tm_mday += day;
+		candidate.tm_isdst = -1;
+		t = mktime(&candidate);
+		if (t == (time_t)-1 || t <= now)
+			continue;
+
+		if (event->days == 0 || event->days & (1 << candidate.tm_wday))
+			return t;
+	}
+
+	return SCHEDULE_NEVER;
+}
+
+time_t schedule_next(const water_event *events, unsigned int count, time_t now)
+{
+	time_t next = SCHEDULE_NEVER;
+
+	for (unsigned int evt = 0; evt < count; evt++)
+	{
+		time_t t = schedule_event_next(&events[evt], now);
+		if (t != SCHEDULE_NEVER && (next == SCHEDULE_NEVER || t < next))
+			next = t;
+	}
+
+	return next;
+}
+
+/*
+	CRC-16/CCITT - the blob is small enough that a table isn't worth the flash
+*/
+static uint16_t crc16(uint16_t crc, const uint8_t *data, size_t len)
+{
+	while (len--)
+	{
+		crc ^= *data++ << 8;
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+static uint16_t blob_crc(const uint8_t *blob, size_t len)
+{
+	uint16_t crc = crc16(0xFFFF, blob, 4);
+	return crc16(crc, blob + SCHEDULE_BLOB_HEADER, len - SCHEDULE_BLOB_HEADER);
+}
+
+/*
+	Events that never fire go to the end of the heap
+*/
+static bool BENCH_HOT fires_before(const schedule_store *store, uint16_t a, uint16_t b)
+{
+	time_t ta = store->next[a];
+	time_t tb = store->next[b];
+
+	if (ta == SCHEDULE_NEVER)
+		return false;
+	return tb == SCHEDULE_NEVER || ta < tb;
+}
+
+static void BENCH_HOT heap_swap(schedule_store *store, unsigned int i, unsigned int j)
+{
+	uint16_t slot = store->heap[i];
+
+	store->heap[i] = store->heap[j];
+	store->heap[j] = slot;
+	store->pos[store->heap[i]] = i;
+	store->pos[store->heap[j]] = j;
+}
+
+static void sift_up(schedule_store *store, unsigned int i)
+{
+	while (i > 0)
+	{
+		unsigned int parent = (i - 1) / 2;
+
+		if (!fires_before(store, store->heap[i], store->heap[parent]))
+			break;
+		heap_swap(store, i, parent);
+		i = parent;
+	}
+}
+
+static void BENCH_HOT sift_down(schedule_store *store, unsigned int i)
+{
+	while (1)
+	{
+		unsigned int child = 2 * i + 1;
+		unsigned int first = i;
+
+		if (child < store->count && fires_before(store, store->heap[child], store->heap[first]))
+			first = child;
+		if (child + 1 < store->count && fires_before(store, store->heap[child + 1], store->heap[first]))
+			first = child + 1;
+		if (first == i)
+			break;
+		heap_swap(store, i, first);
+		i = first;
+	}
+}
+
+void schedule_init(schedule_store *store)
+{
+	memset(store, 0, sizeof(*store));
+
+	// slot 0 is at the top of the stack so it is used first
+	for (unsigned int i = 0; i < SCHEDULE_MAX_EVENTS; i++)
+		store->free[i] = SCHEDULE_MAX_EVENTS - 1 - i;
+}
+
+int schedule_add(schedule_store *store, const water_event *event, time_t now)
+{
+	uint16_t slot;
+
+	if (store->count == SCHEDULE_MAX_EVENTS)
+		return -1;
+
+	slot = store->free[SCHEDULE_MAX_EVENTS - store->count - 1];
+	store->events[slot] = *event;
+	store->events[slot].enabled = true;
+	store->next[slot] = schedule_event_next(&store->events[slot], now);
+	store->heap[store->count] = slot;
+	store->pos[slot] = store->count;
+	store->count++;
+	sift_up(store, store->count - 1);
+	return slot;
+}
+
+bool schedule_del(schedule_store *store, unsigned int slot)
+{
+	unsigned int i;
+
+	if (slot >= SCHEDULE_MAX_EVENTS || !store->events[slot].enabled)
+		return false;
+
+	// move the last event into the hole and put it in its place
+	i = store->pos[slot];
+	store->count--;
+	if (i != store->count)
+	{
+		heap_swap(store, i, store->count);
+		sift_up(store, i);
+		sift_down(store, store->pos[store->heap[i]]);
+	}
+
+	store->events[slot].enabled = false;
+	store->free[SCHEDULE_MAX_EVENTS - store->count - 1] = slot;
+	return true;
+}
+
+const water_event *schedule_get(const schedule_store *store, unsigned int slot)
+{
+	if (slot >= SCHEDULE_MAX_EVENTS || !store->events[slot].enabled)
+		return NULL;
+	return &store->events[slot];
+}
+
+time_t BENCH_HOT schedule_peek(const schedule_store *store, unsigned int *slot)
+{
+	if (store->count == 0)
+		return SCHEDULE_NEVER;
+	if (slot)
+		*slot = store->heap[0];
+	return store->next[store->heap[0]];
+}
+
+void BENCH_HOT schedule_fired(schedule_store *store)
+{
+	uint16_t slot;
+
+	if (store->count == 0)
+		return;
+	slot = store->heap[0];
+	store->next[slot] = schedule_event_next(&store->events[slot], store->next[slot]);
+	sift_down(store, 0);
+}
+
+void schedule_rebuild(schedule_store *store, time_t now)
+{
+	for (unsigned int i = 0; i < store->count; i++)
+	{
+		uint16_t slot = store->heap[i];
+		store->next[slot] = schedule_event_next(&store->events[slot], now);
+	}
+
+	for (unsigned int i = store->count / 2; i > 0; i--)
+		sift_down(store, i - 1);
+}
+
+size_t schedule_pack(const schedule_store *store, uint8_t *blob, size_t size)
+{
+	uint8_t *rec = blob + SCHEDULE_BLOB_HEADER;
+	unsigned int saved = 0;
+	uint16_t crc;
+
+	if (size < SCHEDULE_BLOB_HEADER)
+		return 0;
+
+	// in slot order, so an unchanged schedule gives the same blob
+	for (unsigned int slot = 0; slot < SCHEDULE_MAX_EVENTS; slot++)
+	{
+		const water_event *event = &store->events[slot];
+
+		if (!event->enabled)
+			continue;
+		if (SCHEDULE_BLOB_SIZE(saved + 1) > size)
+			return 0;
+
+		rec[0] = event->hour;
+		rec[1] = event->minute;
+		rec[2] = event->skip;
+		rec[3] = event->days;
+		rec[4] = event->duration;
+		rec[5] = event->duration >> 8;
+		rec[6] = event->duration >> 16;
+		rec[7] = event->zone;
+		rec += SCHEDULE_BLOB_RECORD;
+		saved++;
+	}
+
+	blob[0] = SCHEDULE_BLOB_VERSION;
+	blob[1] = 0;
+	blob[2] = saved;
+	blob[3] = saved >> 8;
+	crc = blob_crc(blob, SCHEDULE_BLOB_SIZE(saved));
+	blob[4] = crc;
+	blob[5] = crc >> 8;
+
+	// the rest of a fixed size buffer doesn't change the blob
+	memset(rec, 0, size - SCHEDULE_BLOB_SIZE(saved));
+	return SCHEDULE_BLOB_SIZE(saved);
+}
+
+int schedule_unpack(schedule_store *store, const uint8_t *blob, size_t size, time_t now)
+{
+	const uint8_t *rec = blob + SCHEDULE_BLOB_HEADER;
+	unsigned int saved;
+	size_t record;
+	size_t length;
+
+	if (size < SCHEDULE_BLOB_HEADER)
+		return -1;
+
+	// version 1 has no zone - all its events are for the first zone
+	if (blob[0] == SCHEDULE_BLOB_VERSION)
+		record = SCHEDULE_BLOB_RECORD;
+	else if (blob[0] == 1)
+		record = SCHEDULE_BLOB_RECORD_V1;
+	else
+		return -1;
+
+	saved = blob[2] | blob[3] << 8;
+	length = SCHEDULE_BLOB_HEADER + saved * record;
+	if (saved > SCHEDULE_MAX_EVENTS || length > size)
+		return -1;
+	if (blob_crc(blob, length) != (blob[4] | blob[5] << 8))
+		return -1;
+
+	schedule_init(store);
+	for (unsigned int evt = 0; evt < saved; evt++)
+	{
+		water_event event;
+
+		event.enabled = true;
+		event.hour = rec[0];
+		event.minute = rec[1];
+		event.skip = rec[2];
+		event.days = rec[3];
+		event.duration = rec[4] | rec[5] << 8 | (uint32_t)rec[6] << 16;
+		event.zone = record > SCHEDULE_BLOB_RECORD_V1 ? rec[7] : 0;
+		schedule_add(store, &event, now);
+		rec += record;
+	}
+
+	return saved;
+}
@@ -0,0 +1,111 @@
+#ifndef _SCHEDULE_H
+#define _SCHEDULE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "sdkconfig.h"
+
+#define SCHEDULE_MAX_EVENTS CONFIG_WATER_MAX_EVENTS
+
+// returned when an event (or the whole schedule) will never fire
+#define SCHEDULE_NEVER ((time_t)-1)
+
+// There are 3 kinds of events:
+// skip > 0: every 'skip' seconds
+// skip = 0, days = 0: special case meaning 'every day'
+// skip = 0, days != 0: on the specified days of the week
+typedef struct water_event
+{
+	bool enabled;			// is the event valid
+	uint8_t hour;			// starting hour
+	uint8_t minute;		// starting minute
+	uint8_t skip;			// how many seconds to skip before recurrance (0 = read 'days')
+	uint8_t days;			// bitmap of specific days to execute on
+	uint8_t zone;			// which valve to open
+	uint32_t duration;	// how many seconds before turning off
+} water_event;
+
+/*
+	The schedule is saved as one blob:
+		version (1), reserved (1), count (2), crc16 (2), records
+	Each record is hour, minute, skip, days, a 3 byte duration and (from
+	version 2) the zone. All values are little endian, and the CRC covers
+	everything except itself. Only enabled events are saved. Add a new
+	version rather than change the layout of a record.
+*/
+#define SCHEDULE_BLOB_VERSION 2
+#define SCHEDULE_BLOB_HEADER 6
+#define SCHEDULE_BLOB_RECORD 8
+#define SCHEDULE_BLOB_RECORD_V1 7
+#define SCHEDULE_BLOB_SIZE(events) (SCHEDULE_BLOB_HEADER + (events) * SCHEDULE_BLOB_RECORD)
+
+// the raw struct that firmware up to v1.12 saves in the "evtNN" keys
+typedef struct legacy_event
+{
+	bool enabled;
+	uint8_t hour;
+	uint8_t minute;
+	uint8_t skip;
+	uint8_t days;
+	uint32_t duration;
+} legacy_event;
+
+/*
+	These functions don't read the clock - the caller passes in 'now', so the
+	same code runs on the device and on a host with a fake clock. Local time
+	is calculated with the current TZ setting.
+*/
+
+// the first time strictly after 'now' that the event fires
+time_t schedule_event_next(const water_event *event, time_t now);
+
+// the first time strictly after 'now' that any of the events fires
+time_t schedule_next(const water_event *events, unsigned int count, time_t now);
+
+/*
+	The events, indexed by a slot number that doesn't change while the
+	event exists, and a binary min-heap of the slots ordered by the next
+	time each event fires. Adding or deleting an event and starting the
+	next one are O(log n); finding the next event is O(1).
+
+	Memory per event is sizeof(water_event) + sizeof(time_t) + 3 * 2
+	bytes: 22 bytes on the ESP8266 (4 byte time_t) and 26 on a 64 bit
+	host. host/bench/schedule_bench.c prints the numbers for a build.
+*/
+typedef struct schedule_store
+{
+	water_event events[SCHEDULE_MAX_EVENTS];	// by slot, 'enabled' marks the used ones
+	time_t next[SCHEDULE_MAX_EVENTS];			// by slot, the next time the event fires
+	uint16_t heap[SCHEDULE_MAX_EVENTS];			// slots of the events, soonest first
+	uint16_t pos[SCHEDULE_MAX_EVENTS];			// by slot, the index in 'heap'
+	uint16_t free[SCHEDULE_MAX_EVENTS];			// stack of unused slots
+	uint16_t count;									// number of events
+} schedule_store;
+
+void schedule_init(schedule_store *store);
+
+// returns the slot of the new event, or -1 if the store is full
+int schedule_add(schedule_store *store, const water_event *event, time_t now);
+bool schedule_del(schedule_store *store, unsigned int slot);
+
+// the event in a slot, NULL if the slot isn't used
+const water_event *schedule_get(const schedule_store *store, unsigned int slot);
+
+// when the first event fires and its slot - SCHEDULE_NEVER if there are no events
+time_t schedule_peek(const schedule_store *store, unsigned int *slot);
+
+// the first event has fired, move on to its next time
+void schedule_fired(schedule_store *store);
+
+// the clock or the timezone has changed - work out all the times again
+void schedule_rebuild(schedule_store *store, time_t now);
+
+// returns the size of the blob, or 0 if it doesn't fit in 'size' bytes
+size_t schedule_pack(const schedule_store *store, uint8_t *blob, size_t size);
+
+// replaces the events of the store - returns the number read, or -1 if the blob isn't valid
+int schedule_unpack(schedule_store *store, const uint8_t *blob, size_t size, time_t now);
+
+#endif // _SCHEDULE_H
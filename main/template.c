@@ -0,0 +1,43 @@
+#include <stdint.h>
+#include "template.h"
+
+static void write_uint(resp_writer *w, unsigned int value)
+{
+	char buf[10];
+	char *p = buf + sizeof(buf);
+
+	do
+	{
+		*--p = '0' + value % 10;
+		value /= 10;
+	} while (value);
+	writer_write(w, p, buf + sizeof(buf) - p);
+}
+
+void template_write(resp_writer *w, const template_page *page, const void *args)
+{
+	const uint8_t *base = args;
+
+	for (unsigned int i = 0; i < page->count; i++)
+	{
+		const template_segment *s = &page->segments[i];
+		const void *field = base + s->offset;
+
+		writer_write(w, s->text, s->len);
+		switch (s->slot)
+		{
+		case SLOT_HTML:
+			writer_escape(w, *(const char *const *)field, SIZE_MAX, WRITER_HTML);
+			break;
+		case SLOT_ATTR:
+			writer_escape(w, *(const char *const *)field, SIZE_MAX, WRITER_ATTR);
+			break;
+		case SLOT_UINT:
+			write_uint(w, *(const unsigned int *)field);
+			break;
+		case SLOT_CALL:
+			(*(const template_fn *)field)(w);
+			break;
+		}
+	}
+}
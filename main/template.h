@@ -0,0 +1,49 @@
+#ifndef _TEMPLATE_H
+#define _TEMPLATE_H
+
+#include <stdint.h>
+#include "writer.h"
+
+/*
+	A page made from a template in main/templates by tools/mktemplates.py
+	(template_data.h). The fixed text is split into segments when the
+	firmware is built; each segment is followed by a slot that is filled
+	from a field of the page's argument struct when it is sent:
+		{{name:html}}	a string, escaped as element text
+		{{name:attr}}	a string, escaped as a quoted attribute value
+		{{name:uint}}	an unsigned int in decimal
+		{{name:call}}	a template_fn that writes that part itself
+*/
+typedef enum template_slot
+{
+	SLOT_NONE,			// the last segment
+	SLOT_HTML,
+	SLOT_ATTR,
+	SLOT_UINT,
+	SLOT_CALL,
+} template_slot;
+
+typedef struct template_segment
+{
+	const char *text;
+	uint16_t len;
+	uint8_t slot;				// template_slot after the text
+	uint8_t offset;			// of the slot's field in the argument struct
+} template_segment;
+
+typedef struct template_page
+{
+	const template_segment *segments;
+	unsigned int count;
+	const char *hash;			// of the template file, for ETags
+} template_page;
+
+typedef void (*template_fn)(resp_writer *w);
+
+/*
+	Sends the page with 'args' in its slots. Use the typed page_<name>()
+	in template_data.h rather than this.
+*/
+void template_write(resp_writer *w, const template_page *page, const void *args);
+
+#endif // _TEMPLATE_H
@@ -0,0 +1,210 @@
+// Generated by tools/mktemplates.py from main/templates - do not edit
+#include <stddef.h>
+#include "template_data.h"
+
+// form_add_event.html: 841 bytes of text, 2 slots
+static const template_segment page_form_add_event_segments[] =
+{
+	{
+		"<html><title>Watering System</title>\n"
+		"<body>\n"
+		"<h1>Add Event</h1>\n"
+		"<form action=\"/\" method=\"PUT\">\n"
+		"<br><input type=\"hidden\" name=\"action\" value=\"add_event\">\n"
+		"<table><tr><td>Zone<td><select name=\"zone\">",
+		195, SLOT_CALL, offsetof(page_form_add_event_args, zones)
+	},
+	{
+		"</select></tr>\n"
+		"<tr><td>Turn on at<td><input type=\"time\" name=\"time\"></tr>\n"
+		"<tr><td>On these days<td><input type=\"checkbox\" name=\"d0\">Sunday</tr>\n"
+		"<tr><td><td><input type=\"checkbox\" name=\"d1\">Monday</tr>\n"
+		"<tr><td><td><input type=\"checkbox\" name=\"d2\">Tuesday</tr>\n"
+		"<tr><td><td><input type=\"checkbox\" name=\"d3\">Wednesday</tr>\n"
+		"<tr><td><td><input type=\"checkbox\" name=\"d4\">Thursday</tr>\n"
+		"<tr><td><td><input type=\"checkbox\" name=\"d5\">Friday</tr>\n"
+		"<tr><td><td><input type=\"checkbox\" name=\"d6\">Saturday</tr>\n"
+		"<tr><td>For<td><input type=\"number\" name=\"duration\" maxlength=5 min=1 max=",
+		568, SLOT_UINT, offsetof(page_form_add_event_args, max_duration)
+	},
+	{
+		"> seconds</tr></table>\n"
+		"<input type=\"submit\" value=\"Add\">\n"
+		"</form></body></html>",
+		78, SLOT_NONE, 0
+	},
+};
+_Static_assert(sizeof(page_form_add_event_args) <= UINT8_MAX, "slot offsets are 8 bits");
+
+const template_page page_form_add_event_template =
+{
+	.segments = page_form_add_event_segments,
+	.count = sizeof(page_form_add_event_segments) / sizeof(page_form_add_event_segments[0]),
+	.hash = "d6daf00d56672c36",
+};
+
+// form_hostname.html: 289 bytes of text, 2 slots
+static const template_segment page_form_hostname_segments[] =
+{
+	{
+		"<html><title>Watering System</title>\n"
+		"<body>\n"
+		"<h1>Set Hostname</h1>\n"
+		"<form action=\"/\" method=\"PUT\">\n"
+		"<br><input type=\"hidden\" name=\"action\" value=\"set_hostname\">\n"
+		"New host name: <input type=\"text\" name=\"host\" value=\"",
+		211, SLOT_ATTR, offsetof(page_form_hostname_args, hostname)
+	},
+	{
+		"\" maxwidth=",
+		11, SLOT_UINT, offsetof(page_form_hostname_args, max_hostname)
+	},
+	{
+		"><br><br><input type=\"submit\" value=\"Update\">\n"
+		"</form></body></html>",
+		67, SLOT_NONE, 0
+	},
+};
+_Static_assert(sizeof(page_form_hostname_args) <= UINT8_MAX, "slot offsets are 8 bits");
+
+const template_page page_form_hostname_template =
+{
+	.segments = page_form_hostname_segments,
+	.count = sizeof(page_form_hostname_segments) / sizeof(page_form_hostname_segments[0]),
+	.hash = "9dce3652fbf34f89",
+};
+
+// form_set_ntp.html: 257 bytes of text, 1 slots
+static const template_segment page_form_set_ntp_segments[] =
+{
+	{
+		"<html><title>Watering System</title>\n"
+		"<body>\n"
+		"<h1>Set NTP Server</h1>\n"
+		"<form action=\"/\" method=\"PUT\">\n"
+		"<br><input type=\"hidden\" name=\"action\" value=\"set_ntp\">\n"
+		"<input type=\"text\" name=\"server\" value=\"",
+		195, SLOT_ATTR, offsetof(page_form_set_ntp_args, server)
+	},
+	{
+		"\"><br>\n"
+		"<input type=\"submit\" value=\"Set\">\n"
+		"</form></body></html>",
+		62, SLOT_NONE, 0
+	},
+};
+_Static_assert(sizeof(page_form_set_ntp_args) <= UINT8_MAX, "slot offsets are 8 bits");
+
+const template_page page_form_set_ntp_template =
+{
+	.segments = page_form_set_ntp_segments,
+	.count = sizeof(page_form_set_ntp_segments) / sizeof(page_form_set_ntp_segments[0]),
+	.hash = "6dd41bbd5d67b619",
+};
+
+// form_set_upgrade.html: 282 bytes of text, 2 slots
+static const template_segment page_form_set_upgrade_segments[] =
+{
+	{
+		"<html><title>Watering System</title>\n"
+		"<body>\n"
+		"<h1>Set Upgrade URL</h1>\n"
+		"<form action=\"/\" method=\"PUT\">\n"
+		"<br><input type=\"hidden\" name=\"action\" value=\"set_upgrade\">\n"
+		"URL <input type=\"text\" name=\"url\" value=\"",
+		201, SLOT_ATTR, offsetof(page_form_set_upgrade_args, url)
+	},
+	{
+		"\" size=64 maxlength=",
+		20, SLOT_UINT, offsetof(page_form_set_upgrade_args, max_length)
+	},
+	{
+		"><br>\n"
+		"<input type=\"submit\" value=\"Set\">\n"
+		"</form></body></html>",
+		61, SLOT_NONE, 0
+	},
+};
+_Static_assert(sizeof(page_form_set_upgrade_args) <= UINT8_MAX, "slot offsets are 8 bits");
+
+const template_page page_form_set_upgrade_template =
+{
+	.segments = page_form_set_upgrade_segments,
+	.count = sizeof(page_form_set_upgrade_segments) / sizeof(page_form_set_upgrade_segments[0]),
+	.hash = "0498e73d56543588",
+};
+
+// form_set_wifi.html: 366 bytes of text, 2 slots
+static const template_segment page_form_set_wifi_segments[] =
+{
+	{
+		"<html><title>Watering System</title>\n"
+		"<body>\n"
+		"<h1>Set Wifi Access Point</h1>\n"
+		"<form action=\"/\" method=\"PUT\">\n"
+		"<input type=\"hidden\" name=\"action\" value=\"set_wifi\">\n"
+		"<table><tr><td>SSID<td><input type=\"text\" name=\"ssid\" value=\"",
+		220, SLOT_ATTR, offsetof(page_form_set_wifi_args, ssid)
+	},
+	{
+		"\"></tr>\n"
+		"<tr><td>Password<td><input type=\"password\" name=\"password\" value=\"",
+		74, SLOT_ATTR, offsetof(page_form_set_wifi_args, password)
+	},
+	{
+		"\"></tr>\n"
+		"</table>\n"
+		"<input type=\"submit\" value=\"Set\">\n"
+		"</form></body></html>",
+		72, SLOT_NONE, 0
+	},
+};
+_Static_assert(sizeof(page_form_set_wifi_args) <= UINT8_MAX, "slot offsets are 8 bits");
+
+const template_page page_form_set_wifi_template =
+{
+	.segments = page_form_set_wifi_segments,
+	.count = sizeof(page_form_set_wifi_segments) / sizeof(page_form_set_wifi_segments[0]),
+	.hash = "4f24868bea1b51fd",
+};
+
+// help.html: 1018 bytes of text, 3 slots
+static const template_segment page_help_segments[] =
+{
+	{
+		"<html><title>Watering System - Help</title>\n"
+		"<body>\n"
+		"<h1>Joel's Watering System v",
+		79, SLOT_UINT, offsetof(page_help_args, major)
+	},
+	{
+		".",
+		1, SLOT_UINT, offsetof(page_help_args, minor)
+	},
+	{
+		"</h1>\n"
+		"<h2>Command Help</h2><table><tr><td>Action<td>Parameters<td>Description<td>Example</tr>\n"
+		"<tr><td>water_on<td>zone=[n]<td>Turn water on now<td>http://192.168.1.1/?action=water_on&zone=0</tr>\n"
+		"<tr><td>water_off<td>zone=[n]<td>Turn water off now (all zones without a zone)<td>http://192.168.1.1/?action=water_off</tr>\n"
+		"<tr><td>add_event<td>zone=[n], time=[hh:mm], d0..d6=[on|off], duration=[secs]<td>Schedule a new watering event<td>http://192.168.1.1/?action=add_event&time=14%0e30&d1=on&d3=on&duration=60</tr>\n"
+		"<tr><td><td>time=[hh:mm], skip=[secs], duration=[secs]<td>Schedule a new watering event, repeating every N seconds<td>http://192.168.1.1/?action=add_event&time=14%0e30&skip=3600&duration=15</tr>\n"
+		"<tr><td>del_event<td>index=&lt;event&gt;<td>Delete an existing event<td></tr>\n"
+		"<tr><td>set_hostname<td>host=&lt;name&gt;<td>Set a new hostname (max ",
+		854, SLOT_UINT, offsetof(page_help_args, max_hostname)
+	},
+	{
+		" chars)<td></tr>\n"
+		"</table><br><br>\n"
+		"<a href=\"/\">Return to main page</a>\n"
+		"</body></html>",
+		84, SLOT_NONE, 0
+	},
+};
+_Static_assert(sizeof(page_help_args) <= UINT8_MAX, "slot offsets are 8 bits");
+
+const template_page page_help_template =
+{
+	.segments = page_help_segments,
+	.count = sizeof(page_help_segments) / sizeof(page_help_segments[0]),
+	.hash = "aab1cfdc00081a3c",
+};
@@ -0,0 +1,85 @@
+// Generated by tools/mktemplates.py from main/templates - do not edit
+#ifndef _TEMPLATE_DATA_H
+#define _TEMPLATE_DATA_H
+
+#include "template.h"
+
+typedef struct page_form_add_event_args
+{
+	template_fn zones;
+	unsigned int max_duration;
+} page_form_add_event_args;
+
+extern const template_page page_form_add_event_template;
+
+static inline void page_form_add_event(resp_writer *w, const page_form_add_event_args *args)
+{
+	template_write(w, &page_form_add_event_template, args);
+}
+
+typedef struct page_form_hostname_args
+{
+	const char *hostname;
+	unsigned int max_hostname;
+} page_form_hostname_args;
+
+extern const template_page page_form_hostname_template;
+
+static inline void page_form_hostname(resp_writer *w, const page_form_hostname_args *args)
+{
+	template_write(w, &page_form_hostname_template, args);
+}
+
+typedef struct page_form_set_ntp_args
+{
+	const char *server;
+} page_form_set_ntp_args;
+
+extern const template_page page_form_set_ntp_template;
+
+static inline void page_form_set_ntp(resp_writer *w, const page_form_set_ntp_args *args)
+{
+	template_write(w, &page_form_set_ntp_template, args);
+}
+
+typedef struct page_form_set_upgrade_args
+{
+	const char *url;
+	unsigned int max_length;
+} page_form_set_upgrade_args;
+
+extern const template_page page_form_set_upgrade_template;
+
+static inline void page_form_set_upgrade(resp_writer *w, const page_form_set_upgrade_args *args)
+{
+	template_write(w, &page_form_set_upgrade_template, args);
+}
+
+typedef struct page_form_set_wifi_args
+{
+	const char *ssid;
+	const char *password;
+} page_form_set_wifi_args;
+
+extern const template_page page_form_set_wifi_template;
+
+static inline void page_form_set_wifi(resp_writer *w, const page_form_set_wifi_args *args)
+{
+	template_write(w, &page_form_set_wifi_template, args);
+}
+
+typedef struct page_help_args
+{
+	unsigned int major;
+	unsigned int minor;
+	unsigned int max_hostname;
+} page_help_args;
+
+extern const template_page page_help_template;
+
+static inline void page_help(resp_writer *w, const page_help_args *args)
+{
+	template_write(w, &page_help_template, args);
+}
+
+#endif // _TEMPLATE_DATA_H
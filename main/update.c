@@ -0,0 +1,317 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_http_client.h"
+#include "sdkconfig.h"
+#include "config.h"
+#include "json.h"
+#include "update.h"
+
+#define UPDATE_PERIOD (CONFIG_WATER_UPDATE_CHECK * 3600)	// seconds between checks on average
+#define UPDATE_TIMEOUT 10000		// ms
+#define UPDATE_STACK_SIZE 3072
+#define UPDATE_ETAG_SIZE 64
+
+static const char *TAG="UPDATE";
+static const char *image_key;		// config key of the upgrade URL
+static unsigned int running_major;
+static unsigned int running_minor;
+static update_start_fn start_update;
+static esp_timer_handle_t check_timer;
+static SemaphoreHandle_t lock;		// protects the status, 'checking' and the versions
+static update_status status;
+static bool checking;
+static char offered[UPDATE_VERSION_SIZE];			// of the last update started
+static char delta_refused[UPDATE_VERSION_SIZE];	// a delta of this version failed, get the whole image
+
+// only used by the check task
+static char etag[UPDATE_ETAG_SIZE];		// of a manifest that had nothing newer
+static char new_etag[UPDATE_ETAG_SIZE];	// of the one being read
+
+/*
+	A random time within the period: the first check can come any time
+	after boot, and each one after it between half a period and one and a
+	half periods after the last
+*/
+static void schedule_check(bool first)
+{
+#if CONFIG_WATER_UPDATE_CHECK
+	uint32_t delay = esp_random() % UPDATE_PERIOD + (first ? 0 : UPDATE_PERIOD / 2);
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	status.next_check = esp_timer_get_time() + (int64_t)delay * 1000000;
+	xSemaphoreGive(lock);
+	esp_timer_start_once(check_timer, (uint64_t)delay * 1000000);
+	ESP_LOGI(TAG, "Next check in %u s", delay);
+#endif
+}
+
+static esp_err_t manifest_event(esp_http_client_event_t *evt)
+{
+	if (evt->event_id == HTTP_EVENT_ON_HEADER && strcasecmp(evt->header_key, "ETag") == 0
+		&& strlen(evt->header_value) < sizeof(new_etag))
+		strcpy(new_etag, evt->header_value);
+	return ESP_OK;
+}
+
+// the image's URL with .json in place of the extension of its name
+static void manifest_url(char *url, size_t size, const char *image_url)
+{
+	const char *name = strrchr(image_url, '/');
+	const char *ext = strrchr(image_url, '.');
+	int len = ext && name && ext > name ? ext - image_url : (int)strlen(image_url);
+
+	snprintf(url, size, "%.*s.json", len, image_url);
+}
+
+/*
+	'ref' is a whole URL, a path on the server of the manifest, or a name
+	in the same directory as it
+*/
+static bool resolve_url(char *url, size_t size, const char *manifest, const char *ref)
+{
+	const char *host = strstr(manifest, "://");
+	int len;
+
+	if (strstr(ref, "://"))
+		len = 0;
+	else if (ref[0] == '/')
+		len = host ? strcspn(host + 3, "/") + (host + 3 - manifest) : 0;
+	else
+		len = strrchr(manifest, '/') ? strrchr(manifest, '/') + 1 - manifest : 0;
+
+	return snprintf(url, size, "%.*s%s", len, manifest, ref) < (int)size;
+}
+
+// "major.minor" newer than what is running?
+static bool is_newer(const char *version)
+{
+	char *end;
+	unsigned long major = strtoul(version, &end, 10);
+	unsigned long minor = *end == '.' ? strtoul(end + 1, NULL, 10) : 0;
+
+	return major > running_major || (major == running_major && minor > running_minor);
+}
+
+// read the whole body, which has to fit in 'buf' with a terminator
+static esp_err_t read_body(esp_http_client_handle_t client, char *buf, int size)
+{
+	int len = 0;
+	int n = 0;
+
+	while (len < size - 1 && (n = esp_http_client_read(client, buf + len, size - 1 - len)) > 0)
+		len += n;
+	if (n < 0)
+	{
+		ESP_LOGE(TAG, "Error reading the manifest");
+		return ESP_FAIL;
+	}
+	if (len == size - 1)
+	{
+		ESP_LOGE(TAG, "Manifest is too long");
+		return ESP_ERR_INVALID_SIZE;
+	}
+	buf[len] = 0;
+	return ESP_OK;
+}
+
+/*
+	The manifest says what to do. It is only remembered as seen when
+	there was nothing to do, so an update that fails is tried again.
+*/
+static esp_err_t apply_manifest(const char *url, char *body)
+{
+	char image[UPDATE_URL_SIZE];
+	char key[24];
+	query_index q;
+	const char *version;
+	const char *ref;
+	bool skip_delta;
+
+	if (json_parse_flat(body, &q) < 0 || !(version = query_get(&q, "version")) || !query_get(&q, "url")
+		|| !version[0] || version[strspn(version, "0123456789.")])
+	{
+		ESP_LOGE(TAG, "Bad manifest");
+		return ESP_ERR_INVALID_RESPONSE;
+	}
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	snprintf(status.latest, sizeof(status.latest), "%s", version);
+	xSemaphoreGive(lock);
+
+	if (!is_newer(version))
+	{
+		ESP_LOGI(TAG, "Up to date - the latest version is %s", version);
+		strcpy(etag, new_etag);
+		return ESP_OK;
+	}
+
+	// a new version gets a new delta, which may well be fine
+	xSemaphoreTake(lock, portMAX_DELAY);
+	if (delta_refused[0] && strcmp(delta_refused, version) != 0)
+		delta_refused[0] = '\0';
+	skip_delta = delta_refused[0] != '\0';
+	xSemaphoreGive(lock);
+
+	snprintf(key, sizeof(key), "delta_%u.%u", running_major, running_minor);
+	ref = query_get(&q, key);
+	if (!ref || skip_delta)
+		ref = query_get(&q, "url");
+	if (!resolve_url(image, sizeof(image), url, ref))
+		return ESP_ERR_INVALID_SIZE;
+
+	ESP_LOGI(TAG, "Version %s is out at %s", version, image);
+	xSemaphoreTake(lock, portMAX_DELAY);
+	snprintf(offered, sizeof(offered), "%s", version);
+	xSemaphoreGive(lock);
+	return start_update(image, query_get(&q, "sha256"));
+}
+
+static esp_err_t check(void)
+{
+	char image_url[UPDATE_URL_SIZE];
+	char url[UPDATE_URL_SIZE];
+	esp_http_client_config_t config =
+	{
+		.url = url,
+		.timeout_ms = UPDATE_TIMEOUT,
+		.event_handler = manifest_event,
+	};
+	esp_http_client_handle_t client;
+	esp_err_t err = ESP_FAIL;
+	char *body;
+	int code;
+
+	// a copy, as the setting can change while the check runs
+	if (config_get_str(image_key, image_url, sizeof(image_url)) != ESP_OK)
+		return ESP_ERR_INVALID_SIZE;
+	manifest_url(url, sizeof(url), image_url);
+	body = malloc(UPDATE_MANIFEST_SIZE);
+	client = esp_http_client_init(&config);
+	if (!body || !client)
+	{
+		if (client)
+			esp_http_client_cleanup(client);
+		free(body);
+		return ESP_ERR_NO_MEM;
+	}
+
+	new_etag[0] = 0;
+	if (etag[0])
+		esp_http_client_set_header(client, "If-None-Match", etag);
+	if (esp_http_client_open(client, 0) != ESP_OK || esp_http_client_fetch_headers(client) < 0)
+	{
+		ESP_LOGE(TAG, "Can't fetch %s", url);
+		code = 0;
+	}
+	else
+		code = esp_http_client_get_status_code(client);
+
+	if (code == 304)
+	{
+		ESP_LOGI(TAG, "Manifest hasn't changed");
+		err = ESP_OK;
+	}
+	else if (code == 404)
+	{
+		ESP_LOGI(TAG, "No manifest at %s", url);
+		err = ESP_ERR_NOT_FOUND;
+	}
+	else if (code == 200)
+	{
+		err = read_body(client, body, UPDATE_MANIFEST_SIZE);
+		if (err == ESP_OK)
+			err = apply_manifest(url, body);
+	}
+	else if (code)
+		ESP_LOGE(TAG, "Bad response for the manifest (%d)", code);
+
+	esp_http_client_cleanup(client);
+	free(body);
+	return err;
+}
+
+static void check_task(void *arg)
+{
+	esp_err_t err = check();
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	status.checks++;
+	status.last_check = esp_timer_get_time();
+	status.err = err;
+	checking = false;
+	xSemaphoreGive(lock);
+	vTaskDelete(NULL);
+}
+
+esp_err_t update_check(void)
+{
+	xSemaphoreTake(lock, portMAX_DELAY);
+	if (checking)
+	{
+		xSemaphoreGive(lock);
+		return ESP_ERR_INVALID_STATE;
+	}
+	checking = true;
+	xSemaphoreGive(lock);
+
+	if (xTaskCreate(check_task, "update", UPDATE_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL) != pdPASS)
+	{
+		xSemaphoreTake(lock, portMAX_DELAY);
+		checking = false;
+		xSemaphoreGive(lock);
+		return ESP_ERR_NO_MEM;
+	}
+	return ESP_OK;
+}
+
+static void check_callback(void *arg)
+{
+	if (update_check() != ESP_OK)
+		ESP_LOGW(TAG, "Can't check for an update now");
+	schedule_check(false);
+}
+
+void update_done(esp_err_t err)
+{
+	// a delta for another build of the same version
+	if (err == ESP_ERR_INVALID_VERSION)
+	{
+		ESP_LOGW(TAG, "Delta refused - the next update gets the whole image");
+		xSemaphoreTake(lock, portMAX_DELAY);
+		strcpy(delta_refused, offered);
+		xSemaphoreGive(lock);
+	}
+}
+
+void update_get_status(update_status *out)
+{
+	xSemaphoreTake(lock, portMAX_DELAY);
+	*out = status;
+	xSemaphoreGive(lock);
+}
+
+void update_init(const char *url_key, unsigned int major, unsigned int minor, update_start_fn start)
+{
+	const esp_timer_create_args_t check_timer_args = {
+		.callback = check_callback,
+		.dispatch_method = ESP_TIMER_TASK,
+		.name = "update"
+	};
+
+	image_key = url_key;
+	running_major = major;
+	running_minor = minor;
+	start_update = start;
+	lock = xSemaphoreCreateMutex();
+	esp_timer_create(&check_timer_args, &check_timer);
+	schedule_check(true);
+}
@@ -0,0 +1,56 @@
+#ifndef _UPDATE_H
+#define _UPDATE_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#define UPDATE_URL_SIZE 128
+#define UPDATE_MANIFEST_SIZE 512		// largest manifest that is read
+#define UPDATE_VERSION_SIZE 12
+
+/*
+	Looks for newer firmware every CONFIG_WATER_UPDATE_CHECK hours, at a
+	random point in each period so a fleet of controllers doesn't ask the
+	server at once. The manifest is next to the image, with .json in place
+	of the extension of the upgrade URL, and is a flat JSON object:
+		{"version": "1.13", "url": "water-1.13.bin", "sha256": "...",
+		 "delta_1.12": "water-1.12-1.13.wpt"}
+	URLs may be relative to the manifest. A controller running a version
+	with a "delta_" entry downloads that instead of the image, unless a
+	delta of the same version was refused before. "sha256"
+	is of the image and is optional. tools/mkmanifest.py writes one.
+
+	The manifest is fetched with If-None-Match once it has said there is
+	nothing newer, so an unchanged one costs the server a 304.
+*/
+typedef struct update_status
+{
+	unsigned int checks;					// manifests asked for since boot
+	int64_t last_check;					// esp_timer_get_time() of the last, 0 if none yet
+	int64_t next_check;					// and of the next, 0 if checks are off
+	esp_err_t err;							// of the last check
+	char latest[UPDATE_VERSION_SIZE];	// version in the manifest, "" if not seen yet
+} update_status;
+
+/*
+	Starts the download of a newer version - see ota_start(). It may
+	refuse, and the next check offers it again.
+*/
+typedef esp_err_t (*update_start_fn)(const char *url, const char *sha256);
+
+/*
+	'url_key' is the config key of the upgrade URL, which is read at each
+	check so it can change. 'major' and 'minor' are the version that is
+	running.
+*/
+void update_init(const char *url_key, unsigned int major, unsigned int minor, update_start_fn start);
+
+// check now rather than wait for the timer - ESP_ERR_INVALID_STATE if a check is running
+esp_err_t update_check(void);
+
+// the download update_start_fn started has finished
+void update_done(esp_err_t err);
+
+void update_get_status(update_status *status);
+
+#endif // _UPDATE_H
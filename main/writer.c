@@ -0,0 +1,151 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "writer.h"
+
+static const char *TAG="WRITER";
+
+#define ESCAPE_END 0x03			// a terminator stops every mode
+#define ESCAPE_ENTITY(n) ((n) << 2)	// index in entities[]
+#define ENTITY_MAX 6
+
+/*
+	For each byte, the writer_escape_mode bits it is escaped in and which
+	reference it becomes. Every other byte is copied as it is.
+*/
+static const uint8_t escape_table[256] =
+{
+	[0] = ESCAPE_END,
+	['&'] = WRITER_HTML | WRITER_ATTR | ESCAPE_ENTITY(0),
+	['<'] = WRITER_HTML | WRITER_ATTR | ESCAPE_ENTITY(1),
+	['>'] = WRITER_HTML | WRITER_ATTR | ESCAPE_ENTITY(2),
+	['"'] = WRITER_ATTR | ESCAPE_ENTITY(3),
+	['\''] = WRITER_ATTR | ESCAPE_ENTITY(4),
+};
+
+static const struct
+{
+	char text[ENTITY_MAX];
+	uint8_t len;
+} entities[] =
+{
+	{ "&amp;", 5 },
+	{ "&lt;", 4 },
+	{ "&gt;", 4 },
+	{ "&quot;", 6 },
+	{ "&#39;", 5 },
+};
+
+static void writer_flush(resp_writer *w)
+{
+	if (w->len && w->err == ESP_OK)
+		w->err = httpd_resp_send_chunk(w->req, w->buf, w->len);
+	w->len = 0;
+}
+
+void writer_init(resp_writer *w, httpd_req_t *req)
+{
+	w->req = req;
+	w->err = ESP_OK;
+	w->len = 0;
+}
+
+void writer_write(resp_writer *w, const char *data, size_t len)
+{
+	while (len && w->err == ESP_OK)
+	{
+		size_t n = sizeof(w->buf) - w->len;
+		if (n > len)
+			n = len;
+
+		memcpy(w->buf + w->len, data, n);
+		w->len += n;
+		data += n;
+		len -= n;
+
+		if (w->len == sizeof(w->buf))
+			writer_flush(w);
+	}
+}
+
+void writer_puts(resp_writer *w, const char *str)
+{
+	writer_write(w, str, strlen(str));
+}
+
+void writer_escape(resp_writer *w, const char *str, size_t max, writer_escape_mode mode)
+{
+	const uint8_t *s = (const uint8_t *)str;
+
+	while (w->err == ESP_OK)
+	{
+		const uint8_t *run = s;
+		uint8_t c;
+
+		// the bytes that are copied as they are go in one write
+		while (max && !(escape_table[*s] & mode))
+		{
+			s++;
+			max--;
+		}
+		writer_write(w, (const char *)run, s - run);
+		if (!max || !*s)
+			return;
+
+		// straight into the buffer, which is never full after a write
+		c = escape_table[*s++] >> 2;
+		max--;
+		if (sizeof(w->buf) - w->len < ENTITY_MAX)
+			writer_flush(w);
+		memcpy(w->buf + w->len, entities[c].text, entities[c].len);
+		w->len += entities[c].len;
+		if (w->len == sizeof(w->buf))
+			writer_flush(w);
+	}
+}
+
+void writer_printf(resp_writer *w, const char *format, ...)
+{
+	va_list args;
+	int n;
+
+	if (w->err != ESP_OK)
+		return;
+
+	// try to format straight into the buffer
+	va_start(args, format);
+	n = vsnprintf(w->buf + w->len, sizeof(w->buf) - w->len, format, args);
+	va_end(args);
+	if (n < 0)
+		return;
+
+	if ((size_t)n >= sizeof(w->buf) - w->len)
+	{
+		// didn't fit - send what we have and format it again into an empty buffer
+		writer_flush(w);
+		va_start(args, format);
+		n = vsnprintf(w->buf, sizeof(w->buf), format, args);
+		va_end(args);
+		if (n < 0)
+			return;
+		if ((size_t)n >= sizeof(w->buf))
+		{
+			ESP_LOGE(TAG, "Output truncated to %u bytes", (unsigned int)sizeof(w->buf) - 1);
+			n = sizeof(w->buf) - 1;
+		}
+	}
+	w->len += n;
+
+	if (w->len == sizeof(w->buf))
+		writer_flush(w);
+}
+
+esp_err_t writer_finish(resp_writer *w)
+{
+	writer_flush(w);
+	if (w->err == ESP_OK)
+		w->err = httpd_resp_send_chunk(w->req, NULL, 0);
+	return w->err;
+}
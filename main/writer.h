@@ -0,0 +1,52 @@
+#ifndef _WRITER_H
+#define _WRITER_H
+
+#include <stddef.h>
+#include <esp_http_server.h>
+
+#define WRITER_CHUNK_SIZE 512		// bytes buffered before a chunk is sent
+
+/*
+	Builds a response in fixed size blocks and sends each one with
+	httpd_resp_send_chunk() as it fills, so the size of a page is not
+	limited by a buffer. After the first error all writes are ignored and
+	the error is returned by writer_finish().
+*/
+typedef struct resp_writer
+{
+	httpd_req_t *req;
+	esp_err_t err;
+	size_t len;
+	char buf[WRITER_CHUNK_SIZE];
+} resp_writer;
+
+void writer_init(resp_writer *w, httpd_req_t *req);
+void writer_write(resp_writer *w, const char *data, size_t len);
+void writer_puts(resp_writer *w, const char *str);
+
+/*
+	Where an escaped string goes: element text, where & < and > have to
+	be escaped, or a quoted attribute value, where quotes have to be too
+*/
+typedef enum writer_escape_mode
+{
+	WRITER_HTML = 1,
+	WRITER_ATTR = 2,
+} writer_escape_mode;
+
+/*
+	Writes at most 'max' bytes of 'str' with the characters that mean
+	something in HTML replaced by references. It stops early at a
+	terminator, so a fixed size field that is only terminated when it is
+	short (like an SSID) can be written as it is.
+*/
+void writer_escape(resp_writer *w, const char *str, size_t max, writer_escape_mode mode);
+
+// output longer than WRITER_CHUNK_SIZE is truncated
+void writer_printf(resp_writer *w, const char *format, ...)
+	__attribute__((format(printf, 2, 3)));
+
+// send what is left and end the response
+esp_err_t writer_finish(resp_writer *w);
+
+#endif // _WRITER_H
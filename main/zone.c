@@ -0,0 +1,169 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "esp8266/gpio_struct.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "zone.h"
+
+typedef struct zone_def
+{
+	const char *name;
+	gpio_num_t pin;
+} zone_def;
+
+/*
+	Valves on the Wemos D1mini. GPIO16 (D0) isn't in the GPIO output
+	register, and GPIO0, 2 and 15 select the boot mode.
+*/
+static const zone_def zones[] =
+{
+	{ "Zone 1", GPIO_NUM_5 },		// D1
+	{ "Zone 2", GPIO_NUM_4 },		// D2
+	{ "Zone 3", GPIO_NUM_14 },		// D5
+	{ "Zone 4", GPIO_NUM_12 },		// D6
+	{ "Zone 5", GPIO_NUM_13 },		// D7
+};
+
+#define ZONE_COUNT (sizeof(zones)/sizeof(zone_def))
+
+static const char *TAG="ZONE";
+static SemaphoreHandle_t lock;
+static void (*changed_cb)(uint32_t zones);
+static zone_status status[ZONE_COUNT];
+static esp_timer_handle_t off_timer[ZONE_COUNT];
+
+static void off_callback(void *arg)
+{
+	unsigned int zone = (uintptr_t)arg;
+
+	zone_switch(0, ZONE_BIT(zone), ZONE_TIMER);
+}
+
+void zone_init(void (*changed)(uint32_t zones))
+{
+	uint32_t pins = 0;
+
+	changed_cb = changed;
+	lock = xSemaphoreCreateMutex();
+	for (unsigned int zone = 0; zone < ZONE_COUNT; zone++)
+	{
+		const esp_timer_create_args_t off_timer_args = {
+			.callback = off_callback,
+			.arg = (void *)(uintptr_t)zone,
+			.dispatch_method = ESP_TIMER_TASK,
+			.name = zones[zone].name
+		};
+
+		status[zone].event = -1;
+		gpio_set_direction(zones[zone].pin, GPIO_MODE_OUTPUT);
+		esp_timer_create(&off_timer_args, &off_timer[zone]);
+		pins |= 1 << zones[zone].pin;
+	}
+
+	// all the valves start closed
+	GPIO.out_w1tc |= pins;
+}
+
+unsigned int zone_count(void)
+{
+	return ZONE_COUNT;
+}
+
+const char *zone_name(unsigned int zone)
+{
+	if (zone >= ZONE_COUNT)
+		return "";
+	return zones[zone].name;
+}
+
+const char *zone_cause_name(zone_cause cause)
+{
+	switch (cause)
+	{
+	case ZONE_MANUAL: return "manual";
+	case ZONE_SCHEDULE: return "schedule";
+	case ZONE_TIMER: return "timer";
+	case ZONE_REBOOT: return "reboot";
+	}
+	return "";
+}
+
+void zone_switch(uint32_t on, uint32_t off, zone_cause cause)
+{
+	uint32_t set_pins = 0;
+	uint32_t clear_pins = 0;
+	uint32_t changed = 0;
+	time_t now = 0;
+
+	time(&now);
+	xSemaphoreTake(lock, portMAX_DELAY);
+	for (unsigned int zone = 0; zone < ZONE_COUNT; zone++)
+	{
+		zone_status *s = &status[zone];
+
+		if (on & ZONE_BIT(zone))
+		{
+			set_pins |= 1 << zones[zone].pin;
+			if (!s->on)
+			{
+				s->on = true;
+				s->last_watering = now;
+				s->cause = cause;
+				if (cause != ZONE_SCHEDULE)
+					s->event = -1;
+				changed |= ZONE_BIT(zone);
+				ESP_LOGI(TAG, "%s on", zones[zone].name);
+			}
+		}
+		else if ((off & ZONE_BIT(zone)) && s->on)
+		{
+			clear_pins |= 1 << zones[zone].pin;
+			s->on = false;
+			s->last_duration = now - s->last_watering;
+			s->waterings++;
+			s->total_seconds += s->last_duration;
+			s->cause = cause;
+			changed |= ZONE_BIT(zone);
+			esp_timer_stop(off_timer[zone]);
+			ESP_LOGI(TAG, "%s off after %i seconds", zones[zone].name, s->last_duration);
+		}
+	}
+
+	// one write for each direction switches all the valves
+	if (set_pins)
+		GPIO.out_w1ts |= set_pins;
+	if (clear_pins)
+		GPIO.out_w1tc |= clear_pins;
+	xSemaphoreGive(lock);
+
+	if (changed && changed_cb)
+		changed_cb(changed);
+}
+
+void zone_arm(unsigned int zone, uint32_t seconds, int slot)
+{
+	if (zone >= ZONE_COUNT)
+		return;
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	status[zone].event = slot;
+	xSemaphoreGive(lock);
+
+	esp_timer_stop(off_timer[zone]);
+	esp_timer_start_once(off_timer[zone], (uint64_t)seconds * 1000000);
+}
+
+void zone_get_status(unsigned int zone, zone_status *out)
+{
+	if (zone >= ZONE_COUNT)
+	{
+		memset(out, 0, sizeof(*out));
+		return;
+	}
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+	*out = status[zone];
+	xSemaphoreGive(lock);
+}
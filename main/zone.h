@@ -0,0 +1,52 @@
+#ifndef _ZONE_H
+#define _ZONE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#define ZONE_MAX 8					// size of the zone table
+#define ZONE_BIT(zone) (1U << (zone))
+#define ZONE_ALL ((1U << ZONE_MAX) - 1)
+
+// why a zone was switched
+typedef enum zone_cause
+{
+	ZONE_MANUAL,				// from the web page or the API
+	ZONE_SCHEDULE,				// a scheduled event started
+	ZONE_TIMER,					// the time it was armed for ran out
+	ZONE_REBOOT,				// closed for a reboot, or found open after a reset
+} zone_cause;
+
+typedef struct zone_status
+{
+	bool on;
+	time_t last_watering;	// when the zone was last turned on
+	int last_duration;		// how long it was on for (seconds)
+	uint32_t waterings;		// times turned off again since boot
+	uint32_t total_seconds;	// time on since boot, not counting now
+	zone_cause cause;			// of the last switch
+	int event;					// slot of the event that turned it on, -1 if none
+} zone_status;
+
+// 'changed' is called with the zones that were turned on or off
+void zone_init(void (*changed)(uint32_t zones));
+
+// zones that have a valve connected
+unsigned int zone_count(void);
+const char *zone_name(unsigned int zone);
+const char *zone_cause_name(zone_cause cause);
+
+/*
+	Turn zones on and off. The valves of all the zones in a mask change
+	together with a single write to the GPIO output register, so a batch
+	of events that start at the same time switches at once.
+*/
+void zone_switch(uint32_t on, uint32_t off, zone_cause cause);
+
+// turn the zone off 'seconds' from now, for the event in 'slot' (-1 if none)
+void zone_arm(unsigned int zone, uint32_t seconds, int slot);
+
+void zone_get_status(unsigned int zone, zone_status *status);
+
+#endif // _ZONE_H
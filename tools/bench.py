@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+#
+# Cycle counts of the hot handlers of a controller or of the host build:
+#
+#   tools/bench.py http://192.168.20.30
+#   tools/bench.py http://localhost:8080       (./build-host/water_sim)
+#
+# Resets /debug/bench, loads the index page --requests times, half of them
+# with an encoded query for an action that doesn't exist (so nothing is
+# changed), and prints what /debug/bench counted. /debug/bench runs
+# url_decode() itself, and the work scheduler() does on the schedule on a
+# copy of it (schedule_wakeup), a hundred times each, so their counts
+# don't depend on when the schedule timer last ran. The host counts
+# are host time in cycles of the device's clock, so they compare builds
+# rather than devices. host/bench/ has benchmarks of the same code without
+# the rest of the firmware.
+import argparse
+import json
+import sys
+import time
+import urllib.request
+
+QUERY = '/?action=bench&name=Back+Garden&start=14%3A30&url=http%3A%2F%2F192.168.20.30%2Fwater.bin'
+
+
+def get(url):
+	with urllib.request.urlopen(url, timeout=10) as r:
+		return r.read()
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Cycle counts of the hot handlers')
+	parser.add_argument('url', help='of the controller')
+	parser.add_argument('--requests', type=int, default=50)
+	args = parser.parse_args()
+	base = args.url.rstrip('/')
+
+	get(base + '/debug/bench?reset')
+	start = time.monotonic()
+	for i in range(args.requests):
+		get(base + (QUERY if i % 2 else '/'))
+	elapsed = time.monotonic() - start
+	bench = json.loads(get(base + '/debug/bench'))
+
+	print('%s, %s profile, hot functions in %s, %u MHz' % (base, bench['profile'],
+		'IRAM' if bench['hot_iram'] else 'flash', bench['cpu_mhz']))
+	print('%u requests in %.2f s' % (args.requests, elapsed))
+	print('%-16s %8s %10s %10s %10s %8s' % ('function', 'calls', 'min', 'mean', 'max', 'mean us'))
+	for f in bench['functions']:
+		print('%-16s %8u %10u %10u %10u %8.1f' % (f['name'], f['calls'], f['min'], f['mean'], f['max'],
+			f['mean'] / bench['cpu_mhz']))
+
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+#
+# Draws the start up timeline from /debug/boot:
+#
+#   tools/boot_timeline.py http://water.local/debug/boot
+#   tools/boot_timeline.py saved.json --baseline last_release.json --fail-over 20
+#
+# With --baseline each span is compared to the span of the same name in
+# an older dump, and --fail-over makes the exit status 1 when a span got
+# more than that many percent (and at least 1 ms) slower, so a script can
+# catch a regression.
+import argparse
+import json
+import sys
+import urllib.request
+
+WIDTH = 50
+
+
+def load(source):
+	if source == '-':
+		return json.load(sys.stdin)
+	if source.startswith('http://') or source.startswith('https://'):
+		with urllib.request.urlopen(source, timeout=10) as r:
+			return json.load(r)
+	with open(source) as f:
+		return json.load(f)
+
+
+def length(span, now):
+	end = span['end'] if span['end'] is not None else now
+	return end - span['start']
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Draw the boot timeline of a watering controller')
+	parser.add_argument('source', help='URL of /debug/boot, a saved dump or - for stdin')
+	parser.add_argument('--baseline', help='an older dump to compare with')
+	parser.add_argument('--fail-over', type=float, metavar='PCT', help='fail if a span is this much slower than the baseline')
+	args = parser.parse_args()
+
+	dump = load(args.source)
+	now = dump['now']
+	spans = dump['spans']
+	if not spans:
+		print('no spans')
+		return 0
+
+	base = {}
+	if args.baseline:
+		old = load(args.baseline)
+		for span in old['spans']:
+			base.setdefault(span['name'], length(span, old['now']))
+
+	last = max(span['end'] if span['end'] is not None else now for span in spans)
+	scale = WIDTH / max(last, 1)
+	slower = []
+
+	print('%9s %9s  %-22s %s' % ('start ms', 'ms', 'span', 'baseline' if base else ''))
+	for span in spans:
+		ms = length(span, now) / 1000
+		start = int(span['start'] * scale)
+		size = max(1, int(length(span, now) * scale)) if span['end'] != span['start'] else 0
+		bar = ' ' * start + ('#' * size if size else '|')
+		name = '  ' * span['depth'] + span['name']
+
+		compare = ''
+		if span['name'] in base:
+			was = base[span['name']] / 1000
+			change = (ms - was) * 100 / was if was else 0
+			compare = '%+7.1f%%' % change if was else ''
+			if args.fail_over is not None and ms - was >= 1 and change > args.fail_over:
+				slower.append('%s: %.1f ms -> %.1f ms' % (span['name'], was, ms))
+
+		open_mark = '+' if span['end'] is None else ' '
+		print('%9.1f %9.1f%s %-22s %-8s %s' % (span['start'] / 1000, ms, open_mark, name, compare, bar))
+
+	print('%d spans, %.1f ms since boot' % (len(spans), now / 1000))
+	if slower:
+		print('slower than the baseline:')
+		for line in slower:
+			print('  ' + line)
+		return 1
+	return 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+#
+# Generates main/action_hash.h, a perfect hash of the action names in the
+# actions[] table of main/main.c, so handler_index() finds an action with
+# one hash and one strcmp(). Run it again whenever an action is added,
+# removed or renamed:
+#
+#   tools/gen_action_hash.py main/main.c > main/action_hash.h
+#
+# The hash is FNV-1a with a seed as the offset basis - query_hash() in
+# main/query.c. The bucket is the top bits of the hash, as the low bits of
+# FNV only depend on the low bits of the seed. The smallest power of two
+# table is used that some seed maps every name into a different bucket.
+import re
+import sys
+
+FNV_BASIS = 2166136261
+FNV_PRIME = 16777619
+MAX_SEEDS = 100000
+
+
+def fnv1a(name, seed):
+	h = seed
+	for c in name.encode():
+		h ^= c
+		h = (h * FNV_PRIME) & 0xFFFFFFFF
+	return h
+
+
+def bucket(name, seed, bits):
+	return fnv1a(name, seed) >> (32 - bits)
+
+
+def action_names(source):
+	table = re.search(r'struct action actions\[\w+\]\s*=\s*\{(.*?)\n\};', source, re.S)
+	if not table:
+		sys.exit('no actions[] table found')
+	return re.findall(r'\.name\s*=\s*"([^"]+)"', table.group(1))
+
+
+def find_seed(names):
+	bits = max(1, (len(names) - 1).bit_length())
+	while bits <= 8:
+		for seed in range(FNV_BASIS, FNV_BASIS + MAX_SEEDS):
+			buckets = set(bucket(name, seed, bits) for name in names)
+			if len(buckets) == len(names):
+				return bits, seed
+		bits += 1
+	sys.exit('no perfect hash found')
+
+
+def main():
+	if len(sys.argv) != 2:
+		sys.exit('usage: gen_action_hash.py main.c')
+	with open(sys.argv[1]) as f:
+		names = action_names(f.read())
+	if len(names) > 255:
+		sys.exit('too many actions')
+
+	bits, seed = find_seed(names)
+	table = [0xFF] * (1 << bits)
+	for idx, name in enumerate(names):
+		table[bucket(name, seed, bits)] = idx
+
+	print('// Generated by tools/gen_action_hash.py from the actions[] table in main.c - do not edit')
+	print('#ifndef _ACTION_HASH_H')
+	print('#define _ACTION_HASH_H')
+	print()
+	print('#include <stdint.h>')
+	print()
+	print('#define ACTION_HASH_SEED 0x%08Xu' % seed)
+	print('#define ACTION_HASH_BITS %u' % bits)
+	print('#define ACTION_HASH_COUNT %u\t\t// entries in actions[]' % len(names))
+	print('#define ACTION_HASH_EMPTY 0xFF')
+	print('#define ACTION_HASH_BUCKET(hash) ((hash) >> (32 - ACTION_HASH_BITS))')
+	print()
+	print('// index in actions[] for each bucket')
+	print('static const uint8_t action_hash[1 << ACTION_HASH_BITS] =')
+	print('{')
+	for idx in table:
+		if idx == 0xFF:
+			print('\tACTION_HASH_EMPTY,')
+		else:
+			print('\t%u,\t\t// %s' % (idx, names[idx]))
+	print('};')
+	print()
+	print('#endif // _ACTION_HASH_H')
+
+
+if __name__ == '__main__':
+	main()
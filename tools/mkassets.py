@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+#
+# Turns the files in main/www/ into main/asset_data.c and main/asset_data.h,
+# which the asset layer (main/asset.c) serves. Run it again after changing
+# any of the files:
+#
+#   tools/mkassets.py main/www main/asset_data
+#
+# Each file becomes a 'const asset asset_<name>_<ext>'. A file is stored
+# gzipped, and only gzipped, when that saves at least a tenth of its size -
+# clients that don't take gzip get a 406 for it. The ETag is a hash of the
+# file, so it only changes when the file does.
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+TYPES = {
+	'.css': 'text/css',
+	'.html': 'text/html',
+	'.ico': 'image/x-icon',
+	'.js': 'application/javascript',
+	'.json': 'application/json',
+	'.png': 'image/png',
+	'.svg': 'image/svg+xml',
+}
+
+# pages are checked every time, so a new firmware shows up at once
+CACHE_PAGE = 'no-cache'
+CACHE_OTHER = 'public, max-age=604800'
+
+
+def c_name(filename):
+	return re.sub(r'[^A-Za-z0-9]', '_', filename).lower()
+
+
+def c_bytes(data):
+	lines = []
+	for i in range(0, len(data), 16):
+		lines.append('\t' + ' '.join('0x%02x,' % b for b in data[i:i + 16]))
+	return '\n'.join(lines)
+
+
+def main():
+	if len(sys.argv) != 3:
+		sys.exit('usage: mkassets.py <dir> <output base name>')
+	src, out = sys.argv[1], sys.argv[2]
+	base = os.path.basename(out)
+
+	files = sorted(f for f in os.listdir(src) if os.path.isfile(os.path.join(src, f)))
+	c = ['// Generated by tools/mkassets.py from main/www - do not edit',
+		'#include "asset.h"',
+		'#include "%s.h"' % base]
+	h = ['// Generated by tools/mkassets.py from main/www - do not edit',
+		'#ifndef _%s_H' % base.upper(),
+		'#define _%s_H' % base.upper(),
+		'',
+		'#include "asset.h"',
+		'']
+
+	for f in files:
+		ext = os.path.splitext(f)[1].lower()
+		if ext not in TYPES:
+			sys.exit('%s: unknown type' % f)
+		with open(os.path.join(src, f), 'rb') as fd:
+			raw = fd.read()
+
+		packed = gzip.compress(raw, 9, mtime=0)
+		gz = len(packed) <= len(raw) * 9 // 10
+		data = packed if gz else raw
+		name = c_name(f)
+		etag = hashlib.sha1(raw).hexdigest()[:16]
+
+		c.append('')
+		c.append('// %s: %u bytes%s' % (f, len(raw), ', %u gzipped' % len(packed) if gz else ''))
+		c.append('static const uint8_t %s_data[] =' % name)
+		c.append('{')
+		c.append(c_bytes(data))
+		c.append('};')
+		c.append('')
+		c.append('const asset asset_%s =' % name)
+		c.append('{')
+		c.append('\t.type = "%s",' % TYPES[ext])
+		c.append('\t.etag = "\\"%s%s\\"",' % (etag, '-gz' if gz else ''))
+		c.append('\t.cache = "%s",' % (CACHE_PAGE if ext == '.html' else CACHE_OTHER))
+		c.append('\t.gzip = %s,' % ('true' if gz else 'false'))
+		c.append('\t.data = %s_data,' % name)
+		c.append('\t.size = sizeof(%s_data),' % name)
+		c.append('};')
+		h.append('extern const asset asset_%s;' % name)
+
+	h.append('')
+	h.append('#endif // _%s_H' % base.upper())
+
+	with open(out + '.c', 'w') as fd:
+		fd.write('\n'.join(c) + '\n')
+	with open(out + '.h', 'w') as fd:
+		fd.write('\n'.join(h) + '\n')
+
+
+if __name__ == '__main__':
+	main()
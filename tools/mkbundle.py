@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+#
+# Packs the web UI in ui/ into an image for the start of the storage
+# partition, which main/bundle.c serves:
+#
+#   tools/mkbundle.py ui build/ui_bundle.bin
+#   make ui-flash
+#
+# For the simulator, write it over the start of the partition file:
+#
+#   dd if=build/ui_bundle.bin of=$WATER_SIM_DIR/flash_storage.bin conv=notrunc
+#
+# The image is a header, a table of files and then the files, each at a
+# multiple of 4 bytes. All values are little endian:
+#   header: "WUI2", count (2), reserved (2), CRC-32 of the rest (4), size (4)
+#   file:   path (40), Content-Type (24), ETag (16), offset (4), size (4),
+#           flags (1: 1 = gzipped, 2 = page), reserved (7)
+# A file is served as /ui/<name>. Files are gzipped on the same terms as
+# tools/mkassets.py, and the ETag is a hash of the file.
+import gzip
+import hashlib
+import os
+import struct
+import sys
+import zlib
+
+from mkassets import TYPES
+
+MAGIC = b'WUI2'
+HEADER = '<4sHHII'
+ENTRY = '<40s24s16sIIB7x'
+MAX_FILES = 8				# BUNDLE_MAX_FILES in main/bundle.h
+MAX_SIZE = 0x1F0000		# the storage partition less the history log (main/history.h)
+PREFIX = '/ui/'
+FLAG_GZIP = 1
+FLAG_PAGE = 2
+
+
+def main():
+	if len(sys.argv) != 3:
+		sys.exit('usage: mkbundle.py <dir> <image>')
+	src, out = sys.argv[1], sys.argv[2]
+
+	files = sorted(f for f in os.listdir(src) if os.path.isfile(os.path.join(src, f)))
+	if len(files) > MAX_FILES:
+		sys.exit('%u files, the firmware takes %u' % (len(files), MAX_FILES))
+
+	table = b''
+	data = b''
+	offset = struct.calcsize(HEADER) + len(files) * struct.calcsize(ENTRY)
+	for f in files:
+		ext = os.path.splitext(f)[1].lower()
+		if ext not in TYPES:
+			sys.exit('%s: unknown type' % f)
+		with open(os.path.join(src, f), 'rb') as fd:
+			raw = fd.read()
+
+		packed = gzip.compress(raw, 9, mtime=0)
+		gz = len(packed) <= len(raw) * 9 // 10
+		body = packed if gz else raw
+		flags = (FLAG_GZIP if gz else 0) | (FLAG_PAGE if ext == '.html' else 0)
+		path = (PREFIX + f).encode()
+		if len(path) >= 40:
+			sys.exit('%s: name too long' % f)
+
+		table += struct.pack(ENTRY, path, TYPES[ext].encode(), hashlib.sha1(raw).hexdigest()[:16].encode(),
+			offset + len(data), len(body), flags)
+		data += body + b'\0' * (-len(body) % 4)
+		print('%-12s %6u bytes%s' % (f, len(raw), ', %u gzipped' % len(packed) if gz else ''))
+
+	size = offset + len(data)
+	if size > MAX_SIZE:
+		sys.exit('bundle is %u bytes, the partition takes %u' % (size, MAX_SIZE))
+
+	with open(out, 'wb') as fd:
+		fd.write(struct.pack(HEADER, MAGIC, len(files), 0, zlib.crc32(table + data), size))
+		fd.write(table)
+		fd.write(data)
+	print('%s: %u bytes' % (out, size))
+
+
+if __name__ == '__main__':
+	main()
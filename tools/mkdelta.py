@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+#
+# Makes a firmware update that is smaller than the image: compressed, or
+# (with --base) the difference from the image the devices are running.
+# The device recognises it by its header and rebuilds the image while it
+# downloads - see main/patch.h for the format.
+#
+#   tools/mkdelta.py build/water.bin water.wpt
+#   tools/mkdelta.py --base water-1.12.bin build/water.bin water-1.12-1.13.wpt
+#
+# The SHA-256 of the image goes in <patch>.sha256, which the device checks
+# the image against before it boots it.
+#
+# The base is the whole running app partition as read back from a device,
+# or the .bin it was flashed with - a delta is refused by a device whose
+# image differs. Every patch is decoded again here before it is written,
+# and build-host/ota_patch does the same with the firmware's code:
+#
+#   ./build-host/ota_patch water-1.12.bin water-1.12-1.13.wpt out.bin && cmp out.bin build/water.bin
+import argparse
+import hashlib
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b'WPT1'
+FULL = 0
+DELTA = 1
+
+OP_LITERAL = 0
+OP_REPEAT = 1
+OP_BASE = 2
+LONG_LENGTH = 63
+
+WINDOW = 4096			# PATCH_WINDOW in main/patch.h
+MIN_MATCH = 4			# a shorter copy costs as much as the literal
+KEY = 4				# bytes hashed to find a match
+CANDIDATES = 16		# places tried for each key
+MAX_MATCH = 1 << 20
+
+
+def varint(n):
+	out = bytearray()
+	while True:
+		b = n & 0x7F
+		n >>= 7
+		if n:
+			out.append(b | 0x80)
+		else:
+			out.append(b)
+			return bytes(out)
+
+
+def zigzag(n):
+	return (n << 1) if n >= 0 else ((-n << 1) - 1)
+
+
+def command(op, length, arg=None):
+	if length < LONG_LENGTH:
+		out = bytes([op << 6 | length])
+	else:
+		out = bytes([op << 6 | LONG_LENGTH]) + varint(length - LONG_LENGTH)
+	if arg is not None:
+		out += varint(arg)
+	return out
+
+
+def match_length(a, ai, b, bi, limit):
+	# whole blocks first, slices compare much faster than bytes
+	n = 0
+	step = 64
+	while n + step <= limit and a[ai + n:ai + n + step] == b[bi + n:bi + n + step]:
+		n += step
+	while n < limit and a[ai + n] == b[bi + n]:
+		n += 1
+	return n
+
+
+def index(data):
+	table = {}
+	for i in range(len(data) - KEY + 1):
+		table.setdefault(data[i:i + KEY], []).append(i)
+	return table
+
+
+def encode(new, base):
+	out = bytearray()
+	literal = bytearray()
+	base_index = index(base) if base else {}
+	recent = {}
+	base_pos = 0		# end of the last base copy, what the next is counted from
+	drift = 0			# base offset minus image offset of the last base copy
+	i = 0
+
+	def flush_literal():
+		if literal:
+			out.extend(command(OP_LITERAL, len(literal)))
+			out.extend(literal)
+			literal.clear()
+
+	while i < len(new):
+		limit = min(len(new) - i, MAX_MATCH)
+		best_len, best_op, best_from = 0, None, 0
+		key = new[i:i + KEY]
+
+		# code that didn't change is where the last copy left off
+		if base and 0 <= i + drift < len(base):
+			n = match_length(new, i, base, i + drift, min(limit, len(base) - i - drift))
+			if n >= MIN_MATCH:
+				best_len, best_op, best_from = n, OP_BASE, i + drift
+
+		if len(key) == KEY:
+			for j in reversed(base_index.get(key, [])[-CANDIDATES:]):
+				n = match_length(new, i, base, j, min(limit, len(base) - j))
+				if n > best_len + 2:
+					best_len, best_op, best_from = n, OP_BASE, j
+			for j in reversed(recent.get(key, [])[-CANDIDATES:]):
+				if i - j > WINDOW:
+					break
+				n = match_length(new, i, new, j, limit)
+				if n > best_len:
+					best_len, best_op, best_from = n, OP_REPEAT, j
+
+		if best_len < MIN_MATCH:
+			literal.append(new[i])
+			step = 1
+		else:
+			flush_literal()
+			if best_op == OP_BASE:
+				out.extend(command(OP_BASE, best_len, zigzag(best_from - base_pos)))
+				base_pos = best_from + best_len
+				drift = best_from - i
+			else:
+				out.extend(command(OP_REPEAT, best_len, i - best_from))
+			step = best_len
+
+		for k in range(i, min(i + step, len(new) - KEY + 1)):
+			recent.setdefault(new[k:k + KEY], []).append(k)
+		i += step
+
+	flush_literal()
+	return bytes(out)
+
+
+def read_varint(data, pos):
+	n, shift = 0, 0
+	while True:
+		b = data[pos]
+		pos += 1
+		n |= (b & 0x7F) << shift
+		shift += 7
+		if not b & 0x80:
+			return n, pos
+
+
+def decode(patch, base):
+	magic, kind, size, crc, base_size, base_crc = struct.unpack_from('<4sB3xIIII', patch)
+	assert magic == MAGIC
+	out = bytearray()
+	base_pos = 0
+	pos = 24
+	while pos < len(patch):
+		op, length = patch[pos] >> 6, patch[pos] & LONG_LENGTH
+		pos += 1
+		if length == LONG_LENGTH:
+			extra, pos = read_varint(patch, pos)
+			length += extra
+		if op == OP_LITERAL:
+			out += patch[pos:pos + length]
+			pos += length
+			continue
+		arg, pos = read_varint(patch, pos)
+		if op == OP_REPEAT:
+			for _ in range(length):
+				out.append(out[-arg])
+		else:
+			base_pos += (arg >> 1) ^ -(arg & 1)
+			out += base[base_pos:base_pos + length]
+			base_pos += length
+	assert len(out) == size and zlib.crc32(out) == crc
+	return bytes(out)
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Make a compressed or delta firmware update')
+	parser.add_argument('--base', help='image the devices are running')
+	parser.add_argument('image', help='new firmware image')
+	parser.add_argument('patch', help='output')
+	args = parser.parse_args()
+
+	with open(args.image, 'rb') as f:
+		new = f.read()
+	base = b''
+	if args.base:
+		with open(args.base, 'rb') as f:
+			base = f.read()
+
+	header = struct.pack('<4sB3xIIII', MAGIC, DELTA if base else FULL,
+		len(new), zlib.crc32(new), len(base), zlib.crc32(base) if base else 0)
+	patch = header + encode(new, base)
+	if decode(patch, base) != new:
+		sys.exit('patch does not rebuild the image')
+
+	with open(args.patch, 'wb') as f:
+		f.write(patch)
+	with open(args.patch + '.sha256', 'w') as f:
+		f.write('%s  %s\n' % (hashlib.sha256(new).hexdigest(), os.path.basename(args.image)))
+	print('%s: %u bytes, %.1f%% of %u' % (args.patch, len(patch), 100.0 * len(patch) / max(len(new), 1), len(new)))
+
+
+if __name__ == '__main__':
+	main()
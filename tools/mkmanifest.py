@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+#
+# Writes the version manifest that controllers check for new firmware -
+# see main/update.h. It goes next to the image, named like the upgrade
+# URL with .json in place of the extension:
+#
+#   tools/mkmanifest.py 1.13 water-1.13.bin build/water.json
+#   tools/mkmanifest.py --delta 1.12=water-1.12-1.13.wpt 1.13 water-1.13.bin build/water.json
+#
+# 'image' and the deltas are given as the controllers should fetch them,
+# relative to the manifest unless they are whole URLs. The SHA-256 of the
+# image is read from the file at that path next to the manifest.
+import argparse
+import hashlib
+import json
+import os
+import re
+import sys
+
+MAX_SIZE = 511			# UPDATE_MANIFEST_SIZE in main/update.h, less the terminator
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Make a firmware version manifest')
+	parser.add_argument('--delta', action='append', default=[], metavar='VERSION=PATCH',
+		help='patch for controllers running VERSION, made with tools/mkdelta.py')
+	parser.add_argument('version', help='major.minor of the image')
+	parser.add_argument('image', help='image, relative to the manifest')
+	parser.add_argument('manifest', help='output')
+	args = parser.parse_args()
+
+	if not re.fullmatch(r'\d+\.\d+', args.version):
+		sys.exit('version is major.minor')
+
+	manifest = {'version': args.version, 'url': args.image}
+	if '://' not in args.image:
+		path = os.path.join(os.path.dirname(args.manifest), args.image.lstrip('/'))
+		with open(path, 'rb') as f:
+			manifest['sha256'] = hashlib.sha256(f.read()).hexdigest()
+	for delta in args.delta:
+		version, _, patch = delta.partition('=')
+		if not re.fullmatch(r'\d+\.\d+', version) or not patch:
+			sys.exit('--delta is VERSION=PATCH')
+		manifest['delta_' + version] = patch
+
+	text = json.dumps(manifest, indent='\t') + '\n'
+	if len(text) > MAX_SIZE:
+		sys.exit('manifest is %u bytes, controllers read %u' % (len(text), MAX_SIZE))
+	with open(args.manifest, 'w') as f:
+		f.write(text)
+	print('%s: version %s, %u bytes' % (args.manifest, args.version, len(text)))
+
+
+if __name__ == '__main__':
+	main()
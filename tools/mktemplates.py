@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+#
+# Turns the HTML templates in main/templates/ into main/template_data.c and
+# main/template_data.h, the pages main/template.c sends. Run it again after
+# changing any of them:
+#
+#   tools/mktemplates.py main/templates main/template_data
+#
+# A template is the page as it is sent, with {{name:type}} where a value
+# goes - the types are in main/template.h. <name>.html becomes
+#
+#   typedef struct page_<name>_args { ...one field per slot name... };
+#   void page_<name>(resp_writer *w, const page_<name>_args *args);
+#
+# so a missing or mistyped value is a compile error. One newline at the
+# end of a file is dropped. page_<name>_template.hash is a hash of the
+# file, for the ETag of the page.
+import hashlib
+import os
+import re
+import sys
+
+SLOT = re.compile(r'\{\{([a-z_][a-z0-9_]*):([a-z]+)\}\}')
+
+TYPES = {
+	'html': ('SLOT_HTML', 'const char *'),
+	'attr': ('SLOT_ATTR', 'const char *'),
+	'uint': ('SLOT_UINT', 'unsigned int '),
+	'call': ('SLOT_CALL', 'template_fn '),
+}
+
+
+def c_name(filename):
+	return re.sub(r'[^A-Za-z0-9]', '_', os.path.splitext(filename)[0]).lower()
+
+
+def c_string(text):
+	out = []
+	for ch in text:
+		if ch == '\\' or ch == '"':
+			out.append('\\' + ch)
+		elif ch == '\n':
+			out.append('\\n')
+		elif ch == '\t':
+			out.append('\\t')
+		elif ' ' <= ch <= '~':
+			out.append(ch)
+		else:
+			out.extend('\\%03o' % b for b in ch.encode())
+	return '"%s"' % ''.join(out)
+
+
+def c_lines(text, indent):
+	# a string literal per line of the page, so the table reads like it
+	lines = re.findall(r'[^\n]*\n|[^\n]+', text) or ['']
+	return ('\n' + indent).join(c_string(line) for line in lines)
+
+
+def parse(path, text):
+	segments = []
+	fields = {}
+	pos = 0
+	for m in SLOT.finditer(text):
+		name, kind = m.group(1), m.group(2)
+		if kind not in TYPES:
+			sys.exit('%s: {{%s:%s}} has an unknown type' % (path, name, kind))
+		if fields.setdefault(name, kind) != kind:
+			sys.exit('%s: %s is both %s and %s' % (path, name, fields[name], kind))
+		segments.append((text[pos:m.start()], kind, name))
+		pos = m.end()
+	segments.append((text[pos:], None, None))
+	if '{{' in ''.join(s[0] for s in segments):
+		sys.exit('%s: a {{ that is not a slot' % path)
+	return segments, fields
+
+
+def main():
+	if len(sys.argv) != 3:
+		sys.exit('usage: mktemplates.py <dir> <output base name>')
+	src, out = sys.argv[1], sys.argv[2]
+	base = os.path.basename(out)
+
+	files = sorted(f for f in os.listdir(src) if f.endswith('.html'))
+	c = ['// Generated by tools/mktemplates.py from main/templates - do not edit',
+		'#include <stddef.h>',
+		'#include "%s.h"' % base]
+	h = ['// Generated by tools/mktemplates.py from main/templates - do not edit',
+		'#ifndef _%s_H' % base.upper(),
+		'#define _%s_H' % base.upper(),
+		'',
+		'#include "template.h"']
+
+	for f in files:
+		path = os.path.join(src, f)
+		with open(path, 'rb') as fd:
+			raw = fd.read()
+		text = raw.decode('utf-8')
+		if text.endswith('\n'):
+			text = text[:-1]
+		segments, fields = parse(path, text)
+		name = 'page_' + c_name(f)
+		size = sum(len(s[0].encode()) for s in segments)
+
+		h.append('')
+		h.append('typedef struct %s_args' % name)
+		h.append('{')
+		for field, kind in fields.items():
+			h.append('\t%s%s;' % (TYPES[kind][1], field))
+		if not fields:
+			h.append('\tchar unused;')
+		h.append('} %s_args;' % name)
+		h.append('')
+		h.append('extern const template_page %s_template;' % name)
+		h.append('')
+		h.append('static inline void %s(resp_writer *w, const %s_args *args)' % (name, name))
+		h.append('{')
+		h.append('\ttemplate_write(w, &%s_template, args);' % name)
+		h.append('}')
+
+		c.append('')
+		c.append('// %s: %u bytes of text, %u slots' % (f, size, len(segments) - 1))
+		c.append('static const template_segment %s_segments[] =' % name)
+		c.append('{')
+		for text, kind, field in segments:
+			c.append('\t{')
+			c.append('\t\t' + c_lines(text, '\t\t') + ',')
+			c.append('\t\t%u, %s, %s' % (len(text.encode()), TYPES[kind][0] if kind else 'SLOT_NONE',
+				'offsetof(%s_args, %s)' % (name, field) if field else '0'))
+			c.append('\t},')
+		c.append('};')
+		c.append('_Static_assert(sizeof(%s_args) <= UINT8_MAX, "slot offsets are 8 bits");' % name)
+		c.append('')
+		c.append('const template_page %s_template =' % name)
+		c.append('{')
+		c.append('\t.segments = %s_segments,' % name)
+		c.append('\t.count = sizeof(%s_segments) / sizeof(%s_segments[0]),' % (name, name))
+		c.append('\t.hash = "%s",' % hashlib.sha1(raw).hexdigest()[:16])
+		c.append('};')
+
+	h.append('')
+	h.append('#endif // _%s_H' % base.upper())
+
+	with open(out + '.c', 'w') as fd:
+		fd.write('\n'.join(c) + '\n')
+	with open(out + '.h', 'w') as fd:
+		fd.write('\n'.join(h) + '\n')
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+#
+# Serves firmware updates from a directory, and can make the link as bad
+# as a garden's on purpose, to test that the controller resumes downloads
+# and checks what it got. Range requests (one range, with If-Range) and
+# If-None-Match are answered like a real server does.
+#
+#   tools/ota_server.py --drop 65536 build
+#
+# then set the upgrade URL to http://<this host>:8000/water.bin. Each
+# response is cut off after --drop bytes of its body, and --rate slows
+# it down to leave time to reboot the device halfway. The device only
+# installs an image that matches water.bin.sha256:
+#
+#   sha256sum build/water.bin > build/water.bin.sha256
+#
+# tools/mkdelta.py writes one next to each patch. Controllers also check
+# water.json for a newer version on their own (tools/mkmanifest.py), and
+# "?action=check_update" makes one check at once.
+import argparse
+import email.utils
+import os
+import re
+import socket
+import sys
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+CHUNK = 4096
+
+
+class Handler(BaseHTTPRequestHandler):
+	protocol_version = 'HTTP/1.1'
+
+	def do_HEAD(self):
+		self.serve(False)
+
+	def do_GET(self):
+		self.serve(True)
+
+	def serve(self, body):
+		args = self.server.args
+		path = os.path.normpath(os.path.join(args.directory, self.path.split('?')[0].lstrip('/')))
+		if not path.startswith(os.path.abspath(args.directory)) or not os.path.isfile(path):
+			self.send_error(404)
+			return
+
+		st = os.stat(path)
+		size = st.st_size
+		etag = '"%x-%x"' % (st.st_mtime_ns, size)
+		start, end = 0, size
+
+		if etag in [t.strip() for t in self.headers.get('If-None-Match', '').split(',')]:
+			self.send_response(304)
+			self.send_header('ETag', etag)
+			self.end_headers()
+			return
+
+		# a Range for a file that has changed since gets all of it
+		want = self.headers.get('Range')
+		if_range = self.headers.get('If-Range')
+		if want and not args.no_range and (not if_range or if_range == etag):
+			m = re.fullmatch(r'bytes=(\d+)-(\d*)', want.strip())
+			if not m or int(m.group(1)) >= size:
+				self.send_response(416)
+				self.send_header('Content-Range', 'bytes */%u' % size)
+				self.send_header('Content-Length', '0')
+				self.end_headers()
+				return
+			start = int(m.group(1))
+			if m.group(2):
+				end = min(int(m.group(2)) + 1, size)
+
+		self.server.requests += 1
+		if self.server.requests <= args.fail:
+			self.log_message('failing request %u', self.server.requests)
+			self.send_error(503)
+			return
+
+		self.send_response(206 if (start, end) != (0, size) else 200)
+		self.send_header('Content-Type', 'application/octet-stream')
+		self.send_header('Content-Length', str(end - start))
+		self.send_header('ETag', etag)
+		self.send_header('Last-Modified', email.utils.formatdate(st.st_mtime, usegmt=True))
+		self.send_header('Accept-Ranges', 'none' if args.no_range else 'bytes')
+		if (start, end) != (0, size):
+			self.send_header('Content-Range', 'bytes %u-%u/%u' % (start, end - 1, size))
+		self.end_headers()
+		if not body:
+			return
+
+		sent = 0
+		with open(path, 'rb') as f:
+			f.seek(start)
+			while start + sent < end:
+				n = min(CHUNK, end - start - sent)
+				if args.drop and sent + n > args.drop:
+					n = args.drop - sent
+				data = f.read(n)
+				self.wfile.write(data)
+				sent += len(data)
+				if args.rate:
+					self.wfile.flush()
+					time.sleep(len(data) / args.rate)
+				if args.drop and sent >= args.drop and start + sent < end:
+					self.log_message('dropping the connection at byte %u', start + sent)
+					self.wfile.flush()
+					self.connection.shutdown(socket.SHUT_RDWR)
+					self.close_connection = True
+					return
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Serve firmware updates over a bad link')
+	parser.add_argument('directory', help='where the images are')
+	parser.add_argument('--port', type=int, default=8000)
+	parser.add_argument('--drop', type=int, default=0, metavar='BYTES',
+		help='close the connection after this much of each response')
+	parser.add_argument('--rate', type=int, default=0, metavar='BYTES',
+		help='send no more than this many bytes a second')
+	parser.add_argument('--fail', type=int, default=0, metavar='N',
+		help='answer the first N requests with 503')
+	parser.add_argument('--no-range', action='store_true',
+		help='ignore Range, like a server that can\'t resume')
+	args = parser.parse_args()
+	args.directory = os.path.abspath(args.directory)
+
+	server = ThreadingHTTPServer(('', args.port), Handler)
+	server.args = args
+	server.requests = 0
+	print('Serving %s on port %u' % (args.directory, args.port), file=sys.stderr)
+	try:
+		server.serve_forever()
+	except KeyboardInterrupt:
+		pass
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+#
+# Sends the same list of actions to many controllers at once, one
+# /api/batch request each:
+#
+#   tools/provision.py site.txt 192.168.20.31 192.168.20.32 ...
+#
+# site.txt has one action per line, as in "/?action=..." URLs - blank
+# lines and lines starting with # are skipped:
+#
+#   action=set_ntp&server=time.example.org
+#   action=set_upgrade&url=http%3A%2F%2Ffw.example.org%2Fwater.bin
+#   action=add_event&zone=0&time=06%3A30&duration=600
+#
+# Each controller checks every line before it runs any and stops at the
+# first action that fails, keeping none of the settings or events the
+# list changed. The exit status is 1 if any controller failed.
+import argparse
+import json
+import sys
+import urllib.error
+import urllib.request
+from concurrent.futures import ThreadPoolExecutor
+
+MAX_BODY = 2047			# BATCH_MAX_BODY in main/main.c, less the terminator
+MAX_ACTIONS = 16		# BATCH_MAX_ACTIONS
+
+
+def provision(host, body, lines):
+	url = host if '://' in host else 'http://' + host
+	try:
+		req = urllib.request.Request(url.rstrip('/') + '/api/batch', data=body, method='POST')
+		with urllib.request.urlopen(req, timeout=30) as r:
+			result = json.loads(r.read())
+	except urllib.error.HTTPError as e:
+		return False, '%s: %s' % (host, json.loads(e.read()).get('error', e.reason))
+	except (OSError, ValueError) as e:
+		return False, '%s: %s' % (host, e)
+
+	if result['ok']:
+		return True, '%s: %u actions done' % (host, len(lines))
+	for line, err in zip(lines, result['results']):
+		if err is not None and err != 0:
+			return False, '%s: failed (%d) at %s' % (host, err, line)
+	return False, '%s: commit failed (%d)' % (host, result['commit'])
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Send a list of actions to many controllers')
+	parser.add_argument('actions', help='file with one action per line')
+	parser.add_argument('hosts', nargs='+', help='controllers, by address or URL')
+	parser.add_argument('--parallel', type=int, default=16, help='controllers at a time')
+	args = parser.parse_args()
+
+	with open(args.actions) as f:
+		lines = [l.strip() for l in f if l.strip() and not l.startswith('#')]
+	body = '\n'.join(lines).encode()
+	if len(lines) > MAX_ACTIONS or len(body) > MAX_BODY:
+		sys.exit('at most %u actions and %u bytes go in one batch' % (MAX_ACTIONS, MAX_BODY))
+
+	failed = 0
+	with ThreadPoolExecutor(args.parallel) as pool:
+		for ok, message in pool.map(lambda h: provision(h, body, lines), args.hosts):
+			print(message)
+			failed += not ok
+	return 1 if failed else 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
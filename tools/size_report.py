@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+#
+# Size of each component in one or more builds, from the linker map:
+#
+#   tools/size_report.py build-release/water.map build-release-O2/water.map
+#
+# Each component (the library its code was linked from) gets a row with
+# the bytes it puts in IRAM, flash code, read-only data, initialised data
+# and zeroed data (bss), one set of columns per map. The firmware is built
+# in these profiles with "make release" and "make release-O2".
+import argparse
+import collections
+import os
+import re
+import sys
+
+KINDS = ('iram', 'text', 'rodata', 'data', 'bss')
+
+# output section to kind, ESP8266 sections first, then a host build's
+OUTPUT_SECTIONS = [
+	(r'\.iram0\.', 'iram'),
+	(r'\.flash\.text', 'text'),
+	(r'\.flash\.rodata|\.dram0\.rodata|\.rodata', 'rodata'),
+	(r'\.dram0\.data|\.data', 'data'),
+	(r'\.dram0\.bss|\.bss|\.tbss', 'bss'),
+	(r'\.text', 'text'),
+]
+
+OUTPUT_LINE = re.compile(r'^(\.\S+)(\s+0x[0-9a-f]+\s+0x[0-9a-f]+)?')
+INPUT_LINE = re.compile(r'^ (\S+)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$')
+
+
+def kind_of(section):
+	for pattern, kind in OUTPUT_SECTIONS:
+		if re.match(pattern, section):
+			return kind
+	return None
+
+
+def component(path):
+	m = re.match(r'(.*)\((.*)\)$', path)
+	name = os.path.basename(m.group(1) if m else path)
+	name = re.sub(r'^lib(.*)\.a$', r'\1', name)
+	return name
+
+
+def read_map(path):
+	sizes = collections.defaultdict(lambda: dict.fromkeys(KINDS, 0))
+	in_map = False
+	kind = None
+	pending = None
+
+	with open(path, errors='replace') as f:
+		for line in f:
+			line = line.rstrip('\n')
+			if line.startswith('Linker script and memory map'):
+				in_map = True
+				continue
+			if not in_map:
+				continue
+
+			m = OUTPUT_LINE.match(line)
+			if m:
+				kind = kind_of(m.group(1))
+				pending = None
+				continue
+			if line.startswith('/DISCARD/'):
+				kind = None
+				continue
+			if kind is None or line.startswith(' *') or line.lstrip().startswith('*'):
+				continue
+
+			# a long input section name puts its address and size on the next line
+			if re.fullmatch(r' \.\S+', line):
+				pending = line
+				continue
+			if pending and line.startswith('  '):
+				line = pending + line
+			pending = None
+
+			m = INPUT_LINE.match(line)
+			if not m or not m.group(1):
+				continue
+			size = int(m.group(3), 16)
+			if size and int(m.group(2), 16):
+				sizes[component(m.group(4))][kind] += size
+	return sizes
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Size of each component in linker maps')
+	parser.add_argument('--all', action='store_true', help='list components smaller than 1 KB')
+	parser.add_argument('maps', nargs='+', help='.map files, one per build')
+	args = parser.parse_args()
+
+	builds = [read_map(path) for path in args.maps]
+	names = sorted(set().union(*builds), key=lambda n: -sum(builds[0].get(n, {}).values()))
+	if not args.all:
+		names = [n for n in names if max(sum(b.get(n, {}).values()) for b in builds) >= 1024]
+
+	width = max([len(n) for n in names] + [9])
+	print('%-*s' % (width, ''), end='')
+	for path in args.maps:
+		label = os.path.basename(os.path.dirname(os.path.abspath(path))) or path
+		print(' | %-41s' % label[-41:], end='')
+	print()
+	print('%-*s' % (width, 'component'), end='')
+	for _ in builds:
+		print(' | ' + ' '.join('%7s' % k for k in KINDS) + ' ', end='')
+	print()
+
+	def row(name, values):
+		print('%-*s' % (width, name), end='')
+		for v in values:
+			print(' | ' + ' '.join('%7u' % v[k] for k in KINDS) + ' ', end='')
+		print()
+
+	zero = dict.fromkeys(KINDS, 0)
+	for name in names:
+		row(name, [b.get(name, zero) for b in builds])
+	row('total', [{k: sum(s[k] for s in b.values()) for k in KINDS} for b in builds])
+
+
+if __name__ == '__main__':
+	sys.exit(main())
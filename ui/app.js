@@ -0,0 +1,173 @@
+// Everything on the page comes from the JSON API and /events
+var days = ['Sun', 'Mon', 'Tue', 'Wed', 'Thu', 'Fri', 'Sat'];
+var zones = [];
+var historyNext = null;
+
+function $(id) { return document.getElementById(id); }
+
+function text(tag, value, cls) {
+	var e = document.createElement(tag);
+	e.textContent = value;
+	if (cls)
+		e.className = cls;
+	return e;
+}
+
+function row(table, cells) {
+	var tr = table.insertRow(-1);
+	cells.forEach(function(c) {
+		var td = tr.insertCell(-1);
+		if (c instanceof Node)
+			td.appendChild(c);
+		else
+			td.textContent = c;
+	});
+	return tr;
+}
+
+function api(method, url, body) {
+	return fetch(url, {
+		method: method,
+		headers: body ? { 'Content-Type': 'application/json' } : {},
+		body: body ? JSON.stringify(body) : undefined
+	}).then(function(r) {
+		if (r.status == 204)
+			return null;
+		return r.json().then(function(j) {
+			if (!r.ok)
+				throw new Error(j.error || r.statusText);
+			return j;
+		});
+	});
+}
+
+function when(t) { return t ? new Date(t * 1000).toLocaleString() : '-'; }
+function pad(n) { return (n < 10 ? '0' : '') + n; }
+
+function action(name, zone) {
+	return fetch('/?action=' + name + '&zone=' + zone).then(status);
+}
+
+function showZone(z, i) {
+	var tr = $('zones').rows[i] || row($('zones'), ['', '', '', '']);
+	var button = text('button', z.on ? 'Off' : 'On');
+	button.onclick = function() { action(z.on ? 'water_off' : 'water_on', i); };
+	tr.cells[0].textContent = z.name;
+	tr.cells[1].textContent = z.on ? 'On' : 'Off';
+	tr.cells[1].className = z.on ? 'on' : '';
+	tr.cells[2].textContent = z.last_watering && !z.on ?
+		'last ' + when(z.last_watering) + ' for ' + z.last_duration + ' s' : '';
+	tr.cells[3].replaceChildren(button);
+}
+
+function status() {
+	return api('GET', '/api/status').then(function(s) {
+		$('version').textContent = 'v' + s.version;
+		$('time').textContent = when(s.time);
+		$('next').textContent = when(s.next_event);
+		$('net').textContent = s.internet ? 'connected' : 'disconnected';
+		zones = s.zones;
+		zones.forEach(showZone);
+		if ($('zone').options.length != zones.length) {
+			$('zone').replaceChildren();
+			zones.forEach(function(z, i) { $('zone').add(new Option(z.name, i)); });
+		}
+	});
+}
+
+function schedule() {
+	return api('GET', '/api/events').then(function(r) {
+		var table = $('events');
+		while (table.rows.length > 1)
+			table.deleteRow(1);
+		r.events.forEach(function(e) {
+			var on = e.skip ? 'every ' + e.skip + ' s' : days.filter(function(d, i) {
+				return !e.days || e.days & (1 << i);
+			}).join(' ');
+			var del = text('button', 'Delete');
+			del.onclick = function() { api('DELETE', '/api/events?index=' + e.index).then(schedule); };
+			row(table, [zones[e.zone] ? zones[e.zone].name : e.zone,
+				pad(e.hour) + ':' + pad(e.minute) + ' ' + on, e.duration + ' s', when(e.next), del]);
+		});
+	});
+}
+
+function history(more) {
+	var url = '/api/history?limit=20' + (more ? '&before=' + historyNext : '');
+	return api('GET', url).then(function(r) {
+		if (!more)
+			$('history').replaceChildren();
+		r.records.forEach(function(h) {
+			row($('history'), [when(h.time), zones[h.zone] ? zones[h.zone].name : h.zone,
+				h.on ? 'on' : 'off after ' + h.duration + ' s', h.cause +
+				(h.event !== null ? ' ' + h.event : '')]);
+		});
+		historyNext = r.next;
+		$('more').hidden = r.next === null;
+	});
+}
+
+function config() {
+	return api('GET', '/api/config').then(function(c) {
+		var form = $('config');
+		['hostname', 'ntp_server', 'timezone', 'upgrade_url'].forEach(function(k) {
+			form.elements[k].value = c[k];
+		});
+		$('ssid').textContent = c.ssid;
+	});
+}
+
+days.forEach(function(d, i) {
+	var label = text('label', d);
+	var box = document.createElement('input');
+	box.type = 'checkbox';
+	box.name = 'd' + i;
+	label.style.display = 'inline';
+	label.prepend(box);
+	$('days').appendChild(label);
+});
+
+$('add').onsubmit = function(ev) {
+	var f = ev.target.elements;
+	var t = f.time.value.split(':');
+	var mask = 0;
+	ev.preventDefault();
+	for (var i = 0; i < 7; i++)
+		mask |= f['d' + i].checked ? 1 << i : 0;
+	api('POST', '/api/events', {
+		zone: +f.zone.value, hour: +t[0], minute: +t[1], days: mask,
+		skip: +f.skip.value, duration: +f.duration.value
+	}).then(schedule).catch(function(e) { alert(e.message); });
+};
+
+$('config').onsubmit = function(ev) {
+	var f = ev.target.elements;
+	ev.preventDefault();
+	api('POST', '/api/config', {
+		hostname: f.hostname.value, ntp_server: f.ntp_server.value,
+		timezone: f.timezone.value, upgrade_url: f.upgrade_url.value
+	}).then(function() { $('saved').textContent = 'saved'; $('saved').className = ''; })
+		.catch(function(e) { $('saved').textContent = e.message; $('saved').className = 'error'; });
+};
+
+$('more').onclick = function() { history(true); };
+
+status().then(function() { return Promise.all([schedule(), history(false), config()]); });
+
+var es = new EventSource('/events');
+es.addEventListener('zone', function(e) {
+	var d = JSON.parse(e.data);
+	if (zones[d.zone]) {
+		zones[d.zone].on = d.on;
+		zones[d.zone].last_watering = d.last_watering;
+		zones[d.zone].last_duration = d.last_duration;
+		showZone(zones[d.zone], d.zone);
+	}
+	// the change reaches the log on flash a little later
+	setTimeout(function() { history(false); }, 2500);
+});
+es.addEventListener('internet', function(e) {
+	$('net').textContent = JSON.parse(e.data).internet ? 'connected' : 'disconnected';
+});
+es.addEventListener('schedule', function() { schedule(); status(); });
+setInterval(function() { $('time').textContent = new Date().toLocaleString(); }, 1000);